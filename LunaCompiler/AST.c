@@ -10,6 +10,8 @@ AST* init_AST(int type) {
   AST* node = mcalloc(1, sizeof(AST));
   node->type = type;
 
+  stats_add(STATS_AST_NODES, 1);
+
   return node;
 
 }
@@ -41,6 +43,7 @@ char* typeToString(int type) {
     // TOKEN ENUM
 
     case TOKEN_ID: return "Identifier";
+    case TOKEN_KEYWORD: return "Keyword";
     case TOKEN_NUMBER: return "Number";
     case TOKEN_EQUALS: return "=";
     case TOKEN_DEQUAL: return "==";
@@ -61,6 +64,13 @@ char* typeToString(int type) {
     case TOKEN_SUB: return "-";
     case TOKEN_LBRACE: return "{";
     case TOKEN_RBRACE: return "}";
+    case TOKEN_SHL: return "<<";
+    case TOKEN_SHR: return ">>";
+    case TOKEN_BAND: return "&";
+    case TOKEN_BOR: return "|";
+    case TOKEN_XOR: return "^";
+    case TOKEN_LAND: return "&&";
+    case TOKEN_LOR: return "||";
     case TOKEN_FUNC_END: return "End function";
     case TOKEN_NOOP: return "NOOP";
     case TOKEN_EOF: return "End of file";
@@ -76,6 +86,11 @@ char* typeToString(int type) {
     case AST_SUB: return "SUB";
     case AST_MUL: return "MUL";
     case AST_DIV: return "DIV";
+    case AST_SHL: return "SHL";
+    case AST_SHR: return "SAR";
+    case AST_BAND: return "AND";
+    case AST_BOR: return "OR";
+    case AST_XOR: return "XOR";
     case AST_ASSIGNMENT: return "Assignment";
     case AST_VARIABLE_DEC: return "Declaration";
     case AST_VARIABLE: return "Variable";
@@ -100,111 +115,123 @@ char* typeToString(int type) {
 }
 
 /*
-AST_free_AST frees an entire Abstract Syntax Tree
+AST_free_AST frees an entire Abstract Syntax Tree, the nodes that weren't freed yet wait on a stack instead of recursing
+so deep trees can't overflow the C stack
 Input: Root of tree
 Output: None
 */
 void AST_free_AST(AST* node) {
 
-  if (node->type == AST_ADD || node->type == AST_SUB || node->type == AST_MUL || node->type == AST_DIV
-    || node->type == AST_COMPARE || node->type == AST_ASSIGNMENT) {
+  AST** stack = NULL;
+  size_t size = 0;
+  size_t capacity = 0;
 
-    if (node->value) {
-      AST_free_AST(node->value);
-    }
-    else {
-      AST_free_AST(node->leftChild);
-      AST_free_AST(node->rightChild);
-    }
+  if (!node) { return; }
 
-    free(node);
-  }
-  else if (node->type == AST_INT || node->type == AST_VARIABLE || node->type == AST_STRING) {
-    free(node);
-  }
-  else if (node->type == AST_IF || node->type == AST_WHILE) {
-    AST_free_AST(node->if_body);
-    AST_free_AST(node->condition);
+  vector_push(stack, size, capacity, node);
 
-    if (node->else_body) {
-      AST_free_AST(node->else_body);
-    }
-      
-    free(node);
-  }
-  else if (node->type == AST_VARIABLE_DEC || node->type == AST_RETURN) {
-    AST_free_AST(node->value);
-    free(node);
-  }
-  else {
+  while (size) {
+
+    node = stack[--size];
 
     switch (node->type) {
 
-      case AST_PROGRAM:
-        // Freeing Functions
-        for (unsigned int i = 0; i < node->functionsSize; i++) {
-          AST_free_AST(node->function_list[i]);
+      case AST_ADD:
+      case AST_SUB:
+      case AST_MUL:
+      case AST_DIV:
+      case AST_SHL:
+      case AST_SHR:
+      case AST_BAND:
+      case AST_BOR:
+      case AST_XOR:
+      case AST_COMPARE:
+      case AST_ASSIGNMENT:
+
+        // A comparison without a comparison operator only has a value
+        if (node->value) {
+          vector_push(stack, size, capacity, node->value);
+          break;
         }
-        // Freeing global variables
-        for (unsigned int i = 0; i < node->size; i++) {
-          AST_free_AST(node->children[i]);
+
+        // The negation in -n has no left operand
+        if (node->leftChild) {
+          vector_push(stack, size, capacity, node->leftChild);
         }
-          
-        if (node->function_list) {
-          free(node->function_list);
+
+        vector_push(stack, size, capacity, node->rightChild);
+        break;
+
+      case AST_IF:
+      case AST_WHILE:
+
+        vector_push(stack, size, capacity, node->if_body);
+        vector_push(stack, size, capacity, node->condition);
+
+        if (node->else_body) {
+          vector_push(stack, size, capacity, node->else_body);
         }
-          
-        if (node->children) {
-          free(node->children);
+
+        break;
+
+      case AST_VARIABLE_DEC:
+      case AST_RETURN:
+
+        if (node->value) {
+          vector_push(stack, size, capacity, node->value);
         }
-          
-        free(node);
+
         break;
 
-      case AST_FUNCTION:
+      case AST_PROGRAM:
 
-        // Freeing Functions
-        for (unsigned int i = 0; i < node->size; i++) {
-          AST_free_AST(node->function_def_args[i]);
+        // Functions and global variables
+        for (size_t i = 0; i < node->functionsSize; i++) {
+          vector_push(stack, size, capacity, node->function_list[i]);
         }
-          
-        if (node->function_def_args) {
-          free(node->function_def_args);
+
+        for (size_t i = 0; i < node->size; i++) {
+          vector_push(stack, size, capacity, node->children[i]);
+        }
+
+        mfree(node->function_list);
+        mfree(node->children);
+        break;
+
+      case AST_FUNCTION:
+
+        for (size_t i = 0; i < node->size; i++) {
+          vector_push(stack, size, capacity, node->function_def_args[i]);
         }
-          
+
         if (node->function_body) {
-          AST_free_AST(node->function_body);
+          vector_push(stack, size, capacity, node->function_body);
         }
 
-        free(node);
+        mfree(node->function_def_args);
         break;
 
       case AST_COMPOUND:
 
-        for (unsigned int i = 0; i < node->size; i++) {
-          AST_free_AST(node->children[i]);
+        for (size_t i = 0; i < node->size; i++) {
+          vector_push(stack, size, capacity, node->children[i]);
         }
-          
-        if (node->children) {
-          free(node->children);
-        }
-          
-        free(node);
+
+        mfree(node->children);
         break;
 
       case AST_FUNC_CALL:
 
-        for (unsigned int i = 0; i < node->size; i++) {
-          AST_free_AST(node->arguments[i]);
+        for (size_t i = 0; i < node->size; i++) {
+          vector_push(stack, size, capacity, node->arguments[i]);
         }
-          
-        if (node->arguments) {
-          free(node->arguments);
-        }
-          
-        free(node);
+
+        mfree(node->arguments);
         break;
     }
+
+    mfree(node);
   }
+
+  mfree(stack);
 }
- 
\ No newline at end of file
@@ -17,6 +17,11 @@ typedef struct AST_STRUCT {
     AST_SUB,
     AST_MUL,
     AST_DIV,
+    AST_SHL,
+    AST_SHR,
+    AST_BAND,
+    AST_BOR,
+    AST_XOR,
     AST_ASSIGNMENT,
     AST_VARIABLE_DEC,
     AST_VARIABLE,
@@ -55,13 +60,15 @@ typedef struct AST_STRUCT {
   struct AST_STRUCT* function_body;
 
   size_t functionsSize;
+  size_t functionsCapacity;
 
 
   // Name used for different types of nodes, (e.g a variable node would have it's node->name be the identifier)
   char* name;
 
-  // Same for size
+  // Same for size, the capacity is of the children, the arguments or the function's arguments
   size_t size;
+  size_t capacity;
 
   // Int node
   char* int_value;
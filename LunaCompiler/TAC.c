@@ -66,6 +66,8 @@ TAC_list* traversal_visit(AST* node) {
   if (list->head) {
     traversal_optimize(list);
   }
+
+  stats_add(STATS_TAC, list->size);
     
   return list;
 }
@@ -86,10 +88,9 @@ void* traversal_build_instruction(AST* node, TAC_list* list) {
   }
     
   
-  // Check for binary operation
-  if (node->type == AST_ADD || node->type == AST_SUB || node->type == AST_MUL || node->type == AST_DIV ||
-    node->type == AST_COMPARE) {
-    return traversal_binop(node, list);
+  // Check for binary operation or function call
+  if (traversal_is_binop(node) || node->type == AST_FUNC_CALL) {
+    return traversal_expression(node, list);
   }
   
   // Match types and use fitting functions
@@ -113,7 +114,6 @@ void* traversal_build_instruction(AST* node, TAC_list* list) {
   case AST_FUNCTION:      instruction = traversal_func_dec(node, list); break;
   case AST_ASSIGNMENT:    instruction = traversal_assignment(node, list); break;
   case AST_VARIABLE_DEC:  instruction = traversal_var_dec(node, list); break;  // Variable declerations will become normal assignments
-  case AST_FUNC_CALL:     instruction = traversal_function_call(node, list); break;
   case AST_ASM:           instruction = traversal_asm(node, list); break;
   case AST_INT:           instruction = (char*)node->int_value; break;
   case AST_STRING:                   
@@ -122,7 +122,8 @@ void* traversal_build_instruction(AST* node, TAC_list* list) {
   case AST_COMPOUND:      traversal_statements(node, list); break;
   case AST_WHILE:         traversal_while(node, list); break;
   case AST_RETURN:        traversal_return(node, list); break;
-          
+
+  default: break;         // Binary operations were lowered above, the other nodes are only made by the traversal
   }
   
   return instruction;
@@ -145,12 +146,14 @@ TAC* traversal_func_dec(AST* node, TAC_list* list) {
   instruction->arg2 = init_arg(typeToString(node->var_type), CHAR_P);
 
   instruction->op = node->type;
+  instruction->label = list->labels;    // The labels of the function are numbered after this one
 
   list_push(list, instruction);
 
   // We also want to push a TAC instruction that tells us how many parameters are there for the function
   defAmount->op = AST_DEF_AMOUNT;
-  value = _itoa((int)node->size, (char*)mcalloc(1, numOfDigits(node->size) + 1), 10);
+  value = mcalloc(1, numOfDigits(node->size) + 1);
+  snprintf(value, numOfDigits(node->size) + 1, "%zu", node->size);
   defAmount->arg1 = init_arg(value, CHAR_P);
 
   list_push(list, defAmount);
@@ -189,7 +192,7 @@ TAC* traversal_var_dec(AST* node, TAC_list* list) {
     if (!node->value) {
 
       printf("[ERROR]: String must be initialized with a value");
-      exit(1);
+      error_exit();
     }
 
     buffer = mcalloc(1, numOfDigits(strlen(node->value->rightChild->name)) + 1);
@@ -203,24 +206,141 @@ TAC* traversal_var_dec(AST* node, TAC_list* list) {
 }
 
 /*
-traversal_binop handles binary operations between two expressions
-Input: An AST node, Triple list
+traversal_is_binop checks if a node is an operation between two expressions
+Input: Node
+Output: True if it's a binary operation
+*/
+bool traversal_is_binop(AST* node) {
+
+  return node->type == AST_ADD || node->type == AST_SUB || node->type == AST_MUL || node->type == AST_DIV || node->type == AST_SHL
+    || node->type == AST_SHR || node->type == AST_BAND || node->type == AST_BOR || node->type == AST_XOR || node->type == AST_COMPARE;
+}
+
+/*
+traversal_is_comparison checks if an operation of the TAC is a comparison
+Input: Operation
+Output: True if it is a comparison
+*/
+bool traversal_is_comparison(int op) {
+  return op == TOKEN_LESS || op == TOKEN_MORE || op == TOKEN_ELESS || op == TOKEN_EMORE || op == TOKEN_DEQUAL || op == TOKEN_NEQUAL;
+}
+
+/*
+traversal_is_condition checks if a comparison is the condition of the IFZ right after it, the backends jump on such comparisons
+and don't give them a value. Comparisons anywhere else evaluate to 1 or 0
+Input: Instruction
+Output: True if it's a comparison that only the next IFZ uses
+*/
+bool traversal_is_condition(TAC* instruction) {
+
+  return traversal_is_comparison(instruction->op) && instruction->next && instruction->next->op == AST_IFZ
+    && instruction->next->arg1->type == TAC_P && instruction->next->arg1->value == instruction;
+}
+
+/*
+traversal_expression lowers binary operations and function calls, the operands of an operation are lowered before it with the left one first,
+and a call comes before the parameters of it's arguments. Operations and calls inside them wait on a stack instead of recursing,
+so deep expressions and nested calls can't overflow the C stack
+Input: Operation or function call node, Triple list
 Output: A triple
 */
-TAC* traversal_binop(AST* node, TAC_list* list) {
+TAC* traversal_expression(AST* node, TAC_list* list) {
 
-  TAC* instruction = mcalloc(1, sizeof(TAC));
+  traversal_frame* stack = NULL;
+  traversal_frame* frame = NULL;
+  traversal_frame operation = traversal_init_frame(node, list);
+  TAC* instruction = NULL;
+  TAC* param = NULL;
+  arg_T* operand = NULL;
+  AST* child = NULL;
 
-  instruction->op = node->type == AST_COMPARE ? node->type_c : node->type;
+  size_t size = 0;
+  size_t capacity = 0;
 
-  instruction->arg1 = init_arg(traversal_build_instruction(node->leftChild, list), traversal_check_arg(node->leftChild));
-  instruction->arg2 = init_arg(traversal_build_instruction(node->rightChild, list), traversal_check_arg(node->rightChild));
+  vector_push(stack, size, capacity, operation);
 
-  list_push(list, instruction);
+  while (size) {
+
+    frame = &stack[size - 1];
+
+    // Every operand is done, the operation or call is the operand of the frame under it
+    if (frame->operand == frame->operands) {
+
+      instruction = frame->instruction;
+
+      // A call is already in the list, before it's parameters
+      if (frame->node->type != AST_FUNC_CALL) {
+        list_push(list, instruction);
+      }
+
+      if (!--size) { break; }
+
+      frame = &stack[size - 1];
+      operand = init_arg(instruction, TAC_P);
+    }
+    else {
+
+      // Print takes it's arguments in order, the arguments of other functions are pushed in reverse so they can be popped in order
+      if (frame->node->type == AST_FUNC_CALL) {
+        child = frame->node->arguments[frame->instruction->op == AST_PRINT ? frame->operand : frame->operands - 1 - frame->operand];
+      }
+      else {
+        child = frame->operand ? frame->node->rightChild : frame->node->leftChild;
+      }
+
+      if (traversal_is_binop(child) || child->type == AST_FUNC_CALL) {
+
+        operation = traversal_init_frame(child, list);
+        vector_push(stack, size, capacity, operation);
+        continue;
+      }
+
+      operand = init_arg(traversal_build_instruction(child, list), traversal_check_arg(child));
+    }
+
+    if (frame->node->type == AST_FUNC_CALL) {
+
+      param = mcalloc(1, sizeof(TAC));
+      param->arg1 = operand;
+      param->op = AST_PARAM;
+      list_push(list, param);
+    }
+    else if (frame->operand) {
+      frame->instruction->arg2 = operand;
+    }
+    else {
+      frame->instruction->arg1 = operand;
+    }
+
+    frame->operand++;
+  }
+
+  mfree(stack);
 
   return instruction;
 }
 
+/*
+traversal_init_frame makes the frame of an operation or a function call, a call is pushed to the list right away since it comes before it's parameters
+Input: Operation or function call node, Triple list
+Output: Frame
+*/
+traversal_frame traversal_init_frame(AST* node, TAC_list* list) {
+
+  traversal_frame frame = { node, NULL, 0, 2 };
+
+  if (node->type == AST_FUNC_CALL) {
+    frame.instruction = traversal_function_call(node, list);
+    frame.operands = node->size;
+  }
+  else {
+    frame.instruction = mcalloc(1, sizeof(TAC));
+    frame.instruction->op = node->type == AST_COMPARE ? node->type_c : node->type;
+  }
+
+  return frame;
+}
+
 /*
 traversal_assignment builds a TAC instruction for variable assignments
 Input: Assignment node, list to push to
@@ -258,18 +378,13 @@ TAC* traversal_asm(AST* node, TAC_list* list) {
 }
 
 /*
-traversal_function_call builds a TAC instruction for function calls
+traversal_function_call builds a TAC instruction for function calls, the parameters are pushed after it by traversal_expression
 Input: Function call node, list to push to
+Output: TAC instruction that was made
 */
 TAC* traversal_function_call(AST* node, TAC_list* list) {
 
-  TAC* instruction = NULL;
-  TAC* param = NULL;
-  
-  size_t counter = 0;
-  size_t size = 0;
-  
-  instruction = mcalloc(1, sizeof(TAC));
+  TAC* instruction = mcalloc(1, sizeof(TAC));
 
   instruction->arg1 = init_arg(node->name, CHAR_P);
 
@@ -278,30 +393,10 @@ TAC* traversal_function_call(AST* node, TAC_list* list) {
 
   // Arg2 will be the number of arguments passing into the function
   instruction->arg2 = init_arg(mcalloc(1, numOfDigits(node->size) + 1), CHAR_P);
-  _itoa(node->size, instruction->arg2->value, 10);
+  snprintf(instruction->arg2->value, numOfDigits(node->size) + 1, "%zu", node->size);
 
   list_push(list, instruction);
 
-  // Push params for function call
-  // If function call is a print, push the variables in order, otherwise, we push them in reverse to the stack 
-  // So we can pop them correctly in Assembly
-  
-  for (unsigned int i = 0; instruction->op == AST_PRINT && i < node->size; i++) {
-
-    param = mcalloc(1, sizeof(TAC));
-    param->arg1 = init_arg(traversal_build_instruction(node->arguments[i], list), traversal_check_arg(node->arguments[i]));
-    param->op = AST_PARAM;
-    list_push(list, param);
-  }
-
-  for (long i = node->size - 1; instruction->op != AST_PRINT && i >= 0; i--) {
-
-    param = mcalloc(1, sizeof(TAC));
-    param->arg1 = init_arg(traversal_build_instruction(node->arguments[i], list), traversal_check_arg(node->arguments[i]));
-    param->op = AST_PARAM;
-    list_push(list, param);
-  }
-  
   return instruction;
 }
 
@@ -318,8 +413,8 @@ TAC* traversal_condition(AST* node, TAC_list* list) {
   // a jump Assembly instruction if condition was not met
   instruction->op = AST_IFZ;      // If zero (If false)
 
-  // If there's no relation operation (<, >, <= etc)
-  instruction->arg1 = node->type_c == TOKEN_NOOP ? init_arg(traversal_build_instruction(node->value, list), traversal_check_arg(node->value)) : init_arg(traversal_binop(node, list), TAC_P);
+  // A comparison is lowered right before the IFZ, so the backends can jump on it, any other value is compared with 0
+  instruction->arg1 = init_arg(traversal_build_instruction(node, list), traversal_check_arg(node));
     
   list_push(list, instruction);
 
@@ -336,20 +431,19 @@ void traversal_if(AST* node, TAC_list* list) {
   TAC* instruction = traversal_condition(node->condition, list);    // First push the condition of the statement
 
   TAC* label1 = NULL;
-  TAC* label2 = mcalloc(1, sizeof(TAC));
+  TAC* label2 = NULL;
   TAC* gotoInstruction = NULL;
 
   unsigned int i = 0;
 
   traversal_statements(node->if_body, list);  // Then traversal through all the statements within the if block
   
-  label2->op = AST_LABEL;      // Generate a label to jump to for after the if and optional else statements
+  label2 = traversal_label(list, AST_LABEL);      // Generate a label to jump to for after the if and optional else statements
 
   if (node->else_body) {
 
     gotoInstruction = mcalloc(1, sizeof(TAC));
-    label1 = mcalloc(1, sizeof(TAC));
-    label1->op = AST_LABEL;
+    label1 = traversal_label(list, AST_LABEL);
 
     gotoInstruction->op = AST_GOTO;
     list_push(list, gotoInstruction);
@@ -382,10 +476,9 @@ void traversal_while(AST* node, TAC_list* list) {
 
   TAC* condition = NULL;
   TAC* gotoInstruction = mcalloc(1, sizeof(TAC));
-  TAC* label1 = mcalloc(1, sizeof(TAC));
-  TAC* label2 = mcalloc(1, sizeof(TAC));
+  TAC* label1 = traversal_label(list, AST_LOOP_LABEL);
+  TAC* label2 = traversal_label(list, AST_LABEL);
 
-  label1->op = AST_LOOP_LABEL;
   list_push(list, label1);
 
   condition = traversal_condition(node->condition, list);    // Create a condition
@@ -397,13 +490,29 @@ void traversal_while(AST* node, TAC_list* list) {
   gotoInstruction->arg1 = init_arg(label1, TAC_P);  
   list_push(list, gotoInstruction);
 
-  label2->op = AST_LABEL;
   list_push(list, label2);
 
   condition->arg2 = init_arg(label2, TAC_P);
 
 }
 
+/*
+traversal_label creates a label instruction and numbers it, so the code generator can name it without searching
+Input: List the label belongs to, type of label
+Output: Label instruction (not pushed yet)
+*/
+TAC* traversal_label(TAC_list* list, int op) {
+
+  TAC* label = mcalloc(1, sizeof(TAC));
+
+  label->op = op;
+  label->label = ++list->labels;
+
+  stats_add(STATS_LABELS, 1);
+
+  return label;
+}
+
 /*
 traversal_return builds a TAC instruction for return statements
 Input: Return node, list to push instruction to
@@ -558,7 +667,7 @@ void traversal_remove_triple(TAC_list* list, TAC* triple) {
       // Removing triple
       instruction->next = triple->next;
       list->size--;
-      free(triple);
+      mfree(triple);
     }
 
     instruction = instruction->next;
@@ -579,31 +688,31 @@ void traversal_free_array(TAC_list* list) {
 
     // Some special cases where we allocate a new string value rather than use already made one
     if (triple->op == AST_FUNC_CALL || triple->op == AST_PRINT) {
-      free(triple->arg2->value);
+      mfree(triple->arg2->value);
     }
 
     if (triple->op == AST_DEF_AMOUNT) {
-      free(triple->arg1->value);
+      mfree(triple->arg1->value);
     }
 
     if (triple->op == AST_VARIABLE_DEC && isNum(triple->arg2->value)) {
-      free(triple->arg2->value);
+      mfree(triple->arg2->value);
     }
     
     if (triple->arg1) {
-      free(triple->arg1);
+      mfree(triple->arg1);
     }
       
   
     if (triple->arg2) {
-      free(triple->arg2);
+      mfree(triple->arg2);
     }
       
     prev = triple;
     triple = triple->next;
-    free(prev);
+    mfree(prev);
   }
 
-  free(list);
+  mfree(list);
 }
  
\ No newline at end of file
@@ -24,6 +24,8 @@ typedef struct TAC_STRUCT {
   arg_T* arg1;
   arg_T* arg2;
 
+  unsigned int label;    // Label number, given to label instructions when they are created, functions keep the amount of labels before them
+
   struct TAC_STRUCT* next;
 
 } TAC;
@@ -33,9 +35,20 @@ typedef struct INSTRUCTIONS_STRUCT {
   TAC* head;
   TAC* last;
   size_t size;
+  unsigned int labels;    // Amount of labels that were numbered in the list
 
 } TAC_list;
 
+/* An operation or a function call of an expression that is lowered without recursion, it waits on a stack while it's operands are lowered */
+typedef struct TRAVERSAL_FRAME_STRUCT {
+
+  AST* node;
+  TAC* instruction;
+  size_t operand;     // The operand that is lowered next
+  size_t operands;    // 2 for operations, the amount of arguments for calls
+
+} traversal_frame;
+
 TAC_list* init_tac_list();
 TAC_list* traversal_visit(AST* node);
 
@@ -43,14 +56,20 @@ arg_T* init_arg(void* arg, int type);
 
 TAC* traversal_func_dec(AST* node, TAC_list* list);
 TAC* traversal_var_dec(AST* node, TAC_list* list);
-TAC* traversal_binop(AST* node, TAC_list* list);
+TAC* traversal_expression(AST* node, TAC_list* list);
+traversal_frame traversal_init_frame(AST* node, TAC_list* list);
 TAC* traversal_function_call(AST* node, TAC_list* list);
 TAC* traversal_assignment(AST* node, TAC_list* list);
 TAC* traversal_asm(AST* node, TAC_list* list);
 TAC* traversal_return(AST* node, TAC_list* list);
+TAC* traversal_label(TAC_list* list, int op);
 
 int traversal_check_arg(AST* node);
 
+bool traversal_is_binop(AST* node);
+bool traversal_is_comparison(int op);
+bool traversal_is_condition(TAC* instruction);
+
 void traversal_if(AST* node, TAC_list* list);
 void traversal_while(AST* node, TAC_list* list);
 void* traversal_build_instruction(AST* node, TAC_list* list);
@@ -0,0 +1,348 @@
+#include "allocations.h"
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+static SRWLOCK lock = SRWLOCK_INIT;
+#define ALLOCATIONS_LOCK() AcquireSRWLockExclusive(&lock)
+#define ALLOCATIONS_UNLOCK() ReleaseSRWLockExclusive(&lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+#define ALLOCATIONS_LOCK() pthread_mutex_lock(&lock)
+#define ALLOCATIONS_UNLOCK() pthread_mutex_unlock(&lock)
+#endif
+
+allocations_T allocations = { 0 };
+
+/*
+allocations_exit prints the report when the compiler exits, after an error too
+Input: None
+Output: None
+*/
+static void allocations_exit() {
+  allocations_report(stderr);
+}
+
+/*
+allocations_enable starts tracking every allocation, the report is printed to stderr when the compiler exits
+Input: None
+Output: None
+*/
+void allocations_enable() {
+
+  if (allocations.enabled) { return; }
+
+  allocations.enabled = true;
+  atexit(allocations_exit);
+}
+
+/*
+allocations_memory allocates memory for the tables of the tracker, which can't go through mcalloc and track itself
+Input: Memory to reallocate or NULL, size in bytes
+Output: Memory
+*/
+static void* allocations_memory(void* ptr, size_t size) {
+
+  void* memory = realloc(ptr, size);
+
+  if (!memory) {
+    ALLOCATIONS_UNLOCK();
+    printf("Heap error"); exit(1);
+  }
+
+  return memory;
+}
+
+static size_t allocations_hash_pointer(void* ptr) {
+  return (size_t)(((uint64_t)(uintptr_t)ptr >> 4) * 0x9E3779B97F4A7C15ULL >> 17);
+}
+
+static size_t allocations_hash_site(const char* file, unsigned int line) {
+
+  uint64_t hash = 14695981039346656037ULL ^ line;
+
+  for (; *file; file++) {
+    hash = (hash ^ (unsigned char)*file) * 1099511628211ULL;
+  }
+
+  return (size_t)hash;
+}
+
+/*
+allocations_find_site finds the site of a line, adding it the first time the line allocates
+Input: Name of the source file, line
+Output: Index of the site
+*/
+static size_t allocations_find_site(const char* file, unsigned int line) {
+
+  size_t mask = allocations.siteTableSize - 1;
+  size_t index = 0;
+  allocation_site* site = NULL;
+
+  // Half of the table stays empty so the searches are short
+  if ((allocations.sitesSize + 1) * 2 > allocations.siteTableSize) {
+
+    size_t size = allocations.siteTableSize ? allocations.siteTableSize * 2 : 256;
+    size_t* table = allocations_memory(NULL, size * sizeof(size_t));
+
+    memset(table, 0, size * sizeof(size_t));
+
+    for (size_t i = 0; i < allocations.sitesSize; i++) {
+
+      index = allocations_hash_site(allocations.sites[i].file, allocations.sites[i].line) & (size - 1);
+      while (table[index]) { index = (index + 1) & (size - 1); }
+
+      table[index] = i + 1;
+    }
+
+    free(allocations.siteTable);
+
+    allocations.siteTable = table;
+    allocations.siteTableSize = size;
+    mask = size - 1;
+  }
+
+  for (index = allocations_hash_site(file, line) & mask; allocations.siteTable[index]; index = (index + 1) & mask) {
+
+    site = &allocations.sites[allocations.siteTable[index] - 1];
+
+    // The same file can have a different name string in every translation unit, so the names are compared
+    if (site->line == line && (site->file == file || !strcmp(site->file, file))) {
+      return allocations.siteTable[index] - 1;
+    }
+  }
+
+  if (allocations.sitesSize == allocations.sitesCapacity) {
+    allocations.sitesCapacity = allocations.sitesCapacity ? allocations.sitesCapacity * 2 : 128;
+    allocations.sites = allocations_memory(allocations.sites, allocations.sitesCapacity * sizeof(allocation_site));
+  }
+
+  site = &allocations.sites[allocations.sitesSize];
+  memset(site, 0, sizeof(allocation_site));
+
+  site->file = file;
+  site->line = line;
+
+  allocations.siteTable[index] = ++allocations.sitesSize;
+
+  return allocations.sitesSize - 1;
+}
+
+/*
+allocations_insert_block adds a block to the blocks that weren't freed yet
+Input: Block
+Output: None
+*/
+static void allocations_insert_block(allocation_block* block) {
+
+  size_t mask = allocations.blocksCapacity - 1;
+  size_t index = 0;
+  allocation_site* site = &allocations.sites[block->site];
+
+  if ((allocations.blocksSize + 1) * 2 > allocations.blocksCapacity) {
+
+    allocation_block* old = allocations.blocks;
+    size_t capacity = allocations.blocksCapacity;
+
+    allocations.blocksCapacity = capacity ? capacity * 2 : 4096;
+    allocations.blocks = allocations_memory(NULL, allocations.blocksCapacity * sizeof(allocation_block));
+    memset(allocations.blocks, 0, allocations.blocksCapacity * sizeof(allocation_block));
+    mask = allocations.blocksCapacity - 1;
+
+    for (size_t i = 0; i < capacity; i++) {
+
+      if (!old[i].ptr) { continue; }
+
+      for (index = allocations_hash_pointer(old[i].ptr) & mask; allocations.blocks[index].ptr; index = (index + 1) & mask) { }
+      allocations.blocks[index] = old[i];
+    }
+
+    free(old);
+  }
+
+  for (index = allocations_hash_pointer(block->ptr) & mask; allocations.blocks[index].ptr; index = (index + 1) & mask) { }
+
+  allocations.blocks[index] = *block;
+  allocations.blocksSize++;
+
+  allocations.live += block->size;
+  site->live += block->size;
+
+  if (allocations.live > allocations.peak) { allocations.peak = allocations.live; }
+  if (site->live > site->peak) { site->peak = site->live; }
+}
+
+/*
+allocations_remove_block removes a block from the blocks that weren't freed yet
+Input: Pointer to the block, block to copy it to (can be NULL)
+Output: False if the pointer wasn't allocated while tracking
+*/
+static bool allocations_remove_block(void* ptr, allocation_block* removed) {
+
+  size_t mask = allocations.blocksCapacity - 1;
+  size_t index = 0;
+  size_t next = 0;
+  size_t home = 0;
+
+  if (!allocations.blocksSize) { return false; }
+
+  for (index = allocations_hash_pointer(ptr) & mask; allocations.blocks[index].ptr != ptr; index = (index + 1) & mask) {
+    if (!allocations.blocks[index].ptr) { return false; }
+  }
+
+  allocations.live -= allocations.blocks[index].size;
+  allocations.sites[allocations.blocks[index].site].live -= allocations.blocks[index].size;
+  allocations.blocksSize--;
+
+  if (removed) { *removed = allocations.blocks[index]; }
+
+  // Blocks after it that were pushed past the hole move back into it, so the searches don't stop at the hole
+  for (next = (index + 1) & mask; allocations.blocks[next].ptr; next = (next + 1) & mask) {
+
+    home = allocations_hash_pointer(allocations.blocks[next].ptr) & mask;
+
+    if (((next - home) & mask) >= ((next - index) & mask)) {
+      allocations.blocks[index] = allocations.blocks[next];
+      index = next;
+    }
+  }
+
+  allocations.blocks[index].ptr = NULL;
+
+  return true;
+}
+
+/*
+allocations_add tracks a block that mcalloc allocated
+Input: Block, size in bytes, source file and line of the call
+Output: None
+*/
+void allocations_add(void* ptr, size_t size, const char* file, unsigned int line) {
+
+  allocation_block block = { ptr, size, 0, 0 };
+
+  ALLOCATIONS_LOCK();
+
+  block.site = allocations_find_site(file, line);
+  allocations.sites[block.site].allocations++;
+  allocations.sites[block.site].bytes += size;
+
+  allocations_insert_block(&block);
+
+  ALLOCATIONS_UNLOCK();
+}
+
+/*
+allocations_realloc reallocates a block and tracks it, the block moves to the site of the call.
+It reallocates inside the lock, otherwise another thread could get the old address and track it before the old block is removed
+Input: Block or NULL, size in bytes, source file and line of the call
+Output: The reallocated block, NULL if realloc failed or freed the block
+*/
+void* allocations_realloc(void* ptr, size_t size, const char* file, unsigned int line) {
+
+  allocation_block block = { 0 };
+  allocation_site* site = NULL;
+  void* memory = NULL;
+  bool tracked = false;
+
+  ALLOCATIONS_LOCK();
+
+  // A block that was allocated before tracking started begins a new chain
+  tracked = ptr && allocations_remove_block(ptr, &block);
+
+  // When realloc fails the old block is still allocated
+  if (!(memory = realloc(ptr, size)) && size) {
+
+    if (tracked) { allocations_insert_block(&block); }
+
+    ALLOCATIONS_UNLOCK();
+    return NULL;
+  }
+
+  if (tracked) { block.chain++; }
+
+  block.ptr = memory;
+  block.size = size;
+  block.site = allocations_find_site(file, line);
+
+  site = &allocations.sites[block.site];
+  site->reallocations++;
+  site->bytes += size;
+
+  if (block.chain > site->longestChain) { site->longestChain = block.chain; }
+
+  if (memory) {
+    allocations_insert_block(&block);
+  }
+
+  ALLOCATIONS_UNLOCK();
+
+  return memory;
+}
+
+/*
+allocations_remove stops tracking a block before it's freed, blocks that weren't tracked are ignored
+Input: Block
+Output: None
+*/
+void allocations_remove(void* ptr) {
+
+  ALLOCATIONS_LOCK();
+  allocations_remove_block(ptr, NULL);
+  ALLOCATIONS_UNLOCK();
+}
+
+static int allocations_compare_sites(const void* first, const void* second) {
+
+  const allocation_site* a = first;
+  const allocation_site* b = second;
+
+  if (a->bytes != b->bytes) { return a->bytes < b->bytes ? 1 : -1; }
+  if (a->allocations + a->reallocations != b->allocations + b->reallocations) {
+    return a->allocations + a->reallocations < b->allocations + b->reallocations ? 1 : -1;
+  }
+
+  return strcmp(a->file, b->file) ? strcmp(a->file, b->file) : (int)a->line - (int)b->line;
+}
+
+/*
+allocations_report prints every site that allocated, the sites that asked for the most bytes first
+Input: File to print to
+Output: None
+*/
+void allocations_report(FILE* file) {
+
+  allocation_site* sites = NULL;
+  char name[64] = { 0 };
+  const char* slash = NULL;
+
+  ALLOCATIONS_LOCK();
+
+  // The tables of the sites point into the array, so it's sorted as a copy
+  sites = allocations_memory(NULL, (allocations.sitesSize + 1) * sizeof(allocation_site));
+  memcpy(sites, allocations.sites, allocations.sitesSize * sizeof(allocation_site));
+  qsort(sites, allocations.sitesSize, sizeof(allocation_site), allocations_compare_sites);
+
+  fprintf(file, "%-28s %12s %12s %10s %16s %14s %14s\n", "Allocation site", "Allocations", "Reallocs", "Chain", "Bytes", "Peak live", "Live");
+
+  for (size_t i = 0; i < allocations.sitesSize; i++) {
+
+    // Only the name of the file, without the directories of the build
+    slash = strrchr(sites[i].file, '/');
+    if (strrchr(sites[i].file, '\\') > slash) { slash = strrchr(sites[i].file, '\\'); }
+
+    snprintf(name, sizeof(name), "%s:%u", slash ? slash + 1 : sites[i].file, sites[i].line);
+
+    fprintf(file, "%-28s %12llu %12llu %10llu %16llu %14llu %14llu\n", name, (unsigned long long)sites[i].allocations,
+      (unsigned long long)sites[i].reallocations, (unsigned long long)sites[i].longestChain, (unsigned long long)sites[i].bytes,
+      (unsigned long long)sites[i].peak, (unsigned long long)sites[i].live);
+  }
+
+  fprintf(file, "\nPeak live memory: %llu bytes, not freed: %llu bytes in %llu blocks\n", (unsigned long long)allocations.peak,
+    (unsigned long long)allocations.live, (unsigned long long)allocations.blocksSize);
+
+  free(sites);
+
+  ALLOCATIONS_UNLOCK();
+}
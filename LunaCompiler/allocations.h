@@ -0,0 +1,62 @@
+#ifndef ALLOCATIONS_H
+#define ALLOCATIONS_H
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* A line of the source code that allocates, every call of mcalloc and mrealloc is counted by where it was called from */
+typedef struct ALLOCATION_SITE_STRUCT {
+
+  const char* file;
+  unsigned int line;
+
+  uint64_t allocations;     // Calls to mcalloc
+  uint64_t reallocations;   // Calls to mrealloc
+  uint64_t bytes;           // Bytes they were asked for
+  uint64_t longestChain;    // Most reallocations a block went through until it was reallocated here
+
+  size_t live;              // Bytes of the blocks this site allocated last that weren't freed yet
+  size_t peak;
+
+} allocation_site;
+
+/* A block that wasn't freed yet */
+typedef struct ALLOCATION_BLOCK_STRUCT {
+
+  void* ptr;
+  size_t size;
+  size_t site;      // Index of the site that allocated or reallocated the block last
+  uint64_t chain;   // Amount of times the block was reallocated
+
+} allocation_block;
+
+typedef struct ALLOCATIONS_STRUCT {
+
+  bool enabled;
+
+  allocation_site* sites;
+  size_t sitesCapacity;
+  size_t sitesSize;
+
+  size_t* siteTable;        // Hash tables with linear probing and sizes that are powers of 2, the site table has indexes of sites plus 1
+  size_t siteTableSize;
+
+  allocation_block* blocks;
+  size_t blocksCapacity;
+  size_t blocksSize;
+
+  size_t live;      // Bytes of all the blocks that weren't freed yet
+  size_t peak;
+
+} allocations_T;
+
+extern allocations_T allocations;
+
+void allocations_enable();
+void allocations_add(void* ptr, size_t size, const char* file, unsigned int line);
+void* allocations_realloc(void* ptr, size_t size, const char* file, unsigned int line);
+void allocations_remove(void* ptr);
+void allocations_report(FILE* file);
+
+#endif
@@ -0,0 +1,269 @@
+# Compiler benchmark: generates Luna programs of different shapes in English and Hebrew, compiles each one a few times
+# with -stats=json and reports the time of every phase, tokens/s, TAC/s and the peak memory of the compiler.
+# Every run is appended to a results file and compared with the run before it, so regressions show up between commits
+# Run it with the compiler that was built: python benchmark.py --compiler ./LunaCompiler
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+# Functions, depth of the expression trees, statements in every while body, locals and branches of every function
+SHAPES = {
+    "functions":   (400, 3, 4, 4, 2),
+    "expressions": (20, 10, 1, 2, 1),
+    "loops":       (20, 2, 300, 8, 1),
+    "locals":      (20, 2, 4, 300, 1),
+    "branches":    (20, 2, 2, 4, 300),
+}
+
+ENGLISH = {"int": "int", "if": "if", "else": "else", "while": "while", "return": "return", "print": "print", "main": "main"}
+HEBREW = {"int": "מספר", "if": "אם", "else": "אחרת", "while": "בזמןש", "return": "תחזיר", "print": "תדפיס", "main": "ראשי"}
+
+# Hebrew letters without the final forms, the lexer spells each one with a different English letter
+HEBREW_LETTERS = "אבגדהוזחטיכלמנסעפצקרשת"
+
+# Phases of the -stats report, in the order they run
+PHASES = ["read", "parse", "ir", "cache", "backend", "run", "free"]
+
+
+class Program:
+    """Writes a Luna program in one of the languages, names are numbered so the two languages make the same program"""
+
+    def __init__(self, language):
+        self.words = HEBREW if language == "hebrew" else ENGLISH
+        self.hebrew = language == "hebrew"
+        self.lines = []
+
+    def name(self, kind, number):
+        if not self.hebrew:
+            return "%s%d" % (kind, number)
+
+        # A letter for the kind and the number in base 22, every name starts with Shin so it can't spell a built in name
+        digits = HEBREW_LETTERS[number % 22]
+        while number >= 22:
+            number //= 22
+            digits = HEBREW_LETTERS[number % 22] + digits
+
+        return "ש" + HEBREW_LETTERS["fvan".index(kind[0])] + "_" + digits
+
+    def expression(self, depth, operands, counter):
+        if depth == 0:
+            counter[0] += 1
+            return operands[counter[0] % len(operands)]
+
+        operator = "+-*"[(depth + counter[0]) % 3]
+        return "(%s %s %s)" % (self.expression(depth - 1, operands, counter), operator, self.expression(depth - 1, operands, counter))
+
+    def function(self, index, depth, loop, locals, branches):
+        words = self.words
+        a, b = self.name("arg", 0), self.name("arg", 1)
+        variables = [self.name("var", i) for i in range(locals)]
+        result, counter = self.name("var", locals), self.name("var", locals + 1)
+
+        self.lines.append("%s %s(%s %s, %s %s) {" % (words["int"], self.name("function", index), words["int"], a, words["int"], b))
+
+        for i, variable in enumerate(variables):
+            self.lines.append("  %s %s = %s + %d;" % (words["int"], variable, a if i % 2 else b, i))
+
+        self.lines.append("  %s %s = %s;" % (words["int"], result, self.expression(depth, [a, b] + variables[:4] + ["3", "7"], [index])))
+        self.lines.append("  %s %s = 0;" % (words["int"], counter))
+        self.lines.append("  %s (%s < 10) {" % (words["while"], counter))
+
+        for i in range(loop):
+            variable = variables[i % len(variables)]
+            self.lines.append("    %s = %s + %s * %d;" % (variable, variable, counter, i % 7 + 1))
+
+        self.lines.append("    %s = %s + 1;" % (counter, counter))
+        self.lines.append("  }")
+
+        for i in range(branches):
+            self.lines.append("  %s (%s > %d) {" % (words["if"], result, i))
+            self.lines.append("    %s = %s - %d;" % (result, result, i % 9 + 1))
+            self.lines.append("  }")
+            self.lines.append("  %s {" % words["else"])
+            self.lines.append("    %s = %s + %s;" % (result, result, variables[i % len(variables)]))
+            self.lines.append("  }")
+
+        if index:
+            self.lines.append("  %s = %s + %s(%s, %s);" % (result, result, self.name("function", index - 1), a, b))
+
+        self.lines.append("  %s %s;" % (words["return"], result))
+        self.lines.append("}")
+        self.lines.append("")
+
+    def generate(self, functions, depth, loop, locals, branches):
+        for index in range(functions):
+            self.function(index, depth, loop, locals, branches)
+
+        self.lines.append("%s %s() {" % (self.words["int"], self.words["main"]))
+        self.lines.append("  %s(%s(1, 2));" % (self.words["print"], self.name("function", functions - 1)))
+        self.lines.append("  %s 0;" % self.words["return"])
+        self.lines.append("}")
+
+        return "\n".join(self.lines) + "\n"
+
+
+def compile_once(compiler, path, backend):
+    """Compiles a file on it's own in batch mode (which doesn't print the IR), returns the -stats report and the peak RSS in KB"""
+
+    process = subprocess.Popen([compiler, "-j", "1", path, backend, "-stats=json"], stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    errors = process.stderr.read().decode("utf-8", "replace")
+    peak = None
+
+    if hasattr(os, "wait4"):
+        _, status, usage = os.wait4(process.pid, 0)
+        process.returncode = os.waitstatus_to_exitcode(status) if hasattr(os, "waitstatus_to_exitcode") else status
+        peak = usage.ru_maxrss // 1024 if sys.platform == "darwin" else usage.ru_maxrss
+    else:
+        process.wait()
+
+    lines = [line for line in errors.splitlines() if line.startswith("{")]
+
+    if process.returncode or not lines:
+        raise SystemExit("%s didn't compile:\n%s" % (path, errors))
+
+    return json.loads(lines[-1]), peak
+
+
+def measure(compiler, path, backend, runs):
+    """Keeps the fastest time of every phase over the runs, the counters are the same in every run"""
+
+    best = None
+
+    for _ in range(runs):
+        report, peak = compile_once(compiler, path, backend)
+
+        if not best:
+            best = {"phases": report["phases"], "counters": report["counters"], "peak_kb": peak}
+            continue
+
+        for phase in PHASES:
+            for key in ("wall_ms", "cpu_ms"):
+                best["phases"][phase][key] = min(best["phases"][phase][key], report["phases"][phase][key])
+
+        if peak is not None:
+            best["peak_kb"] = max(best["peak_kb"], peak)
+
+    parse = best["phases"]["parse"]["wall_ms"]
+    ir = best["phases"]["ir"]["wall_ms"]
+
+    best["total_ms"] = sum(best["phases"][phase]["wall_ms"] for phase in PHASES)
+    best["tokens_per_s"] = best["counters"]["tokens"] / parse * 1000 if parse else 0
+    best["tac_per_s"] = best["counters"]["tac"] / ir * 1000 if ir else 0
+
+    return best
+
+
+def commit():
+    """Short hash of the commit that is checked out, with a + when the tree has changes"""
+
+    try:
+        here = os.path.dirname(os.path.abspath(__file__))
+        head = subprocess.check_output(["git", "rev-parse", "--short", "HEAD"], cwd=here, stderr=subprocess.DEVNULL).decode().strip()
+        dirty = subprocess.call(["git", "diff", "--quiet", "HEAD"], cwd=here, stderr=subprocess.DEVNULL)
+        return head + ("+" if dirty else "")
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def load_previous(path, backend, scale):
+    """The last run in the results file with the same backend and scale, None if there is none"""
+
+    if not os.path.exists(path):
+        return None
+
+    with open(path, encoding="utf-8") as file:
+        runs = [json.loads(line) for line in file if line.strip()]
+
+    runs = [run for run in runs if run["backend"] == backend and run["scale"] == scale]
+
+    return runs[-1] if runs else None
+
+
+def report(results, previous, threshold):
+    """Prints a line for every benchmark, and how it's total time changed since the previous run"""
+
+    print("%-22s %9s %9s %9s %9s %9s %9s %12s %12s %9s %10s" % ("Benchmark", "Tokens", "TAC", "Parse ms", "IR ms",
+          "Codegen ms", "Total ms", "Tokens/s", "TAC/s", "Peak MB", "Change"))
+
+    regressions = []
+
+    for name, result in results.items():
+        phases = result["phases"]
+        peak = "%9.1f" % (result["peak_kb"] / 1024) if result["peak_kb"] is not None else "%9s" % "-"
+        change = ""
+
+        if previous and name in previous["benchmarks"]:
+            before = previous["benchmarks"][name]["total_ms"]
+            percent = (result["total_ms"] - before) / before * 100 if before else 0
+            change = "%+.1f%%" % percent
+
+            if percent > threshold:
+                regressions.append("%s is %.1f%% slower" % (name, percent))
+
+        print("%-22s %9d %9d %9.2f %9.2f %9.2f %9.2f %12.0f %12.0f %s %10s" % (name, result["counters"]["tokens"], result["counters"]["tac"],
+              phases["parse"]["wall_ms"], phases["ir"]["wall_ms"], phases["backend"]["wall_ms"], result["total_ms"],
+              result["tokens_per_s"], result["tac_per_s"], peak, change))
+
+    if previous:
+        print("\nCompared with %s from %s" % (previous["commit"], previous["date"]))
+
+    for regression in regressions:
+        print("Regression: " + regression)
+
+    return regressions
+
+
+def main():
+
+    here = os.path.dirname(os.path.abspath(__file__))
+
+    arguments = argparse.ArgumentParser(description="Benchmarks the phases of the Luna compiler on generated programs")
+    arguments.add_argument("--compiler", default=os.path.join(here, "LunaCompiler.exe" if os.name == "nt" else "LunaCompiler"))
+    arguments.add_argument("--backend", default="-obj", help="output flag, -obj only writes an object file so nothing is assembled")
+    arguments.add_argument("--runs", type=int, default=5)
+    arguments.add_argument("--scale", type=float, default=1, help="multiplies the amount of functions of every shape")
+    arguments.add_argument("--only", help="only run the benchmarks that have this in their name")
+    arguments.add_argument("--results", default=os.path.join(here, "benchmarkResults.jsonl"))
+    arguments.add_argument("--threshold", type=float, default=10, help="percent of slowdown that counts as a regression")
+    arguments.add_argument("--keep", help="write the programs to this directory instead of a temporary one")
+    arguments.add_argument("--no-save", action="store_true", help="don't append this run to the results file")
+    options = arguments.parse_args()
+
+    directory = options.keep or tempfile.mkdtemp(prefix="lunaBenchmark")
+    os.makedirs(directory, exist_ok=True)
+
+    results = {}
+
+    for shape, (functions, depth, loop, locals, branches) in SHAPES.items():
+        for language in ("english", "hebrew"):
+
+            name = "%s-%s" % (shape, language)
+            if options.only and options.only not in name:
+                continue
+
+            path = os.path.join(directory, name + ".luna")
+            with open(path, "w", encoding="utf-8") as file:
+                file.write(Program(language).generate(max(1, int(functions * options.scale)), depth, loop, locals, branches))
+
+            results[name] = measure(options.compiler, path, options.backend, options.runs)
+
+    previous = load_previous(options.results, options.backend, options.scale)
+    regressions = report(results, previous, options.threshold)
+
+    if not options.no_save:
+        record = {"commit": commit(), "date": time.strftime("%Y-%m-%d %H:%M:%S"), "backend": options.backend,
+                  "scale": options.scale, "benchmarks": results}
+
+        with open(options.results, "a", encoding="utf-8") as file:
+            file.write(json.dumps(record) + "\n")
+
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,785 @@
+#include "bytecode.h"
+#include "x64.h"
+
+#define BC_INITIAL_SIZE 64
+
+static size_t bytecode_hash(uint64_t key) {
+  return (size_t)((key ^ key >> 32) * 0x9E3779B97F4A7C15ULL >> 17);
+}
+
+/*
+bytecode_lower lowers the TAC list of a program to register bytecode for the VM
+Input: Symbol table, TAC list
+Output: Bytecode program
+*/
+bc_program* bytecode_lower(table_T* table, TAC_list* list) {
+
+  bc_lowering* lowering = mcalloc(1, sizeof(bc_lowering));
+  bc_program* program = mcalloc(1, sizeof(bc_program));
+  bc_function* function = NULL;
+  long main = 0;
+
+  lowering->program = program;
+  lowering->table = table;
+  lowering->statements = 1;
+  lowering->labels = mcalloc(list->labels + 1, sizeof(uint32_t));
+  memset(lowering->labels, 0xFF, (list->labels + 1) * sizeof(uint32_t));    // Fill with BC_NO_LABEL
+
+  // Functions can be called before they are defined, so find all of them first
+  for (TAC* instruction = list->head; instruction; instruction = instruction->next) {
+
+    if (instruction->op != AST_FUNCTION) { continue; }
+
+    vector_reserve(program->functions, program->functionsCapacity, program->functionsSize + 1);
+
+    function = &program->functions[program->functionsSize++];
+    memset(function, 0, sizeof(bc_function));
+    function->name = instruction->arg1->value;
+    function->params = atoi(instruction->next->arg1->value);
+  }
+
+  if ((main = bytecode_find_function(program, "main")) < 0) {
+    printf("[Error]: No main file to start executing from"); error_exit();
+  }
+
+  program->main = (uint32_t)main;
+
+  table->tableIndex = 0;
+
+  // Outside of functions there can only be global variables
+  for (lowering->instruction = list->head; lowering->instruction; lowering->instruction = lowering->instruction->next) {
+
+    switch (lowering->instruction->op) {
+
+      case AST_FUNCTION:     bytecode_function(lowering); break;
+      case AST_VARIABLE_DEC: bytecode_global_var(lowering); break;
+      default: printf("[Error]: Global variables must be initialized with a constant"); error_exit();
+    }
+  }
+
+  bytecode_patch_jumps(lowering);
+
+  mfree(lowering->calls);
+  mfree(lowering->labels);
+  mfree(lowering->jumps);
+  mfree(lowering->locals);
+  mfree(lowering->temps);
+  mfree(lowering->constants);
+  mfree(lowering);
+
+  return program;
+}
+
+/*
+bytecode_global_var adds a global variable, global variables are initialized by the assignment after them
+Input: Lowering state
+Output: None
+*/
+void bytecode_global_var(bc_lowering* lowering) {
+
+  bc_program* program = lowering->program;
+  TAC* assignment = lowering->instruction->next;
+  entry_T* entry = table_search_entry(lowering->table, lowering->instruction->arg1->value);
+  bc_value value = 0;
+
+  if (!assignment || assignment->op != AST_ASSIGNMENT || assignment->arg2->type != CHAR_P) {
+    printf("[Error]: Global variable '%s' must be initialized with a constant", entry->name); error_exit();
+  }
+
+  if (entry->dtype == DATA_STRING) {
+    value = bytecode_add_string(program, assignment->arg2->value);
+  }
+  else if (isNum(assignment->arg2->value)) {
+    value = atoll(assignment->arg2->value);
+  }
+  else {
+    printf("[Error]: Global variable '%s' must be initialized with a constant", entry->name); error_exit();
+  }
+
+  vector_reserve(program->globals, program->globalsCapacity, program->globalsSize + 1);
+  vector_reserve(program->globalNames, program->globalNamesCapacity, program->globalsSize + 1);
+
+  program->globals[program->globalsSize] = value;
+  program->globalNames[program->globalsSize++] = entry->name;
+
+  lowering->instruction = assignment;    // Skip the assignment
+}
+
+/*
+bytecode_function lowers a function, it's parameters are the first registers of it's frame
+Input: Lowering state
+Output: None
+*/
+void bytecode_function(bc_lowering* lowering) {
+
+  bc_program* program = lowering->program;
+  bc_function* function = &program->functions[bytecode_find_function(program, lowering->instruction->arg1->value)];
+
+  lowering->function = function;
+  lowering->functions++;
+  lowering->localsSize = 0;
+  lowering->tempsSize = 0;
+  lowering->statements++;
+  lowering->next = lowering->statement = lowering->maxRegs = function->params;
+  lowering->callArea = 0;
+
+  function->start = program->size;
+  function->pool = program->poolSize;
+  function->poolSize = 0;
+
+  lowering->table->tableIndex++;
+  lowering->table = lowering->table->nestedScopes[lowering->table->tableIndex - 1];
+
+  for (uint32_t i = 0; i < function->params; i++) {
+
+    vector_reserve(lowering->locals, lowering->localsCapacity, lowering->localsSize + 1);
+    lowering->locals[lowering->localsSize].entry = lowering->table->entries[i];
+    lowering->locals[lowering->localsSize++].reg = i;
+  }
+
+  // Skipping number of parameters and start of block
+  lowering->instruction = lowering->instruction->next->next->next;
+
+  while (lowering->instruction->op != TOKEN_FUNC_END) {
+    bytecode_instruction(lowering);
+    lowering->instruction = lowering->instruction->next;
+  }
+
+  // Functions that end without a return statement return 0
+  bytecode_push(program, BC_RET, bytecode_constant(lowering, 0), 0, 0);
+
+  bytecode_layout(lowering);
+}
+
+/*
+bytecode_instruction checks for the operation in a TAC instruction inside a function and lowers it
+Input: Lowering state
+Output: None
+*/
+void bytecode_instruction(bc_lowering* lowering) {
+
+  TAC* instruction = lowering->instruction;
+  bc_local* local = NULL;
+
+  switch (instruction->op) {
+
+    case TOKEN_LBRACE:
+      // Go to the fitting symbol table for the new block
+      lowering->table->tableIndex++;
+      lowering->table = lowering->table->nestedScopes[lowering->table->tableIndex - 1];
+      break;
+
+    case TOKEN_RBRACE:
+      lowering->table->tableIndex = 0;
+      lowering->table = lowering->table->prev;
+      bytecode_end_statement(lowering);
+      break;
+
+    case AST_ADD: bytecode_binop(lowering, BC_ADD); break;
+    case AST_SUB: bytecode_binop(lowering, BC_SUB); break;
+    case AST_MUL: bytecode_binop(lowering, BC_MUL); break;
+    case AST_DIV: bytecode_binop(lowering, BC_DIV); break;
+    case AST_SHL: bytecode_binop(lowering, BC_SHL); break;
+    case AST_SHR: bytecode_binop(lowering, BC_SHR); break;
+    case AST_BAND: bytecode_binop(lowering, BC_AND); break;
+    case AST_BOR: bytecode_binop(lowering, BC_OR); break;
+    case AST_XOR: bytecode_binop(lowering, BC_XOR); break;
+
+    case TOKEN_DEQUAL: bytecode_compare(lowering, BC_SETE); break;
+    case TOKEN_NEQUAL: bytecode_compare(lowering, BC_SETNE); break;
+    case TOKEN_LESS:   bytecode_compare(lowering, BC_SETL); break;
+    case TOKEN_ELESS:  bytecode_compare(lowering, BC_SETLE); break;
+    case TOKEN_MORE:   bytecode_compare(lowering, BC_SETG); break;
+    case TOKEN_EMORE:  bytecode_compare(lowering, BC_SETGE); break;
+
+    case AST_VARIABLE_DEC:
+
+      // Locals get a register for the rest of the function
+      vector_reserve(lowering->locals, lowering->localsCapacity, lowering->localsSize + 1);
+      local = &lowering->locals[lowering->localsSize++];
+      local->entry = table_search_entry(lowering->table, instruction->arg1->value);
+      local->reg = bytecode_new_register(lowering);
+
+      lowering->statement = lowering->next;
+      break;
+
+    case AST_FUNC_CALL:   bytecode_func_call(lowering); break;
+    case AST_PRINT:       bytecode_print(lowering); break;
+    case AST_PARAM:       bytecode_param(lowering); break;
+    case AST_ASSIGNMENT:  bytecode_assignment(lowering); bytecode_end_statement(lowering); break;
+    case AST_IFZ:         bytecode_if_false(lowering); bytecode_end_statement(lowering); break;
+
+    case AST_RETURN:
+      bytecode_push(lowering->program, BC_RET, bytecode_operand(lowering, instruction->arg1), 0, 0);
+      bytecode_end_statement(lowering);
+      break;
+
+    case AST_GOTO: bytecode_jump(lowering, BC_JMP, 0, 0, instruction->arg1->value); break;
+
+    case AST_LABEL:
+    case AST_LOOP_LABEL:
+      lowering->labels[instruction->label] = (uint32_t)lowering->program->size;
+      bytecode_end_statement(lowering);
+      break;
+
+    case AST_ASM: printf("[Error]: Inline Assembly can't run in the VM"); error_exit();
+  }
+}
+
+/*
+bytecode_binop lowers an arithmetic operation to a new register
+Input: Lowering state, bytecode operation
+Output: None
+*/
+void bytecode_binop(bc_lowering* lowering, int op) {
+
+  uint32_t arg1 = bytecode_operand(lowering, lowering->instruction->arg1);
+  uint32_t arg2 = bytecode_operand(lowering, lowering->instruction->arg2);
+
+  // The operands are used up, so the result can go in their registers
+  bytecode_release(lowering, arg2);
+  bytecode_release(lowering, arg1);
+
+  bytecode_push(lowering->program, op, bytecode_set_temp(lowering, lowering->instruction), arg1, arg2);
+}
+
+/*
+bytecode_compare lowers a comparison to 1 or 0 in a new register, unless the IFZ after it jumps on it
+Input: Lowering state, bytecode operation
+Output: None
+*/
+void bytecode_compare(bc_lowering* lowering, int op) {
+
+  if (!traversal_is_condition(lowering->instruction)) {
+    bytecode_binop(lowering, op);
+  }
+}
+
+/*
+bytecode_if_false lowers IFZ operations, a comparison right before it becomes a single compare and jump
+Input: Lowering state
+Output: None
+*/
+void bytecode_if_false(bc_lowering* lowering) {
+
+  TAC* instruction = lowering->instruction;
+  TAC* compare = instruction->arg1->type == TAC_P && traversal_is_condition(instruction->arg1->value) ? instruction->arg1->value : NULL;
+  uint32_t op = BC_JZ;
+
+  // Jump when the comparison is false, so every comparison jumps on it's opposite
+  switch (compare ? compare->op : 0) {
+
+    case TOKEN_LESS:   op = BC_JGE; break;
+    case TOKEN_MORE:   op = BC_JLE; break;
+    case TOKEN_ELESS:  op = BC_JG; break;
+    case TOKEN_EMORE:  op = BC_JL; break;
+    case TOKEN_DEQUAL: op = BC_JNE; break;
+    case TOKEN_NEQUAL: op = BC_JE; break;
+  }
+
+  if (op == BC_JZ) {
+    bytecode_jump(lowering, BC_JZ, bytecode_operand(lowering, instruction->arg1), 0, instruction->arg2->value);
+  }
+  else {
+    bytecode_jump(lowering, op, bytecode_operand(lowering, compare->arg1), bytecode_operand(lowering, compare->arg2), instruction->arg2->value);
+  }
+}
+
+/*
+bytecode_assignment lowers an assignment, when the value was just computed it is computed straight into the variable
+Input: Lowering state
+Output: None
+*/
+void bytecode_assignment(bc_lowering* lowering) {
+
+  bc_program* program = lowering->program;
+  TAC* instruction = lowering->instruction;
+  entry_T* entry = table_search_entry(lowering->table, instruction->arg1->value);
+  bc_local* local = bytecode_find_local(lowering, entry);
+  bc_instruction* last = program->size > lowering->function->start ? &program->code[program->size - 1] : NULL;
+  uint32_t value = bytecode_operand(lowering, instruction->arg2);
+
+  if (!local) {
+    bytecode_push(program, BC_STOREG, (uint32_t)bytecode_find_global(program, entry->name), value, 0);
+    return;
+  }
+
+  // The temporary isn't used by anything else, so the instruction that made it can write to the variable instead
+  if (last && instruction->arg2->type != CHAR_P && last->a == value && (last->op == BC_CALL || last->op == BC_LOADG || (last->op >= BC_ADD && last->op <= BC_SETGE))) {
+    last->a = local->reg;
+  }
+  else {
+    bytecode_push(program, BC_MOV, local->reg, value, 0);
+  }
+}
+
+/*
+bytecode_func_call starts a function call, it waits for it's parameters and is lowered once the last one is reached
+Input: Lowering state
+Output: None
+*/
+void bytecode_func_call(bc_lowering* lowering) {
+
+  TAC* call = lowering->instruction;
+  long function = bytecode_find_function(lowering->program, call->arg1->value);
+  uint32_t size = atoi(call->arg2->value);
+  bc_call pending = { call, function, size, 0, mcalloc(size + 1, sizeof(uint32_t)) };
+
+  if (function < 0) {
+    printf("[Error]: Function '%s' is not defined", (char*)call->arg1->value); error_exit();
+  }
+
+  if (lowering->program->functions[function].params != size) {
+    printf("[Error]: Function '%s' expects %u arguments", (char*)call->arg1->value, lowering->program->functions[function].params); error_exit();
+  }
+
+  // The parameters can have calls in them, so they are kept on a stack instead of lowering them here
+  vector_push(lowering->calls, lowering->callsSize, lowering->callsCapacity, pending);
+
+  if (!size) {
+    bytecode_end_call(lowering);
+  }
+}
+
+/*
+bytecode_print starts print, each parameter is printed as soon as we reach it
+Input: Lowering state
+Output: None
+*/
+void bytecode_print(bc_lowering* lowering) {
+
+  bc_call pending = { lowering->instruction, -1, atoi(lowering->instruction->arg2->value), 0, NULL };
+
+  if (pending.size) {
+    vector_push(lowering->calls, lowering->callsSize, lowering->callsCapacity, pending);
+  }
+}
+
+/*
+bytecode_param lowers a parameter of the innermost pending call or print
+Input: Lowering state
+Output: None
+*/
+void bytecode_param(bc_lowering* lowering) {
+
+  bc_call* pending = &lowering->calls[lowering->callsSize - 1];
+  arg_T* arg = lowering->instruction->arg1;
+
+  if (pending->function < 0) {
+    bytecode_push(lowering->program, bytecode_is_string(lowering, arg) ? BC_PRINT_STRING : BC_PRINT_INT, bytecode_operand(lowering, arg), 0, 0);
+  }
+  else {
+    pending->params[pending->collected] = bytecode_operand(lowering, arg);
+  }
+
+  if (++pending->collected == pending->size) {
+    bytecode_end_call(lowering);
+  }
+}
+
+/*
+bytecode_end_call lowers the innermost pending call once it has all it's parameters
+The arguments are moved to the call area and the result to a new register
+Input: Lowering state
+Output: None
+*/
+void bytecode_end_call(bc_lowering* lowering) {
+
+  bc_call pending = lowering->calls[--lowering->callsSize];
+
+  if (pending.function < 0) {
+    return;
+  }
+
+  // Parameters come from last to first
+  for (uint32_t i = 0; i < pending.size; i++) {
+    bytecode_push(lowering->program, BC_MOV, BC_CALL_AREA_FLAG | i, pending.params[pending.size - 1 - i], 0);
+  }
+
+  if (pending.size > lowering->callArea) {
+    lowering->callArea = pending.size;
+  }
+
+  bytecode_push(lowering->program, BC_CALL, bytecode_set_temp(lowering, pending.call), (uint32_t)pending.function, BC_CALL_AREA_FLAG);
+
+  mfree(pending.params);
+}
+
+/*
+bytecode_jump adds a jump to a TAC label, the target is filled in once every label is placed
+Input: Lowering state, jump operation, compared registers, TAC label
+Output: None
+*/
+void bytecode_jump(bc_lowering* lowering, uint32_t op, uint32_t a, uint32_t b, TAC* label) {
+
+  size_t jump = bytecode_push(lowering->program, op, a, b, label->label);
+
+  vector_push(lowering->jumps, lowering->jumpsSize, lowering->jumpsCapacity, jump);
+}
+
+/*
+bytecode_patch_jumps fills in the targets of all jumps
+The TAC label number of a jump is kept in c until it's patched, and then moved to the operand of the jump's target
+Input: Lowering state
+Output: None
+*/
+void bytecode_patch_jumps(bc_lowering* lowering) {
+
+  bc_instruction* jump = NULL;
+  uint32_t target = 0;
+
+  for (size_t i = 0; i < lowering->jumpsSize; i++) {
+
+    jump = &lowering->program->code[lowering->jumps[i]];
+    target = lowering->labels[jump->c];
+
+    switch (jump->op) {
+
+      case BC_JMP: jump->a = target; jump->c = 0; break;
+      case BC_JZ:  jump->b = target; jump->c = 0; break;
+      default:     jump->c = target; break;
+    }
+  }
+}
+
+/*
+bytecode_layout places the constants and the call area after the registers the function used, and fixes the operands that refer to them
+Input: Lowering state
+Output: None
+*/
+void bytecode_layout(bc_lowering* lowering) {
+
+  bc_program* program = lowering->program;
+  bc_function* function = lowering->function;
+  uint32_t callBase = 0;
+  uint32_t* operands[3] = { NULL };
+
+  function->constants = lowering->maxRegs;
+  function->size = function->constants + function->poolSize + lowering->callArea;
+  callBase = function->constants + function->poolSize;
+
+  for (size_t i = function->start; i < program->size; i++) {
+
+    operands[0] = &program->code[i].a;
+    operands[1] = &program->code[i].b;
+    operands[2] = &program->code[i].c;
+
+    for (unsigned int i2 = 0; i2 < 3; i2++) {
+
+      if (*operands[i2] & BC_CONSTANT_FLAG) {
+        *operands[i2] = function->constants + (*operands[i2] & ~BC_CONSTANT_FLAG);
+      }
+      else if (*operands[i2] & BC_CALL_AREA_FLAG) {
+        *operands[i2] = callBase + (*operands[i2] & ~BC_CALL_AREA_FLAG);
+      }
+    }
+  }
+}
+
+/*
+bytecode_end_statement frees all temporaries at the end of a statement
+Input: Lowering state
+Output: None
+*/
+void bytecode_end_statement(bc_lowering* lowering) {
+
+  lowering->tempsSize = 0;
+  lowering->statements++;
+  lowering->next = lowering->statement;
+}
+
+/*
+bytecode_push appends an instruction to the program
+Input: Program, operation, operands
+Output: Index of the instruction
+*/
+size_t bytecode_push(bc_program* program, uint32_t op, uint32_t a, uint32_t b, uint32_t c) {
+
+  vector_reserve(program->code, program->capacity, program->size + 1);
+
+  program->code[program->size].op = op;
+  program->code[program->size].a = a;
+  program->code[program->size].b = b;
+  program->code[program->size].c = c;
+
+  return program->size++;
+}
+
+/*
+bytecode_operand returns the register that holds the value of a TAC argument, loading globals into a new register
+Input: Lowering state, argument
+Output: Register
+*/
+uint32_t bytecode_operand(bc_lowering* lowering, arg_T* arg) {
+
+  entry_T* entry = NULL;
+  bc_local* local = NULL;
+  bc_temp* temp = NULL;
+  uint32_t reg = 0;
+
+  if (arg->type == TAC_P || arg->type == TEMP_P) {
+
+    // Instructions without a value (such as print) evaluate to 0
+    return (temp = bytecode_find_temp(lowering, arg->value)) ? temp->reg : bytecode_constant(lowering, 0);
+  }
+
+  if (!(entry = table_search_entry(lowering->table, arg->value))) {
+    return isNum(arg->value) ? bytecode_constant(lowering, atoll(arg->value)) : bytecode_string(lowering, arg->value);
+  }
+
+  if ((local = bytecode_find_local(lowering, entry))) {
+    return local->reg;
+  }
+
+  reg = bytecode_new_register(lowering);
+  bytecode_push(lowering->program, BC_LOADG, reg, (uint32_t)bytecode_find_global(lowering->program, entry->name), 0);
+
+  return reg;
+}
+
+/*
+bytecode_constant returns the register of a constant of the current function, adding it if it's new
+Input: Lowering state, value
+Output: Register of the constant, until the frame layout is done
+*/
+uint32_t bytecode_constant(bc_lowering* lowering, bc_value value) {
+
+  bc_program* program = lowering->program;
+  bc_function* function = lowering->function;
+  bc_constant* constants = lowering->constants;
+  size_t mask = lowering->constantsCapacity - 1;
+  size_t index = 0;
+
+  // Half of the table stays empty so the searches are short, the constants of the function are in it's pool
+  if ((function->poolSize + 1) * 2 > lowering->constantsCapacity) {
+
+    lowering->constantsCapacity = lowering->constantsCapacity ? lowering->constantsCapacity * 2 : BC_INITIAL_SIZE;
+    constants = mcalloc(lowering->constantsCapacity, sizeof(bc_constant));
+    mask = lowering->constantsCapacity - 1;
+
+    for (uint32_t i = 0; i < function->poolSize; i++) {
+
+      for (index = bytecode_hash(program->pool[function->pool + i]) & mask; constants[index].function; index = (index + 1) & mask) { }
+
+      constants[index].value = program->pool[function->pool + i];
+      constants[index].index = i;
+      constants[index].function = lowering->functions;
+    }
+
+    mfree(lowering->constants);
+    lowering->constants = constants;
+  }
+
+  for (index = bytecode_hash(value) & mask; constants[index].function == lowering->functions; index = (index + 1) & mask) {
+
+    if (constants[index].value == value) {
+      return BC_CONSTANT_FLAG | constants[index].index;
+    }
+  }
+
+  constants[index].value = value;
+  constants[index].index = function->poolSize;
+  constants[index].function = lowering->functions;
+
+  vector_push(program->pool, program->poolSize, program->poolCapacity, value);
+
+  return BC_CONSTANT_FLAG | function->poolSize++;
+}
+
+/*
+bytecode_add_string adds a string literal to the program, the value of a string is it's index in the program's strings
+Input: Program, literal as written in the source code
+Output: Value of the string
+*/
+bc_value bytecode_add_string(bc_program* program, char* literal) {
+
+  size_t size = 0;
+
+  vector_reserve(program->strings, program->stringsCapacity, program->stringsSize + 1);
+  program->strings[program->stringsSize] = x64_decode_string(literal, &size);
+
+  return (bc_value)program->stringsSize++;
+}
+
+/*
+bytecode_string returns the register of a string literal used by the current function
+Input: Lowering state, literal
+Output: Register of the constant
+*/
+uint32_t bytecode_string(bc_lowering* lowering, char* literal) {
+  return bytecode_constant(lowering, bytecode_add_string(lowering->program, literal));
+}
+
+/*
+bytecode_new_register allocates a register of the current frame
+Input: Lowering state
+Output: Register
+*/
+uint32_t bytecode_new_register(bc_lowering* lowering) {
+
+  uint32_t reg = lowering->next++;
+
+  if (lowering->next > lowering->maxRegs) {
+    lowering->maxRegs = lowering->next;
+  }
+
+  return reg;
+}
+
+/*
+bytecode_set_temp allocates a register for the result of an instruction
+Input: Lowering state, instruction
+Output: Register
+*/
+uint32_t bytecode_set_temp(bc_lowering* lowering, TAC* instruction) {
+
+  bc_temp* temps = lowering->temps;
+  size_t mask = lowering->tempsCapacity - 1;
+  size_t index = 0;
+
+  // Half of the table stays empty so the searches are short, only the temporaries of the statement move to the bigger table
+  if ((lowering->tempsSize + 1) * 2 > lowering->tempsCapacity) {
+
+    lowering->tempsCapacity = lowering->tempsCapacity ? lowering->tempsCapacity * 2 : BC_INITIAL_SIZE;
+    lowering->temps = mcalloc(lowering->tempsCapacity, sizeof(bc_temp));
+
+    for (size_t i = 0; i <= mask && temps; i++) {
+
+      if (temps[i].statement != lowering->statements) { continue; }
+
+      for (index = bytecode_hash((uintptr_t)temps[i].tac >> 4) & (lowering->tempsCapacity - 1); lowering->temps[index].statement;
+        index = (index + 1) & (lowering->tempsCapacity - 1)) { }
+
+      lowering->temps[index] = temps[i];
+    }
+
+    mfree(temps);
+    temps = lowering->temps;
+    mask = lowering->tempsCapacity - 1;
+  }
+
+  for (index = bytecode_hash((uintptr_t)instruction >> 4) & mask; temps[index].statement == lowering->statements; index = (index + 1) & mask) { }
+
+  temps[index].tac = instruction;
+  temps[index].reg = bytecode_new_register(lowering);
+  temps[index].statement = lowering->statements;
+  lowering->tempsSize++;
+
+  return temps[index].reg;
+}
+
+/*
+bytecode_release frees the register of an operand that was used up, if it's the last register that was taken.
+The registers before the first free register of the statement belong to local variables
+Input: Lowering state, register
+Output: None
+*/
+void bytecode_release(bc_lowering* lowering, uint32_t reg) {
+
+  if (reg + 1 == lowering->next && reg >= lowering->statement) {
+    lowering->next--;
+  }
+}
+
+/*
+bytecode_find_local searches the register of a local variable
+Input: Lowering state, symbol table entry
+Output: Local, NULL if it's a global variable
+*/
+bc_local* bytecode_find_local(bc_lowering* lowering, entry_T* entry) {
+
+  for (size_t i = 0; i < lowering->localsSize; i++) {
+
+    if (lowering->locals[i].entry == entry) {
+      return &lowering->locals[i];
+    }
+  }
+
+  return NULL;
+}
+
+/*
+bytecode_find_temp searches the register of the result of an instruction in the current statement
+Input: Lowering state, instruction
+Output: Temporary, NULL if the instruction has no value
+*/
+bc_temp* bytecode_find_temp(bc_lowering* lowering, TAC* instruction) {
+
+  size_t mask = lowering->tempsCapacity - 1;
+
+  if (!lowering->tempsCapacity) { return NULL; }
+
+  for (size_t index = bytecode_hash((uintptr_t)instruction >> 4) & mask; lowering->temps[index].statement == lowering->statements; index = (index + 1) & mask) {
+
+    if (lowering->temps[index].tac == instruction) {
+      return &lowering->temps[index];
+    }
+  }
+
+  return NULL;
+}
+
+/*
+bytecode_find_global and bytecode_find_function search a global variable or a function by name
+Input: Program, name
+Output: Index, -1 if it doesn't exist
+*/
+long bytecode_find_global(bc_program* program, char* name) {
+
+  for (size_t i = 0; i < program->globalsSize; i++) {
+
+    if (!strcmp(program->globalNames[i], name)) {
+      return (long)i;
+    }
+  }
+
+  return -1;
+}
+
+long bytecode_find_function(bc_program* program, char* name) {
+
+  for (size_t i = 0; i < program->functionsSize; i++) {
+
+    if (!strcmp(program->functions[i].name, name)) {
+      return (long)i;
+    }
+  }
+
+  return -1;
+}
+
+/*
+bytecode_is_string checks if a print parameter is a string
+Input: Lowering state, argument
+Output: True if it's a string variable or a string literal
+*/
+bool bytecode_is_string(bc_lowering* lowering, arg_T* arg) {
+
+  entry_T* entry = NULL;
+
+  if (arg->type != CHAR_P) { return false; }
+
+  entry = table_search_entry(lowering->table, arg->value);
+
+  return entry ? entry->dtype == DATA_STRING : !isNum(arg->value);
+}
+
+/*
+bytecode_free_program frees a bytecode program
+Input: Program
+Output: None
+*/
+void bytecode_free_program(bc_program* program) {
+
+  for (size_t i = 0; i < program->stringsSize; i++) {
+    mfree(program->strings[i]);
+  }
+
+  mfree(program->code);
+  mfree(program->functions);
+  mfree(program->pool);
+  mfree(program->globals);
+  mfree(program->globalNames);
+  mfree(program->strings);
+  mfree(program);
+}
@@ -0,0 +1,216 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+#include "TAC.h"
+
+// Operands that are only known once the frame layout of the function is done
+#define BC_CONSTANT_FLAG 0x80000000u     // A constant of the function
+#define BC_CALL_AREA_FLAG 0x40000000u    // A register of the call area
+#define BC_NO_LABEL UINT32_MAX
+
+typedef int64_t bc_value;
+
+typedef enum BC_OP_ENUM {
+
+  BC_MOV,            // a = b
+  BC_LOADG,          // a = global b
+  BC_STOREG,         // global a = b
+  BC_ADD,            // a = b + c
+  BC_SUB,
+  BC_MUL,
+  BC_DIV,
+  BC_SHL,
+  BC_SHR,            // Arithmetic shift, the sign stays
+  BC_AND,
+  BC_OR,
+  BC_XOR,
+  BC_SETE,           // a = b == c, 1 or 0
+  BC_SETNE,
+  BC_SETL,
+  BC_SETLE,
+  BC_SETG,
+  BC_SETGE,
+  BC_JMP,            // Jump to a
+  BC_JZ,             // Jump to b if a is 0
+  BC_JE,             // Jump to c if a == b
+  BC_JNE,
+  BC_JL,
+  BC_JLE,
+  BC_JG,
+  BC_JGE,
+  BC_CALL,           // a = call function b, it's arguments are in the call area of the frame
+  BC_RET,            // Return a
+  BC_PRINT_INT,      // Print a as a number
+  BC_PRINT_STRING,   // Print the string a points to
+  BC_OP_AMOUNT
+
+} bc_op;
+
+/*
+Every operand is a register of the current frame, so the interpreter never has to decode operand kinds
+A frame is laid out as [parameters][locals and temporaries][constants][call area],
+the call area is where the arguments of a call are placed, and it becomes the start of the callee's frame
+*/
+typedef struct BC_INSTRUCTION_STRUCT {
+
+  uint32_t op;
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+
+} bc_instruction;
+
+typedef struct BC_FUNCTION_STRUCT {
+
+  char* name;
+  size_t start;         // Index of the first instruction
+
+  uint32_t params;
+  uint32_t constants;   // First constant register
+  uint32_t size;        // Amount of registers in the frame, including the call area
+
+  size_t pool;          // Index of the function's constants in the program's constant pool
+  uint32_t poolSize;
+
+} bc_function;
+
+typedef struct BC_PROGRAM_STRUCT {
+
+  bc_instruction* code;
+  size_t size;
+  size_t capacity;
+
+  bc_function* functions;
+  size_t functionsSize;
+  size_t functionsCapacity;
+
+  bc_value* pool;       // Constants of every function, copied into a frame when it's created
+  size_t poolSize;
+  size_t poolCapacity;
+
+  bc_value* globals;
+  char** globalNames;
+  size_t globalsSize;
+  size_t globalsCapacity;
+  size_t globalNamesCapacity;
+
+  char** strings;       // Decoded string literals, the constants of strings point to them
+  size_t stringsSize;
+  size_t stringsCapacity;
+
+  uint32_t main;
+
+} bc_program;
+
+/* A local variable and the register it lives in */
+typedef struct BC_LOCAL_STRUCT {
+
+  entry_T* entry;
+  uint32_t reg;
+
+} bc_local;
+
+/* The result of a TAC instruction and the register it is in */
+typedef struct BC_TEMP_STRUCT {
+
+  TAC* tac;
+  uint32_t reg;
+  uint32_t statement;   // Statement the temporary belongs to, the slots of earlier statements are free
+
+} bc_temp;
+
+/* A constant of a function and it's index in the function's constants */
+typedef struct BC_CONSTANT_STRUCT {
+
+  bc_value value;
+  uint32_t index;
+  uint32_t function;    // Function the constant belongs to, the slots of earlier functions are free
+
+} bc_constant;
+
+/* A call or print whose parameters are still being lowered, calls in it's parameters are pending on top of it */
+typedef struct BC_CALL_STRUCT {
+
+  TAC* call;
+  long function;        // -1 for print
+  uint32_t size;
+  uint32_t collected;   // Parameters that were lowered so far
+  uint32_t* params;
+
+} bc_call;
+
+typedef struct BC_LOWERING_STRUCT {
+
+  bc_program* program;
+  bc_function* function;
+  table_T* table;
+  TAC* instruction;
+
+  bc_call* calls;         // Calls that wait for their parameters, the innermost one is last
+  size_t callsSize;
+  size_t callsCapacity;
+
+  uint32_t* labels;       // Instruction index of every TAC label
+  size_t* jumps;          // Instructions that jump to a TAC label, patched at the end
+  size_t jumpsSize;
+  size_t jumpsCapacity;
+
+  bc_local* locals;
+  size_t localsSize;
+  size_t localsCapacity;
+
+  // Hash tables with linear probing and sizes that are powers of 2, they are emptied by moving to the next statement or function
+  bc_temp* temps;
+  size_t tempsSize;       // Temporaries of the current statement
+  size_t tempsCapacity;
+  uint32_t statements;    // Number of the current statement
+
+  bc_constant* constants;
+  size_t constantsCapacity;
+  uint32_t functions;     // Number of the current function
+
+  uint32_t next;          // Next free register
+  uint32_t statement;     // First register that is free at the start of a statement
+  uint32_t maxRegs;
+  uint32_t callArea;      // Biggest amount of arguments the function passes
+
+} bc_lowering;
+
+bc_program* bytecode_lower(table_T* table, TAC_list* list);
+
+void bytecode_function(bc_lowering* lowering);
+void bytecode_global_var(bc_lowering* lowering);
+void bytecode_instruction(bc_lowering* lowering);
+void bytecode_binop(bc_lowering* lowering, int op);
+void bytecode_compare(bc_lowering* lowering, int op);
+void bytecode_if_false(bc_lowering* lowering);
+void bytecode_assignment(bc_lowering* lowering);
+void bytecode_func_call(bc_lowering* lowering);
+void bytecode_print(bc_lowering* lowering);
+void bytecode_param(bc_lowering* lowering);
+void bytecode_end_call(bc_lowering* lowering);
+void bytecode_jump(bc_lowering* lowering, uint32_t op, uint32_t a, uint32_t b, TAC* label);
+void bytecode_end_statement(bc_lowering* lowering);
+void bytecode_layout(bc_lowering* lowering);
+void bytecode_patch_jumps(bc_lowering* lowering);
+void bytecode_free_program(bc_program* program);
+
+size_t bytecode_push(bc_program* program, uint32_t op, uint32_t a, uint32_t b, uint32_t c);
+
+uint32_t bytecode_operand(bc_lowering* lowering, arg_T* arg);
+uint32_t bytecode_constant(bc_lowering* lowering, bc_value value);
+uint32_t bytecode_string(bc_lowering* lowering, char* literal);
+uint32_t bytecode_new_register(bc_lowering* lowering);
+uint32_t bytecode_set_temp(bc_lowering* lowering, TAC* instruction);
+void bytecode_release(bc_lowering* lowering, uint32_t reg);
+
+bc_value bytecode_add_string(bc_program* program, char* literal);
+
+bc_local* bytecode_find_local(bc_lowering* lowering, entry_T* entry);
+bc_temp* bytecode_find_temp(bc_lowering* lowering, TAC* instruction);
+
+long bytecode_find_global(bc_program* program, char* name);
+long bytecode_find_function(bc_program* program, char* name);
+
+bool bytecode_is_string(bc_lowering* lowering, arg_T* arg);
+
+#endif
@@ -0,0 +1,657 @@
+#include "cache.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define CACHE_MAP_INITIAL_SIZE 256
+
+/*
+cache_load loads the cache file of a source file if it was made from the same source code
+Input: Cache filename, hash of the current source code
+Output: Loaded cache, NULL if there is no valid cache for this source code
+*/
+cache_T* cache_load(char* filename, uint64_t hash) {
+
+  FILE* file = fopen(filename, "rb");
+  cache_T* cache = NULL;
+  cache_header header;
+  long size = 0;
+
+  if (!file) { return NULL; }
+
+  // Check the header before reading the rest of the file
+  if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, CACHE_MAGIC, 4) || header.version != CACHE_VERSION || header.hash != hash) {
+    fclose(file);
+    return NULL;
+  }
+
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+
+  cache = mcalloc(1, sizeof(cache_T));
+  cache->header = header;
+  cache->size = (size_t)size;
+
+#ifndef _WIN32
+  // Map the file instead of reading it, the strings are used right where they are
+  cache->data = mmap(NULL, cache->size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+  cache->mapped = cache->data != MAP_FAILED;
+#endif
+
+  if (!cache->mapped) {
+    cache->data = mcalloc(1, cache->size);
+    fseek(file, 0, SEEK_SET);
+
+    if (fread(cache->data, 1, cache->size, file) != cache->size) {
+      cache->size = 0;
+    }
+  }
+
+  fclose(file);
+
+  if (!cache_build(cache)) {
+    cache_free(cache);
+    return NULL;
+  }
+
+  return cache;
+}
+
+/*
+cache_build rebuilds the TAC list and the symbol tables from a loaded cache file
+Input: Cache
+Output: False if the file is damaged
+*/
+bool cache_build(cache_T* cache) {
+
+  cache_header* header = &cache->header;
+  char* strings = cache->data + sizeof(cache_header);
+  cache_tac* tacs = (cache_tac*)(strings + header->stringsSize);
+  cache_table* tables = (cache_table*)(tacs + header->tacSize);
+  cache_entry* entries = (cache_entry*)(tables + header->tablesSize);
+
+  table_T* table = NULL;
+  arg_T* arg = NULL;
+  size_t nested = 0;
+
+  if ((char*)(entries + header->entriesSize) > cache->data + cache->size || !header->tablesSize) {
+    return false;
+  }
+
+  cache->tacs = mcalloc(header->tacSize + 1, sizeof(TAC));
+  cache->args = mcalloc(header->tacSize * 2 + 1, sizeof(arg_T));
+  cache->tables = mcalloc(header->tablesSize, sizeof(table_T));
+  cache->entries = mcalloc(header->entriesSize + 1, sizeof(entry_T));
+  cache->entryPointers = mcalloc(header->entriesSize + 1, sizeof(entry_T*));
+  cache->nestedPointers = mcalloc(header->tablesSize, sizeof(table_T*));
+
+  for (uint32_t i = 0; i < header->tacSize; i++) {
+
+    cache->tacs[i].op = tacs[i].op;
+    cache->tacs[i].label = tacs[i].label;
+    cache->tacs[i].next = i + 1 < header->tacSize ? &cache->tacs[i + 1] : NULL;
+
+    for (unsigned int i2 = 0; i2 < 2; i2++) {
+
+      if (tacs[i].types[i2] == CACHE_NO_ARG) { continue; }
+
+      arg = &cache->args[i * 2 + i2];
+      arg->type = tacs[i].types[i2];
+
+      if (tacs[i].args[i2] == CACHE_NONE) {
+        arg->value = NULL;
+      }
+      else if (arg->type == CHAR_P && tacs[i].args[i2] < header->stringsSize) {
+        arg->value = strings + tacs[i].args[i2];
+      }
+      else if (arg->type != CHAR_P && tacs[i].args[i2] < header->tacSize) {
+        arg->value = &cache->tacs[tacs[i].args[i2]];
+      }
+      else {
+        return false;
+      }
+
+      i2 ? (cache->tacs[i].arg2 = arg) : (cache->tacs[i].arg1 = arg);
+    }
+  }
+
+  for (uint32_t i = 0; i < header->entriesSize; i++) {
+
+    if (entries[i].name >= header->stringsSize || (entries[i].value != CACHE_NONE && entries[i].value >= header->stringsSize)) {
+      return false;
+    }
+
+    cache->entries[i].name = strings + entries[i].name;
+    cache->entries[i].value = entries[i].value == CACHE_NONE ? NULL : strings + entries[i].value;
+    cache->entries[i].dtype = entries[i].dtype;
+    cache->entries[i].addressDesc = mcalloc(1, sizeof(address_T*));    // Code generation grows it like any other entry
+
+    cache->entryPointers[i] = &cache->entries[i];
+  }
+
+  // Every table gets a slice of the pointer arrays, and adds itself to it's parent's nested scopes in order
+  for (uint32_t i = 0; i < header->tablesSize; i++) {
+
+    table = &cache->tables[i];
+
+    if (tables[i].entries + (size_t)tables[i].entrySize > header->entriesSize || (i && tables[i].parent >= i) || nested + tables[i].nestedSize > header->tablesSize) {
+      return false;
+    }
+
+    table->entries = cache->entryPointers + tables[i].entries;
+    table->nestedScopes = cache->nestedPointers + nested;
+    nested += tables[i].nestedSize;
+
+    if (i) {
+      table->prev = &cache->tables[tables[i].parent];
+      table->prev->nestedScopes[table->prev->nestedSize++] = table;
+    }
+  }
+
+  for (uint32_t i = 0; i < header->tablesSize; i++) {
+
+    if (cache->tables[i].nestedSize != tables[i].nestedSize) {
+      return false;
+    }
+
+    cache->tables[i].entrySize = tables[i].entrySize;
+  }
+
+  cache->table = &cache->tables[0];
+  cache->list = mcalloc(1, sizeof(TAC_list));
+  cache->list->head = header->tacSize ? &cache->tacs[0] : NULL;
+  cache->list->last = header->tacSize ? &cache->tacs[header->tacSize - 1] : NULL;
+  cache->list->size = header->tacSize;
+  cache->list->labels = header->labels;
+
+  return true;
+}
+
+/*
+cache_write writes the TAC list and the symbol tables of a source file to it's cache file
+Input: Cache filename, hash of the source code, root symbol table, TAC list
+Output: None
+*/
+void cache_write(char* filename, uint64_t hash, table_T* table, TAC_list* list) {
+
+  FILE* file = NULL;
+  cache_header header;
+  cache_tac record;
+  arg_T* arg = NULL;
+
+  emitter_T* strings = init_emitter(NULL);
+  emitter_T* tacs = init_emitter(NULL);
+  emitter_T* tables = init_emitter(NULL);
+  emitter_T* entries = init_emitter(NULL);
+
+  cache_map stringMap = { 0 };
+  cache_map tacMap = { 0 };
+  uint32_t tacCount = 0;
+  uint32_t tableCount = 0;
+  uint32_t entryCount = 0;
+  bool valid = true;
+
+  // Number the instructions first, arguments can point forward
+  for (TAC* instruction = list->head; instruction; instruction = instruction->next) {
+    cache_map_add(&tacMap, instruction, tacCount++, false);
+  }
+
+  for (TAC* instruction = list->head; instruction && valid; instruction = instruction->next) {
+
+    memset(&record, 0, sizeof(record));
+    record.op = instruction->op;
+    record.label = instruction->label;
+
+    for (unsigned int i = 0; i < 2; i++) {
+
+      arg = i ? instruction->arg2 : instruction->arg1;
+
+      record.types[i] = arg ? (int32_t)arg->type : CACHE_NO_ARG;
+      record.args[i] = CACHE_NONE;
+
+      if (!arg || !arg->value) { continue; }
+
+      record.args[i] = arg->type == CHAR_P ? cache_string(strings, &stringMap, arg->value) : cache_map_find(&tacMap, arg->value, false);
+
+      // An argument that points outside of the list can't be stored
+      if (record.args[i] == CACHE_NONE) {
+        valid = false;
+      }
+    }
+
+    emit_bytes(tacs, (char*)&record, sizeof(record));
+  }
+
+  cache_write_table(table, CACHE_NONE, tables, entries, strings, &stringMap, &tableCount, &entryCount);
+
+  while (strings->size % CACHE_ALIGNMENT) {
+    emit_char(strings, '\0');
+  }
+
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CACHE_MAGIC, 4);
+  header.version = CACHE_VERSION;
+  header.hash = hash;
+  header.stringsSize = (uint32_t)strings->size;
+  header.tacSize = tacCount;
+  header.tablesSize = tableCount;
+  header.entriesSize = entryCount;
+  header.labels = list->labels;
+
+  if (valid && (file = fopen(filename, "wb"))) {
+
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(strings->buffer, 1, strings->size, file);
+    fwrite(tacs->buffer, 1, tacs->size, file);
+    fwrite(tables->buffer, 1, tables->size, file);
+    fwrite(entries->buffer, 1, entries->size, file);
+
+    fclose(file);
+  }
+
+  emitter_free(strings);
+  emitter_free(tacs);
+  emitter_free(tables);
+  emitter_free(entries);
+
+  mfree(stringMap.keys);
+  mfree(stringMap.values);
+  mfree(tacMap.keys);
+  mfree(tacMap.values);
+}
+
+/*
+cache_write_table writes a table and then all of it's nested scopes in pre-order
+Input: Table, index of it's parent, output for the tables, entries and strings, string map, counters of tables and entries
+Output: None
+*/
+void cache_write_table(table_T* table, uint32_t parent, emitter_T* tables, emitter_T* entries, emitter_T* strings, cache_map* map, uint32_t* tableCount, uint32_t* entryCount) {
+
+  cache_table record;
+  cache_entry entry;
+  uint32_t index = (*tableCount)++;
+
+  record.parent = parent;
+  record.entries = *entryCount;
+  record.entrySize = (uint32_t)table->entrySize;
+  record.nestedSize = (uint32_t)table->nestedSize;
+
+  emit_bytes(tables, (char*)&record, sizeof(record));
+
+  for (size_t i = 0; i < table->entrySize; i++) {
+
+    entry.name = cache_string(strings, map, table->entries[i]->name);
+    entry.value = table->entries[i]->value ? cache_string(strings, map, table->entries[i]->value) : CACHE_NONE;
+    entry.dtype = table->entries[i]->dtype;
+
+    emit_bytes(entries, (char*)&entry, sizeof(entry));
+    (*entryCount)++;
+  }
+
+  for (size_t i = 0; i < table->nestedSize; i++) {
+    cache_write_table(table->nestedScopes[i], index, tables, entries, strings, map, tableCount, entryCount);
+  }
+}
+
+/*
+cache_compare_fragments orders fragments by their hash, for qsort and bsearch
+Input: Two fragments
+Output: Negative, zero or positive like strcmp
+*/
+static int cache_compare_fragments(const void* first, const void* second) {
+
+  uint64_t hash1 = ((const cache_fragment*)first)->hash;
+  uint64_t hash2 = ((const cache_fragment*)second)->hash;
+
+  return (hash1 > hash2) - (hash1 < hash2);
+}
+
+/*
+cache_functions_load loads the generated code of the functions of the last compilation
+Input: Filename of the function cache, root symbol table
+Output: Function cache, empty if the file doesn't exist or is damaged
+*/
+cache_functions* cache_functions_load(char* filename, table_T* table) {
+
+  cache_functions* functions = mcalloc(1, sizeof(cache_functions));
+  FILE* file = fopen(filename, "rb");
+  cache_fragment fragment;
+  uint32_t version = 0;
+  size_t capacity = 0;
+  size_t position = 0;
+  long size = 0;
+
+  functions->filename = filename;
+  functions->written = init_emitter(NULL);
+  functions->globals = init_emitter(NULL);
+
+  // Every function can use the global symbols, so they are a part of every hash
+  cache_key_table(functions->globals, table, false);
+
+  if (!file) { return functions; }
+
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  functions->data = mcalloc(1, size > 0 ? (size_t)size : 1);
+
+  if (size < 8 || fread(functions->data, 1, (size_t)size, file) != (size_t)size || memcmp(functions->data, CACHE_FUNCTIONS_MAGIC, 4)) {
+    fclose(file);
+    return functions;
+  }
+
+  fclose(file);
+  memcpy(&version, functions->data + 4, sizeof(version));
+
+  if (version != CACHE_FUNCTIONS_VERSION) { return functions; }
+
+  for (position = 8; position + sizeof(fragment) <= (size_t)size; position += sizeof(fragment) + (size_t)fragment.size) {
+
+    memcpy(&fragment, functions->data + position, sizeof(fragment));
+
+    if (fragment.size > (size_t)size - position - sizeof(fragment)) { break; }
+
+    fragment.offset = position + sizeof(fragment);
+
+    vector_push(functions->fragments, functions->size, capacity, fragment);
+  }
+
+  qsort(functions->fragments, functions->size, sizeof(cache_fragment), cache_compare_fragments);
+
+  return functions;
+}
+
+/*
+cache_function_hash hashes everything the generated code of a function depends on: it's instructions,
+it's symbol tables and the global symbols, which include the functions it can call
+Input: Function cache, scratch memory of the calling thread, symbol table of the function, AST_FUNCTION instruction of the function
+Output: Hash
+*/
+uint64_t cache_function_hash(cache_functions* functions, cache_key* scratch, table_T* table, TAC* function) {
+
+  emitter_T* key = NULL;
+  TAC* instruction = function;
+  arg_T* arg = NULL;
+  uint32_t index = 0;
+  uint32_t label = 0;
+  int32_t type = 0;
+
+  if (!scratch->bytes) {
+    scratch->bytes = init_emitter(NULL);
+  }
+
+  key = scratch->bytes;
+  key->size = 0;
+  emit_bytes(key, functions->globals->buffer, functions->globals->size);
+
+  if (scratch->tacs.capacity) {
+    memset(scratch->tacs.keys, 0, scratch->tacs.capacity * sizeof(void*));
+    scratch->tacs.size = 0;
+  }
+
+  // Arguments are hashed by the index of the instruction they point to in the function, not by it's address
+  for (instruction = function; instruction; instruction = instruction->next) {
+
+    cache_map_add(&scratch->tacs, instruction, index++, false);
+
+    if (instruction->op == TOKEN_FUNC_END) { break; }
+  }
+
+  // Labels are hashed by their number in the function, so the labels of other functions don't change the hash
+  for (instruction = function; instruction; instruction = instruction->next) {
+
+    label = instruction->label ? instruction->label - function->label : 0;
+
+    emit_bytes(key, (char*)&instruction->op, sizeof(instruction->op));
+    emit_bytes(key, (char*)&label, sizeof(label));
+
+    for (unsigned int i = 0; i < 2; i++) {
+
+      arg = i ? instruction->arg2 : instruction->arg1;
+      type = arg ? (int32_t)arg->type : CACHE_NO_ARG;
+
+      emit_bytes(key, (char*)&type, sizeof(type));
+
+      if (!arg) { continue; }
+
+      if (arg->type == CHAR_P && arg->value) {
+        emit_bytes(key, arg->value, strlen(arg->value) + 1);
+      }
+      else {
+        index = arg->value ? cache_map_find(&scratch->tacs, arg->value, false) : CACHE_NONE;
+        emit_bytes(key, (char*)&index, sizeof(index));
+      }
+    }
+
+    if (instruction->op == TOKEN_FUNC_END) { break; }
+  }
+
+  cache_key_table(key, table, true);
+
+  return hash_bytes(key->buffer, key->size);
+}
+
+/*
+cache_key_table adds the names and types of the entries of a table to the bytes that are hashed
+Input: Key buffer, table, true to add the nested scopes of the table too
+Output: None
+*/
+void cache_key_table(emitter_T* key, table_T* table, bool nested) {
+
+  uint64_t size = table->entrySize;
+
+  emit_bytes(key, (char*)&size, sizeof(size));
+
+  for (size_t i = 0; i < table->entrySize; i++) {
+    emit_bytes(key, table->entries[i]->name, strlen(table->entries[i]->name) + 1);
+    emit_bytes(key, (char*)&table->entries[i]->dtype, sizeof(table->entries[i]->dtype));
+  }
+
+  size = nested ? table->nestedSize : 0;
+  emit_bytes(key, (char*)&size, sizeof(size));
+
+  for (size_t i = 0; i < size; i++) {
+    cache_key_table(key, table->nestedScopes[i], true);
+  }
+}
+
+/*
+cache_functions_find searches the code of a function in the loaded file
+Input: Function cache, hash of the function, pointer to store the size of the code in
+Output: The code, NULL if the function wasn't in the file
+*/
+char* cache_functions_find(cache_functions* functions, uint64_t hash, size_t* size) {
+
+  cache_fragment target = { 0 };
+  cache_fragment* fragment = NULL;
+
+  target.hash = hash;
+  fragment = functions->size ? bsearch(&target, functions->fragments, functions->size, sizeof(cache_fragment), cache_compare_fragments) : NULL;
+
+  if (!fragment) { return NULL; }
+
+  *size = (size_t)fragment->size;
+  return functions->data + fragment->offset;
+}
+
+/*
+cache_functions_add adds the code of a function to the file that is written at the end of the compilation
+Input: Function cache, hash of the function, code, size of the code
+Output: None
+*/
+void cache_functions_add(cache_functions* functions, uint64_t hash, const char* code, size_t size) {
+
+  cache_fragment fragment = { 0 };
+
+  fragment.hash = hash;
+  fragment.size = size;
+
+  emit_bytes(functions->written, (char*)&fragment, sizeof(fragment));
+  emit_bytes(functions->written, code, size);
+}
+
+/*
+cache_functions_write writes the functions of this compilation over the old file, and frees the function cache
+Input: Function cache
+Output: None
+*/
+void cache_functions_write(cache_functions* functions) {
+
+  FILE* file = fopen(functions->filename, "wb");
+  uint32_t version = CACHE_FUNCTIONS_VERSION;
+
+  if (file) {
+
+    fwrite(CACHE_FUNCTIONS_MAGIC, 1, 4, file);
+    fwrite(&version, sizeof(version), 1, file);
+    fwrite(functions->written->buffer, 1, functions->written->size, file);
+
+    fclose(file);
+  }
+
+  emitter_free(functions->written);
+  emitter_free(functions->globals);
+
+  mfree(functions->fragments);
+  mfree(functions->data);
+  mfree(functions);
+}
+
+/*
+cache_key_free frees the scratch memory of a thread that hashed functions
+Input: Scratch memory
+Output: None
+*/
+void cache_key_free(cache_key* key) {
+
+  if (key->bytes) {
+    emitter_free(key->bytes);
+  }
+
+  mfree(key->tacs.keys);
+  mfree(key->tacs.values);
+}
+
+/*
+cache_string returns the offset of a string in the strings block, adding it if it isn't there yet
+Input: Strings block, string map, string
+Output: Offset
+*/
+uint32_t cache_string(emitter_T* strings, cache_map* map, char* string) {
+
+  uint32_t offset = cache_map_find(map, string, true);
+
+  if (offset != CACHE_NONE) { return offset; }
+
+  offset = (uint32_t)strings->size;
+  emit_bytes(strings, string, strlen(string) + 1);
+  cache_map_add(map, string, offset, true);
+
+  return offset;
+}
+
+/*
+cache_map_hash hashes a key of a map, strings by their contents and other keys by their address
+Input: Key, true if the key is a string
+Output: Hash
+*/
+static size_t cache_map_hash(const void* key, bool string) {
+  return (size_t)(string ? hash_bytes(key, strlen(key)) : hash_bytes(&key, sizeof(key)));
+}
+
+/*
+cache_map_find searches a key in a map
+Input: Map, key, true if the key is a string
+Output: Value of the key, CACHE_NONE if it's not in the map
+*/
+uint32_t cache_map_find(cache_map* map, const void* key, bool string) {
+
+  size_t i = 0;
+
+  if (!map->capacity) { return CACHE_NONE; }
+
+  for (i = cache_map_hash(key, string) & (map->capacity - 1); map->keys[i]; i = (i + 1) & (map->capacity - 1)) {
+
+    if (string ? !strcmp(map->keys[i], key) : map->keys[i] == key) {
+      return map->values[i];
+    }
+  }
+
+  return CACHE_NONE;
+}
+
+/*
+cache_map_add adds a key to a map, growing it when it gets half full
+Input: Map, key, value, true if the key is a string
+Output: None
+*/
+void cache_map_add(cache_map* map, const void* key, uint32_t value, bool string) {
+
+  cache_map old = *map;
+  size_t i = 0;
+
+  if ((map->size + 1) * 2 > map->capacity) {
+
+    map->capacity = map->capacity ? map->capacity * 2 : CACHE_MAP_INITIAL_SIZE;
+    map->keys = mcalloc(map->capacity, sizeof(void*));
+    map->values = mcalloc(map->capacity, sizeof(uint32_t));
+    map->size = 0;
+
+    for (size_t i2 = 0; i2 < old.capacity; i2++) {
+
+      if (old.keys[i2]) {
+        cache_map_add(map, old.keys[i2], old.values[i2], string);
+      }
+    }
+
+    mfree(old.keys);
+    mfree(old.values);
+  }
+
+  for (i = cache_map_hash(key, string) & (map->capacity - 1); map->keys[i]; i = (i + 1) & (map->capacity - 1)) { }
+
+  map->keys[i] = key;
+  map->values[i] = value;
+  map->size++;
+}
+
+/*
+cache_free frees a loaded cache, including the TAC list and the symbol tables that were built from it
+Input: Cache
+Output: None
+*/
+void cache_free(cache_T* cache) {
+
+  for (uint32_t i = 0; cache->entries && i < cache->header.entriesSize; i++) {
+
+    for (size_t i2 = 0; i2 < cache->entries[i].size; i2++) {
+      mfree(cache->entries[i].addressDesc[i2]);
+    }
+
+    mfree(cache->entries[i].addressDesc);
+  }
+
+#ifndef _WIN32
+  if (cache->mapped) {
+    munmap(cache->data, cache->size);
+  }
+#endif
+
+  if (!cache->mapped) {
+    mfree(cache->data);
+  }
+
+  mfree(cache->tacs);
+  mfree(cache->args);
+  mfree(cache->tables);
+  mfree(cache->entries);
+  mfree(cache->entryPointers);
+  mfree(cache->nestedPointers);
+  mfree(cache->list);
+  mfree(cache);
+}
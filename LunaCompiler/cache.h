@@ -0,0 +1,148 @@
+#ifndef CACHE_H
+#define CACHE_H
+#include "TAC.h"
+#include "emitter.h"
+
+#define CACHE_MAGIC "LUNC"
+#define CACHE_VERSION 5
+#define CACHE_NONE UINT32_MAX
+#define CACHE_NO_ARG -1
+#define CACHE_ALIGNMENT 8
+
+#define CACHE_FUNCTIONS_MAGIC "LUNF"
+#define CACHE_FUNCTIONS_VERSION 5
+
+/*
+A .lunac file holds the TAC list and the symbol tables of a source file, so an unchanged file can skip the lexer, parser and traversal
+Layout: [header][strings][instructions][tables][entries], strings are referenced by their offset in the strings block,
+instructions and tables by their index
+*/
+typedef struct CACHE_HEADER_STRUCT {
+
+  char magic[4];
+  uint32_t version;
+  uint64_t hash;          // Hash of the source code the file was made from
+
+  uint32_t stringsSize;   // Bytes, padded to CACHE_ALIGNMENT
+  uint32_t tacSize;
+  uint32_t tablesSize;
+  uint32_t entriesSize;
+  uint32_t labels;
+  uint32_t reserved;
+
+} cache_header;
+
+typedef struct CACHE_TAC_STRUCT {
+
+  int32_t op;
+  uint32_t label;
+  uint32_t args[2];       // String offset or instruction index, CACHE_NONE for a NULL value
+  int32_t types[2];       // Argument types, CACHE_NO_ARG for no argument
+
+} cache_tac;
+
+/* Tables are stored in pre-order, so a table's nested scopes always come after it in the order they were made */
+typedef struct CACHE_TABLE_STRUCT {
+
+  uint32_t parent;
+  uint32_t entries;       // Index of the table's first entry
+  uint32_t entrySize;
+  uint32_t nestedSize;
+
+} cache_table;
+
+typedef struct CACHE_ENTRY_STRUCT {
+
+  uint32_t name;
+  uint32_t value;
+  int32_t dtype;
+
+} cache_entry;
+
+/* A loaded cache file, it's strings point straight into the file's memory */
+typedef struct CACHE_STRUCT {
+
+  char* data;
+  size_t size;
+  bool mapped;
+
+  TAC_list* list;
+  table_T* table;
+
+  TAC* tacs;
+  arg_T* args;
+  table_T* tables;
+  entry_T* entries;
+  entry_T** entryPointers;
+  table_T** nestedPointers;
+
+  cache_header header;
+
+} cache_T;
+
+/* Open addressing map used while writing, from pointers or strings to their index or offset */
+typedef struct CACHE_MAP_STRUCT {
+
+  const void** keys;
+  uint32_t* values;
+  size_t capacity;
+  size_t size;
+
+} cache_map;
+
+/*
+A .lunaf file holds the generated Assembly code of every function of the last compilation, found by the hash of the function
+Layout: [magic][version] then a cache_fragment and it's code for every function
+*/
+typedef struct CACHE_FRAGMENT_STRUCT {
+
+  uint64_t hash;          // Hash of the function's TAC, symbol tables and the global symbols it can see
+  uint64_t size;          // Bytes of code after the fragment in the file
+  uint64_t offset;        // Offset of the code in the loaded file, only used in memory
+
+} cache_fragment;
+
+typedef struct CACHE_FUNCTIONS_STRUCT {
+
+  char* filename;
+
+  char* data;             // Code of the loaded file
+  cache_fragment* fragments;    // Fragments of the loaded file, sorted by hash
+  size_t size;
+
+  emitter_T* written;     // Fragments of this compilation, written over the old file at the end
+  emitter_T* globals;     // Hashed bytes of the global symbols, the start of every function's key
+
+} cache_functions;
+
+/* Scratch memory for hashing functions, one for each thread that hashes */
+typedef struct CACHE_KEY_STRUCT {
+
+  emitter_T* bytes;       // Bytes that are hashed
+  cache_map tacs;         // Index of every instruction of the function that is hashed
+
+} cache_key;
+
+cache_T* cache_load(char* filename, uint64_t hash);
+bool cache_build(cache_T* cache);
+void cache_free(cache_T* cache);
+
+void cache_write(char* filename, uint64_t hash, table_T* table, TAC_list* list);
+void cache_write_table(table_T* table, uint32_t parent, emitter_T* tables, emitter_T* entries, emitter_T* strings, cache_map* map, uint32_t* tableCount, uint32_t* entryCount);
+
+cache_functions* cache_functions_load(char* filename, table_T* table);
+void cache_functions_add(cache_functions* functions, uint64_t hash, const char* code, size_t size);
+void cache_functions_write(cache_functions* functions);
+void cache_key_table(emitter_T* key, table_T* table, bool nested);
+
+char* cache_functions_find(cache_functions* functions, uint64_t hash, size_t* size);
+
+uint64_t cache_function_hash(cache_functions* functions, cache_key* key, table_T* table, TAC* function);
+
+void cache_key_free(cache_key* key);
+
+uint32_t cache_string(emitter_T* strings, cache_map* map, char* string);
+uint32_t cache_map_find(cache_map* map, const void* key, bool string);
+void cache_map_add(cache_map* map, const void* key, uint32_t value, bool string);
+
+#endif
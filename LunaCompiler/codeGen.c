@@ -3,7 +3,7 @@
 
 /*
 init_asm_frontend initializes the asm frontend
-Input: Program symbol table, Head of the TAC instructions list, target name for the produced file (.asm)
+Input: Program symbol table, Head of the TAC instructions list, target name for the produced file (.asm), NULL to keep the code in memory
 Output: The asm frontend
 */
 asm_frontend* init_asm_frontend(table_T* table, TAC* head, char* targetName) {
@@ -11,7 +11,6 @@ asm_frontend* init_asm_frontend(table_T* table, TAC* head, char* targetName) {
   asm_frontend* frontend = mcalloc(1, sizeof(asm_frontend));
 
   frontend->registers = mcalloc(REG_AMOUNT, sizeof(register_T*));
-  frontend->labelList = mcalloc(1, sizeof(label_list));
   
   // Allocate all registers for the frontend
   for (unsigned int i = 0; i < REG_AMOUNT; i++) {
@@ -23,7 +22,7 @@ asm_frontend* init_asm_frontend(table_T* table, TAC* head, char* targetName) {
   frontend->table = table;
   frontend->instruction = head;
 
-  frontend->targetProg = fopen(targetName, "w");
+  frontend->output = init_emitter(targetName ? fopen(targetName, "w") : NULL);
 
   return frontend;
 }
@@ -35,8 +34,7 @@ Output: None
 */
 void descriptor_push(register_T* reg, arg_T* descriptor) {
 
-  reg->regDescList = mrealloc(reg->regDescList, sizeof(arg_T*) * ++reg->size);
-  reg->regDescList[reg->size - 1] = descriptor;
+  vector_push(reg->regDescList, reg->size, reg->capacity, descriptor);
 }
 
 /*
@@ -59,13 +57,15 @@ void descriptor_reset(asm_frontend* frontend, register_T* r) {
 
   entry_T* entry = NULL;
 
+  stats_add(STATS_RESETS, 1);
+
   // Free all arguments
   for (unsigned int i = 0; i < r->size; i++) {
 
     if (r->regDescList[i]->type == TEMP_P) {
 
       r->regDescList[i]->value = NULL;
-      free(r->regDescList[i]);
+      mfree(r->regDescList[i]);
       r->regDescList[i] = NULL;
     }
     else if (r->regDescList[i]->type == CHAR_P && (entry = table_search_entry(frontend->table, r->regDescList[i]->value))) {
@@ -76,9 +76,10 @@ void descriptor_reset(asm_frontend* frontend, register_T* r) {
   // Free the register descriptor list itself
   if (r->regDescList) {
 
-    free(r->regDescList);
+    mfree(r->regDescList);
     r->regDescList = NULL;
     r->size = 0;
+    r->capacity = 0;
   }
 }
 
@@ -124,7 +125,9 @@ void generate_global_vars(asm_frontend* frontend, TAC* triple) {
       if (!(table_search_table(table, triple->arg1->value)->prev)) {
 
         // Declaring and assigning the global var the value of the next operation (which will be an assignment)
-        fprintf(frontend->targetProg, "%s %s %s\n", (char*)triple->arg1->value, (char*)triple->arg2->value, (char*)triple->next->arg2->value);
+        emit_string(frontend->output, triple->arg1->value);
+        emit_char(frontend->output, ' ');
+        emit_instruction(frontend->output, triple->arg2->value, triple->next->arg2->value, NULL);
         triple = triple->next;
       }
     
@@ -137,38 +140,44 @@ void generate_global_vars(asm_frontend* frontend, TAC* triple) {
 
 /*
 write_asm is the main code generator function that produces all the Assembly code
-Input: Symbol table, head of TAC list, target name for the file we want to produce
+Input: Symbol table, head of TAC list, target name for the file we want to produce,
+name of the function cache file to reuse the code of unchanged functions from (NULL to generate everything)
 */
-void write_asm(table_T* table, TAC* head, char* targetName) {
+void write_asm(table_T* table, TAC* head, char* targetName, char* cacheName) {
 
   asm_frontend* frontend = init_asm_frontend(table, head, targetName);  // Initialize frontend
   TAC* triple = head;
   TAC* mainStart = NULL;
+  FILE* targetProg = NULL;
+  cache_functions* functions = NULL;
   int mainTableIndex = 0;
 
   // Print the template for the MASM Assembly program
   for (unsigned int i = 0; i < TEMPLATE_SIZE; i++) {
-    fprintf(frontend->targetProg, "%s\n", asm_template[i]);
+    emit_line(frontend->output, asm_template[i]);
   }
   
   // Generate the global variables in the .data section of the Assembly file
-  fprintf(frontend->targetProg, ".data\n");
+  emit_line(frontend->output, ".data");
   generate_global_vars(frontend, triple);
 
-  fprintf(frontend->targetProg, ".code\n");
+  emit_line(frontend->output, ".code");
 
   frontend->table->tableIndex = 0;
 
-  // Main loop to generate code
-  while (frontend->instruction) {
+  if (cacheName) {
+    functions = cache_functions_load(cacheName, frontend->table);
+  }
+
+  // Functions don't depend on each other's code, so they are generated in parallel and written in order
+  generate_functions(frontend, functions);
+
+  // Save main function start
+  for (triple = head; triple && !mainStart; triple = triple->next) {
 
-    // Save main function start
-    if (frontend->instruction->op == AST_FUNCTION && !strcmp(frontend->instruction->arg1->value, "main")) {
-      mainStart = frontend->instruction;
+    if (triple->op == AST_FUNCTION && !strcmp(triple->arg1->value, "main")) {
+      mainStart = triple;
     }
-      
-    generate_asm(frontend);
-    frontend->instruction = frontend->instruction->next;
   }
 
   frontend->instruction = mainStart;
@@ -180,11 +189,16 @@ void write_asm(table_T* table, TAC* head, char* targetName) {
   else {
 
     printf("[Error]: No main file to start executing from");
-    exit(1);
+    error_exit();
+  }
+
+  if (functions) {
+    cache_functions_write(functions);
   }
     
-  fclose(frontend->targetProg);
-  free_frontend(frontend);
+  targetProg = frontend->output->target;
+  free_frontend(frontend);    // Freeing the frontend also flushes the rest of the buffered output
+  fclose(targetProg);
 }
 
 /*
@@ -209,18 +223,19 @@ void generate_asm(asm_frontend* frontend) {
     
   op = typeToString(frontend->instruction->op);  // Get type of operation in a string form
 
-  // Binary operations
-  if (frontend->instruction->op == AST_ADD || frontend->instruction->op == AST_SUB) {
+  // Binary operations, the bitwise ones are written like addition
+  if (frontend->instruction->op == AST_ADD || frontend->instruction->op == AST_SUB || frontend->instruction->op == AST_BAND
+    || frontend->instruction->op == AST_BOR || frontend->instruction->op == AST_XOR) {
     generate_binop(frontend);
   }
+  else if (frontend->instruction->op == AST_SHL || frontend->instruction->op == AST_SHR) {
+    generate_shift(frontend);
+  }
   // Multiplications and divisions are different in Assembly 8086 sadly
   else if (frontend->instruction->op == AST_MUL || frontend->instruction->op == AST_DIV) {
     generate_mul_div(frontend);
   }
-  else if (frontend->instruction->op == TOKEN_LESS || frontend->instruction->op == TOKEN_MORE
-    || frontend->instruction->op == TOKEN_ELESS || frontend->instruction->op == TOKEN_EMORE
-    || frontend->instruction->op == TOKEN_DEQUAL || frontend->instruction->op == TOKEN_NEQUAL) {
-
+  else if (traversal_is_comparison(frontend->instruction->op)) {
     generate_condition(frontend);
   }
   else {
@@ -248,10 +263,11 @@ void generate_asm(asm_frontend* frontend) {
     case AST_IFZ:           generate_if_false(frontend); break;
     case AST_GOTO:          generate_unconditional_jump(frontend); break;
     case AST_LABEL:         
-    case AST_LOOP_LABEL:    fprintf(frontend->targetProg, "%s:\n", generate_get_label(frontend, frontend->instruction)); descriptor_reset_all_registers(frontend); break;
+    case AST_LOOP_LABEL:    emit_string(frontend->output, generate_get_label(frontend, frontend->instruction)); emit_line(frontend->output, ":"); descriptor_reset_all_registers(frontend); break;
     case AST_ASM:           generate_asm_block(frontend); break;
     case AST_FUNC_CALL:     generate_func_call(frontend); break;
     case AST_PRINT:         generate_print(frontend); break;
+    case AST_PARAM:         generate_param(frontend); break;
     case AST_RETURN:        generate_return(frontend); break;
   
     }
@@ -259,7 +275,7 @@ void generate_asm(asm_frontend* frontend) {
 }
 
 /*
-generate_binop generates Assembly code for addition and substruction
+generate_binop generates Assembly code for addition, substruction and the bitwise operations
 Input: Backend
 Output: None
 */
@@ -271,8 +287,10 @@ void generate_binop(asm_frontend* frontend) {
   char* arg1 = NULL;
   char* arg2 = NULL;
 
+  bool arithmetic = frontend->instruction->op == AST_ADD || frontend->instruction->op == AST_SUB;    // Only they have shortcuts
+
   // If the operation is add or sub by 0 then we can do nothing 
-  if (frontend->instruction->arg2->type == CHAR_P && !strcmp(frontend->instruction->arg2->value, "0")) {
+  if (arithmetic && frontend->instruction->arg2->type == CHAR_P && !strcmp(frontend->instruction->arg2->value, "0")) {
     descriptor_push_tac(frontend, generate_move_to_register(frontend, frontend->instruction->arg1), frontend->instruction);
     return;
   }
@@ -282,11 +300,11 @@ void generate_binop(asm_frontend* frontend) {
   }
 
   // Addition by 1 can be replaced by the instruction INC
-  if (frontend->instruction->arg2->type == CHAR_P && !strcmp(frontend->instruction->arg2->value, "1")) {
+  if (arithmetic && frontend->instruction->arg2->type == CHAR_P && !strcmp(frontend->instruction->arg2->value, "1")) {
 
     reg1 = generate_move_to_register(frontend, frontend->instruction->arg1);
     descriptor_push_tac(frontend, reg1, frontend->instruction);
-    frontend->instruction->op == AST_ADD ? fprintf(frontend->targetProg, "INC %s\n", generate_get_register_name(reg1)) : fprintf(frontend->targetProg, "DEC %s\n", generate_get_register_name(reg1));
+    emit_instruction(frontend->output, frontend->instruction->op == AST_ADD ? "INC" : "DEC", generate_get_register_name(reg1), NULL);
     return;
   }
   // Substruction by 1 can be replaced by the instruction DEC
@@ -294,7 +312,7 @@ void generate_binop(asm_frontend* frontend) {
 
     reg1 = generate_move_to_register(frontend, frontend->instruction->arg2);
     descriptor_push_tac(frontend, reg1, frontend->instruction);
-    fprintf(frontend->targetProg, "INC %s\n", generate_get_register_name(reg1));
+    emit_instruction(frontend->output, "INC", generate_get_register_name(reg1), NULL);
     return;
   }
 
@@ -320,7 +338,53 @@ void generate_binop(asm_frontend* frontend) {
 
   descriptor_push_tac(frontend, reg1, frontend->instruction);      // We treat the whole TAC as a temporary variable that is now in the register
 
-  fprintf(frontend->targetProg, "%s %s, %s\n", typeToString(frontend->instruction->op), arg1, arg2);
+  emit_instruction(frontend->output, typeToString(frontend->instruction->op), arg1, arg2);
+}
+
+/*
+generate_shift generates Assembly code for shifts, an amount that isn't a constant has to be in CL
+Input: Backend
+Output: None
+*/
+void generate_shift(asm_frontend* frontend) {
+
+  register_T* reg1 = generate_move_to_register(frontend, frontend->instruction->arg1);
+  register_T* reg2 = NULL;
+  char* op = typeToString(frontend->instruction->op);
+  char* arg1 = generate_get_register_name(reg1);
+  char* arg2 = NULL;
+
+  // A constant amount is a part of the instruction
+  if (frontend->instruction->arg2->type == CHAR_P && !table_search_entry(frontend->table, frontend->instruction->arg2->value)) {
+
+    descriptor_push_tac(frontend, reg1, frontend->instruction);
+    emit_instruction(frontend->output, op, arg1, frontend->instruction->arg2->value);
+    return;
+  }
+
+  reg1->regLock = true;
+  reg2 = generate_move_to_register(frontend, frontend->instruction->arg2);
+  reg1->regLock = false;
+
+  arg2 = generate_get_register_name(reg2);
+
+  descriptor_push_tac(frontend, reg1, frontend->instruction);
+
+  if (reg2->reg == REG_CX) {
+    emit_instruction(frontend->output, op, arg1, "CL");
+  }
+  // The value is in ECX, so it switches places with the amount and then goes back
+  else if (reg1->reg == REG_CX) {
+    emit_instruction(frontend->output, "XCHG", "ECX", arg2);
+    emit_instruction(frontend->output, op, arg2, "CL");
+    emit_instruction(frontend->output, "XCHG", "ECX", arg2);
+  }
+  else {
+    emit_line(frontend->output, "PUSH ECX");
+    emit_instruction(frontend->output, "MOV", "ECX", arg2);
+    emit_instruction(frontend->output, op, arg1, "CL");
+    emit_line(frontend->output, "POP ECX");
+  }
 }
 
 /*
@@ -354,16 +418,16 @@ void generate_mul_div(asm_frontend* frontend) {
   reg1->regLock = false;
 
   if (frontend->instruction->op == AST_MUL) {
-    fprintf(frontend->targetProg, "MUL %s\n", generate_get_register_name(reg2));
+    emit_instruction(frontend->output, "MUL", generate_get_register_name(reg2), NULL);
   }
   else {
 
     // Xoring EDX is necessary because in division we divide EDX:EAX with the other register which means any 
     // value in EDX can ruin our calculations
-    fprintf(frontend->targetProg, "PUSH EDX\n");
-    fprintf(frontend->targetProg, "XOR EDX, EDX\n");
-    fprintf(frontend->targetProg, "DIV %s\n", generate_get_register_name(reg2));
-    fprintf(frontend->targetProg, "POP EDX\n");
+    emit_line(frontend->output, "PUSH EDX");
+    emit_line(frontend->output, "XOR EDX, EDX");
+    emit_instruction(frontend->output, "DIV", generate_get_register_name(reg2), NULL);
+    emit_line(frontend->output, "POP EDX");
   }
 
   frontend->registers[REG_DX]->regLock = false;    // Remove lock on EDX after we're done
@@ -371,30 +435,65 @@ void generate_mul_div(asm_frontend* frontend) {
 }
 
 /*
-generate_condition generates Assembly code for a condition like <, == etc
+generate_condition generates Assembly code for a condition like <, == etc, when it isn't the condition of the IFZ
+after it, the condition becomes 1 or 0 in the register of it's first operand
 Input: Backend
 Output: None
 */
 void generate_condition(asm_frontend* frontend) {
 
+  // Only the registers that have a low byte can be set by a condition, and they are the general purpose ones
+  static char* const lowBytes[GENERAL_REG_AMOUNT] = { "AL", "BL", "CL", "DL" };
+
+  char* setCondition = NULL;
+
   register_T* reg1 = generate_move_to_register(frontend, frontend->instruction->arg1);
 
   reg1->regLock = true;
   register_T* reg2 = generate_move_to_register(frontend, frontend->instruction->arg2);
   reg1->regLock = false;
 
-  // Generate a block exit operation because with the control flow that is occuring here,
-  // we don't know if the variables changed inside a loop. For if statements we don't want the
-  // change to affect our else statement
-  frontend->table = frontend->table->nestedScopes[frontend->table->tableIndex];
-  generate_block_exit(frontend);
-  frontend->table = frontend->table->prev;
+  if (!traversal_is_condition(frontend->instruction)) {
+
+    switch (frontend->instruction->op) {
+
+    case TOKEN_LESS: setCondition = "SETL"; break;
+    case TOKEN_ELESS: setCondition = "SETLE"; break;
+    case TOKEN_MORE: setCondition = "SETG"; break;
+    case TOKEN_EMORE: setCondition = "SETGE"; break;
+    case TOKEN_DEQUAL: setCondition = "SETE"; break;
+    case TOKEN_NEQUAL: setCondition = "SETNE"; break;
+
+    }
 
+    emit_instruction(frontend->output, "CMP", generate_get_register_name(reg1), generate_get_register_name(reg2));
+    descriptor_push_tac(frontend, reg1, frontend->instruction);
 
-  fprintf(frontend->targetProg, "CMP %s, %s\n", generate_get_register_name(reg1), generate_get_register_name(reg2));
+    emit_instruction(frontend->output, setCondition, lowBytes[reg1->reg], NULL);
+    emit_instruction(frontend->output, "MOVZX", generate_get_register_name(reg1), lowBytes[reg1->reg]);
+    return;
+  }
+
+  generate_condition_exit(frontend);
+
+  emit_instruction(frontend->output, "CMP", generate_get_register_name(reg1), generate_get_register_name(reg2));
   descriptor_push_tac(frontend, generate_get_register(frontend), frontend->instruction);
 }
 
+/*
+generate_condition_exit generates a block exit operation before a conditional jump, because with the control flow that is
+occuring here, we don't know if the variables changed inside a loop. For if statements we don't want the
+change to affect our else statement
+Input: Backend
+Output: None
+*/
+void generate_condition_exit(asm_frontend* frontend) {
+
+  frontend->table = frontend->table->nestedScopes[frontend->table->tableIndex];
+  generate_block_exit(frontend);
+  frontend->table = frontend->table->prev;
+}
+
 /*
 generate_if_false generates Assembly code for IFZ operations
 Input: Backend
@@ -403,8 +502,9 @@ Output: None
 void generate_if_false(asm_frontend* frontend) {
 
   char* jmpCondition = NULL;
+  register_T* reg = NULL;
 
-  if (frontend->instruction->arg1->type == TAC_P || frontend->instruction->arg1->type == TEMP_P) {
+  if (frontend->instruction->arg1->type == TAC_P && traversal_is_condition(frontend->instruction->arg1->value)) {
 
     // In all our cases when it comes to comparison, we want to do the exact opposite of what is specified
     switch (((TAC*)frontend->instruction->arg1->value)->op) {
@@ -418,12 +518,15 @@ void generate_if_false(asm_frontend* frontend) {
 
     }
 
-    fprintf(frontend->targetProg, "%s %s\n", jmpCondition, generate_get_label(frontend, frontend->instruction->arg2->value));
+    emit_instruction(frontend->output, jmpCondition, generate_get_label(frontend, frontend->instruction->arg2->value), NULL);
   }
-  // For a number or variable, we want to skip statement if it equals 0
+  // For any other value, we want to skip statement if it equals 0
   else {
-    fprintf(frontend->targetProg, "CMP %s, 0\n", generate_get_register_name(generate_move_to_register(frontend, frontend->instruction->arg1)));
-    fprintf(frontend->targetProg, "JE %s\n", generate_get_label(frontend, frontend->instruction->arg2->value));
+    reg = generate_move_to_register(frontend, frontend->instruction->arg1);
+    generate_condition_exit(frontend);
+
+    emit_instruction(frontend->output, "CMP", generate_get_register_name(reg), "0");
+    emit_instruction(frontend->output, "JE", generate_get_label(frontend, frontend->instruction->arg2->value), NULL);
   }
 }
 
@@ -433,7 +536,7 @@ Input: Backend
 Outut: None
 */
 void generate_unconditional_jump(asm_frontend* frontend) {
-  fprintf(frontend->targetProg, "JMP %s\n", generate_get_label(frontend, frontend->instruction->arg1->value));
+  emit_instruction(frontend->output, "JMP", generate_get_label(frontend, frontend->instruction->arg1->value), NULL);
 }
 
 /*
@@ -445,7 +548,7 @@ void generate_asm_block(asm_frontend* frontend) {
 
   generate_save_relevant(frontend, saveRegs);
 
-  fprintf(frontend->targetProg, "%s\n", (char*)frontend->instruction->arg1->value);
+  emit_line(frontend->output, frontend->instruction->arg1->value);
 
   generate_restore_relevant(frontend, saveRegs);
 }
@@ -463,12 +566,16 @@ void generate_assignment(asm_frontend* frontend) {
 
   if (entry->dtype == DATA_STRING) {
 
-    fprintf(frontend->targetProg, "PUSHA\n");
+    emit_line(frontend->output, "PUSHA");
 
     // MASM macro to copy a string value onto the string array
-    fprintf(frontend->targetProg, "fnc lstrcpy, ADDR %s, \"%s\"\n", (char*)frontend->instruction->arg1->value, (char*)frontend->instruction->arg2->value);
+    emit_string(frontend->output, "fnc lstrcpy, ADDR ");
+    emit_string(frontend->output, frontend->instruction->arg1->value);
+    emit_string(frontend->output, ", \"");
+    emit_string(frontend->output, frontend->instruction->arg2->value);
+    emit_line(frontend->output, "\"");
 
-    fprintf(frontend->targetProg, "POPA\n");
+    emit_line(frontend->output, "POPA");
 
     return;
   }
@@ -508,8 +615,18 @@ void generate_var_dec(asm_frontend* frontend) {
 
   // If the second argument is a number, that means it's the amount of bytes to put in a string data
   // For other types, just declare them normally
-  isNum(frontend->instruction->arg2->value) ? fprintf(frontend->targetProg, "LOCAL %s[%s]:BYTE\n", name, (char*)frontend->instruction->arg2->value)
-    : fprintf(frontend->targetProg, "LOCAL %s:%s\n", name, (char*)frontend->instruction->arg2->value);
+  emit_string(frontend->output, "LOCAL ");
+  emit_string(frontend->output, name);
+
+  if (isNum(frontend->instruction->arg2->value)) {
+    emit_char(frontend->output, '[');
+    emit_string(frontend->output, frontend->instruction->arg2->value);
+    emit_line(frontend->output, "]:BYTE");
+  }
+  else {
+    emit_char(frontend->output, ':');
+    emit_line(frontend->output, frontend->instruction->arg2->value);
+  }
   
 }  
 
@@ -524,10 +641,10 @@ void generate_main(asm_frontend* frontend) {
 
   char* name = frontend->instruction->arg1->value;
 
-  fprintf(frontend->targetProg, "main_start:\n");
-  fprintf(frontend->targetProg, "CALL main\n");  // Call the actual main procedure
-  fprintf(frontend->targetProg, "invoke ExitProcess, 0\n");
-  fprintf(frontend->targetProg, "end main_start\n");
+  emit_line(frontend->output, "main_start:");
+  emit_line(frontend->output, "CALL main");  // Call the actual main procedure
+  emit_line(frontend->output, "invoke ExitProcess, 0");
+  emit_line(frontend->output, "end main_start");
 }
 
 /*
@@ -548,7 +665,17 @@ void generate_function(asm_frontend* frontend) {
   char* name = frontend->instruction->arg1->value;
   char* varName = NULL;
 
-  fprintf(frontend->targetProg, "%s PROC ", name);  // Generating function label
+  emit_string(frontend->output, name);    // Generating function label
+  emit_string(frontend->output, " PROC ");
+
+  // Labels are named by the function and their number in it, so a branch that is added to one function
+  // doesn't rename the labels of the functions after it
+  mfree(frontend->labelName);
+  frontend->labelPrefix = strlen(name) + strlen("_label");
+  frontend->labelName = mcalloc(1, frontend->labelPrefix + LABEL_NAME_SIZE);
+  memcpy(frontend->labelName, name, strlen(name));
+  memcpy(frontend->labelName + strlen(name), "_label", strlen("_label"));
+  frontend->labelBase = frontend->instruction->label;
 
   frontend->table->tableIndex++;
   frontend->table = frontend->table->nestedScopes[frontend->table->tableIndex - 1];
@@ -560,14 +687,19 @@ void generate_function(asm_frontend* frontend) {
 
   // Generate all the local variables for the function
   if (counter > 0) {
-    fprintf(frontend->targetProg, "%s:%s", frontend->table->entries[0]->name, dataToAsm(frontend->table->entries[0]->dtype));
+    emit_string(frontend->output, frontend->table->entries[0]->name);
+    emit_char(frontend->output, ':');
+    emit_string(frontend->output, dataToAsm(frontend->table->entries[0]->dtype));
   }
     
   for (unsigned int i = 1; i < counter; i++) {
-    fprintf(frontend->targetProg, ", %s:%s", frontend->table->entries[i]->name, dataToAsm(frontend->table->entries[i]->dtype));
+    emit_string(frontend->output, ", ");
+    emit_string(frontend->output, frontend->table->entries[i]->name);
+    emit_char(frontend->output, ':');
+    emit_string(frontend->output, dataToAsm(frontend->table->entries[i]->dtype));
   }
 
-  fprintf(frontend->targetProg, "\n");
+  emit_char(frontend->output, '\n');
 
   // First generate only the variable declarations
   while (frontend->instruction->op != TOKEN_FUNC_END) {
@@ -596,7 +728,143 @@ void generate_function(asm_frontend* frontend) {
     frontend->instruction = frontend->instruction->next;
   }
 
-  fprintf(frontend->targetProg, "%s ENDP\n", name);
+  emit_instruction(frontend->output, name, "ENDP", NULL);
+}
+
+/*
+generate_functions generates the code of every function, each one on it's own frontend and into it's own buffer,
+on a pool of threads. The buffers are written to the output in the order of the functions
+Input: Backend, function cache (NULL to generate every function)
+Output: None
+*/
+void generate_functions(asm_frontend* frontend, cache_functions* functions) {
+
+  asm_generation generation = { 0 };
+  asm_function_job* job = NULL;
+
+  generation.jobs = generate_collect_functions(frontend, &generation.size);
+  generation.cache = functions;
+  generation.threads = pool_default_threads();
+
+  if (generation.threads > generation.size) {
+    generation.threads = (unsigned int)generation.size;
+  }
+
+  generation.workers = mcalloc(generation.threads + 1, sizeof(asm_worker));
+
+  // A new table has room for one nested scope, which is where each thread puts the function it generates
+  for (unsigned int i = 0; i < generation.threads; i++) {
+    generation.workers[i].globals = table_copy_scope(frontend->table);
+  }
+
+  pool_run(generation.threads, generation.size, generate_function_job, &generation);
+
+  for (size_t i = 0; i < generation.size; i++) {
+
+    job = &generation.jobs[i];
+    emit_bytes(frontend->output, job->code, job->size);
+
+    if (functions) {
+      cache_functions_add(functions, job->hash, job->code, job->size);
+    }
+
+    if (job->output) {
+      emitter_free(job->output);
+    }
+  }
+
+  for (unsigned int i = 0; i < generation.threads; i++) {
+    table_free_table(generation.workers[i].globals);
+    cache_key_free(&generation.workers[i].key);
+  }
+
+  mfree(generation.workers);
+  mfree(generation.jobs);
+}
+
+/*
+generate_function_job generates one function, it runs on a thread of the pool
+Input: Generation state, index of the function, index of the thread
+Output: None
+*/
+void generate_function_job(void* context, size_t index, unsigned int worker) {
+
+  asm_generation* generation = context;
+  asm_function_job* job = &generation->jobs[index];
+  asm_worker* state = &generation->workers[worker];
+  asm_frontend* frontend = NULL;
+  table_T* globals = job->table->prev;
+
+  // Reuse the code from the last compilation if nothing the function depends on changed
+  if (generation->cache) {
+
+    job->hash = cache_function_hash(generation->cache, &state->key, job->table, job->function);
+
+    if ((job->code = cache_functions_find(generation->cache, job->hash, &job->size))) { return; }
+  }
+
+  // When a function starts every global holds it's own value and no register has it, so the globals start with only
+  // their variable in their address descriptors, and the code doesn't depend on the function the thread generated before
+  for (size_t i = 0; i < state->globals->entrySize; i++) {
+    address_reset(state->globals->entries[i]);
+    address_push(state->globals->entries[i], state->globals->entries[i]->name, ADDRESS_VAR);
+  }
+
+  // The function's scope is linked to the thread's copy of the global scope while it is generated
+  state->globals->nestedScopes[0] = job->table;
+  state->globals->tableIndex = 0;
+  job->table->prev = state->globals;
+
+  frontend = init_asm_frontend(state->globals, job->function, NULL);
+  generate_function(frontend);
+
+  job->output = frontend->output;
+  job->code = job->output->buffer;
+  job->size = job->output->size;
+
+  frontend->output = NULL;
+  free_frontend(frontend);
+
+  job->table->prev = globals;
+}
+
+/*
+generate_collect_functions finds every function of the program and the symbol table of it's scope
+Input: Backend
+Output: Functions in the order they appear, the amount of them is stored in size
+*/
+asm_function_job* generate_collect_functions(asm_frontend* frontend, size_t* size) {
+
+  asm_function_job* jobs = NULL;
+  size_t capacity = 0;
+  size_t scope = 0;
+  size_t depth = 0;
+
+  *size = 0;
+
+  for (TAC* triple = frontend->instruction; triple; triple = triple->next) {
+
+    switch (triple->op) {
+
+    case AST_FUNCTION:
+
+      // The scope of a function is the next global scope, it starts right after the function's header
+      if (depth || scope >= frontend->table->nestedSize) { break; }
+
+      vector_reserve(jobs, capacity, *size + 1);
+
+      memset(&jobs[*size], 0, sizeof(asm_function_job));
+      jobs[*size].function = triple;
+      jobs[*size].table = frontend->table->nestedScopes[scope];
+      (*size)++;
+      break;
+
+    case TOKEN_LBRACE: if (!depth++) { scope++; } break;
+    case TOKEN_RBRACE: depth--; break;
+    }
+  }
+
+  return jobs;
 }
 
 /*
@@ -606,7 +874,7 @@ Output: None
 */
 void generate_return(asm_frontend* frontend) {
   register_T* reg = generate_move_to_ax(frontend, frontend->instruction->arg1);    // Always return a value in AX
-  fprintf(frontend->targetProg, "RET\n");
+  emit_line(frontend->output, "RET");
 }
 
 void generate_save_relevant(asm_frontend* frontend, register_T** saveRegs) {
@@ -617,13 +885,14 @@ void generate_save_relevant(asm_frontend* frontend, register_T** saveRegs) {
 
     if (generate_check_register_usability(frontend, frontend->registers[i])) { continue; }
 
-    fprintf(frontend->targetProg, "PUSH %s\n", generate_get_register_name(frontend->registers[i]));
+    emit_instruction(frontend->output, "PUSH", generate_get_register_name(frontend->registers[i]), NULL);
       
     saveRegs[i] = mcalloc(1, sizeof(register_T));
     saveRegs[i]->reg = frontend->registers[i]->reg;
     saveRegs[i]->size = frontend->registers[i]->size;
     saveRegs[i]->regLock = frontend->registers[i]->regLock;
     saveRegs[i]->regDescList = mcalloc(1, sizeof(arg_T*) * frontend->registers[i]->size);
+    saveRegs[i]->capacity = frontend->registers[i]->size;
 
     for (unsigned int i2 = 0; i2 < frontend->registers[i]->size; i2++) {
       if (frontend->registers[i]->regDescList[i2]->type == CHAR_P) {
@@ -643,23 +912,22 @@ void generate_restore_relevant(asm_frontend* frontend, register_T** saveRegs) {
   for (uint8_t i = GENERAL_REG_AMOUNT; i > 0; i--) {
     if (!saveRegs[i - 1]) { continue; }
 
-    fprintf(frontend->targetProg, "POP %s\n", generate_get_register_name(frontend->registers[i - 1]));
+    emit_instruction(frontend->output, "POP", generate_get_register_name(frontend->registers[i - 1]), NULL);
     descriptor_reset(frontend, frontend->registers[i - 1]);
-    free(frontend->registers[i - 1]);
+    mfree(frontend->registers[i - 1]);
     frontend->registers[i - 1] = saveRegs[i - 1];
     saveRegs[i - 1] = NULL;
   }
 }
 
 /*
-generate_func_call generates Assembly code for function calls
+generate_func_call starts a function call, the parameters are pushed as we reach them and the call comes after the last one
 Input: Backend
 Output: None
 */
 void generate_func_call(asm_frontend* frontend) {
 
-  char* name = frontend->instruction->arg1->value;
-  size_t size = atoi(frontend->instruction->arg2->value);
+  asm_call pending = { frontend->instruction, atoi(frontend->instruction->arg2->value), 0, false, { NULL } };
 
   if (frontend->registers[REG_AX]->size) {
     frontend->registers[REG_AX]->regLock = true;
@@ -667,104 +935,117 @@ void generate_func_call(asm_frontend* frontend) {
     frontend->registers[REG_AX]->regLock = false;
   }
 
-  register_T* savedRegs[GENERAL_REG_AMOUNT] = { NULL };
-  
   frontend->registers[REG_AX]->regLock = true;
-  generate_save_relevant(frontend, savedRegs);
+  generate_save_relevant(frontend, pending.savedRegs);
   frontend->registers[REG_AX]->regLock = false;
 
   descriptor_push_tac(frontend, frontend->registers[REG_AX], frontend->instruction);  // Set temporary result to AX
-  
-  // Push all the variables to the stack, from last to first
-  for (unsigned int i = 0; i < size;) {
 
-    frontend->instruction = frontend->instruction->next;
+  // The parameters can have calls in them, so they are kept on a stack instead of generating them here
+  vector_push(frontend->calls, frontend->callsSize, frontend->callsCapacity, pending);
 
-    // For variables and numbers we can just push them as is
-    if (frontend->instruction->op == AST_PARAM && frontend->instruction->arg1->type == CHAR_P) {
-      fprintf(frontend->targetProg, "PUSH %s\n", (char*)frontend->instruction->arg1->value);
-      i++;
-    }
-    // For TAC operations we need to allocate a register before pushing
-    else if (frontend->instruction->op == AST_PARAM && (frontend->instruction->arg1->type == TAC_P || frontend->instruction->arg1->type == TEMP_P)) {
-      fprintf(frontend->targetProg, "PUSH %s\n", generate_get_register_name(generate_move_to_register(frontend, frontend->instruction->arg1)));
-      i++;
-    }
-    // There can be expression operations between parameters, so we need to generate code for them
-    else {
-      generate_asm(frontend);
-    }
+  if (!pending.size) {
+    generate_end_call(frontend);
   }
+}
 
-  fprintf(frontend->targetProg, "CALL %s\n", name);
+/*
+generate_print starts the built in function print, each parameter is printed as soon as we reach it
+Input: Backend
+Output: None
+*/
+void generate_print(asm_frontend* frontend) {
+
+  asm_call pending = { frontend->instruction, atoi(frontend->instruction->arg2->value), 0, false, { NULL } };
 
-  generate_restore_relevant(frontend, savedRegs);
+  generate_save_relevant(frontend, pending.savedRegs);
+
+  vector_push(frontend->calls, frontend->callsSize, frontend->callsCapacity, pending);
+
+  if (!pending.size) {
+    generate_end_call(frontend);
+  }
 }
 
 /*
-generate_print generates Assembly code for the built in function print
+generate_param generates Assembly code for a parameter of the innermost pending call or print
 Input: Backend
 Output: None
 */
-void generate_print(asm_frontend* frontend) {
+void generate_param(asm_frontend* frontend) {
 
-  entry_T* entry = NULL;
+  asm_call* pending = &frontend->calls[frontend->callsSize - 1];
 
-  size_t size = atoi(frontend->instruction->arg2->value);
-  
-  register_T* saveRegs[GENERAL_REG_AMOUNT] = { NULL };
+  if (pending->call->op == AST_PRINT) {
+    generate_print_param(frontend, pending);
+  }
+  // For variables and numbers we can just push them as is
+  else if (frontend->instruction->arg1->type == CHAR_P) {
+    emit_instruction(frontend->output, "PUSH", frontend->instruction->arg1->value, NULL);
+  }
+  // For TAC operations we need to allocate a register before pushing
+  else {
+    emit_instruction(frontend->output, "PUSH", generate_get_register_name(generate_move_to_register(frontend, frontend->instruction->arg1)), NULL);
+  }
 
-  generate_save_relevant(frontend, saveRegs);
-  
-  bool regsChanged = false;  // Optimization to check if registers could've actually changed
+  if (++pending->collected == pending->size) {
+    generate_end_call(frontend);
+  }
+}
 
-  // For each pushed param, produce an fnc StdOut instruction
-  for (unsigned int i = 0; i < size; i++) {
+/*
+generate_print_param produces an fnc StdOut instruction for a parameter of print
+Input: Backend, pending print
+Output: None
+*/
+void generate_print_param(asm_frontend* frontend, asm_call* pending) {
 
-    frontend->instruction = frontend->instruction->next;
+  arg_T* arg = frontend->instruction->arg1;
+  entry_T* entry = arg->type == CHAR_P ? table_search_entry(frontend->table, arg->value) : NULL;
+  char* regName = NULL;
 
-    if (frontend->instruction->op == AST_PARAM && frontend->instruction->arg1->type == CHAR_P) {
-      entry = table_search_entry(frontend->table, frontend->instruction->arg1->value);
-    }
+  // For strings, produce fitting code
+  if (entry && entry->dtype == DATA_STRING) {
+    emit_string(frontend->output, "fnc StdOut, ADDR ");
+    emit_line(frontend->output, entry->name);
+  }
+  // For data literals we just want to print them as is
+  else if (!entry && arg->type != TAC_P && arg->type != TEMP_P) {
+    emit_string(frontend->output, "fnc StdOut, \"");
+    emit_string(frontend->output, arg->value);
+    emit_line(frontend->output, "\"");
+  }
+  // For an integer or a temporary, find or allocate a register to the value and print the value using the str$ macro
+  else {
+    // We need to return registers inside here because they could've changed
+    if (pending->regsChanged) { generate_restore_relevant(frontend, pending->savedRegs); generate_save_relevant(frontend, pending->savedRegs); }
 
-    // For data literals we just want to print them as is
-    if (frontend->instruction->op == AST_PARAM && !entry) {
+    regName = generate_get_register_name(generate_move_to_register(frontend, arg));
+    emit_string(frontend->output, "fnc StdOut, str$(");
+    emit_string(frontend->output, regName);
+    emit_line(frontend->output, ")");
+  }
 
-      if (!(frontend->instruction->arg1->type == TAC_P || frontend->instruction->arg1->type == TEMP_P)) {
-        fprintf(frontend->targetProg, "fnc StdOut, \"%s\"\n", (char*)frontend->instruction->arg1->value);
-      }
-      else {
-        // We need to return registers inside here because they could've changed
-        if (regsChanged) { generate_restore_relevant(frontend, saveRegs); generate_save_relevant(frontend, saveRegs); }
+  pending->regsChanged = true;  // Optimization to check if registers could've actually changed
+}
 
-        fprintf(frontend->targetProg, "fnc StdOut, str$(%s)\n", generate_get_register_name(
-          generate_move_to_register(frontend, frontend->instruction->arg1)));
-      }
-         
-      regsChanged = true;
-    }
-    // For strings being pushed, produce fitting code
-    else if (frontend->instruction->op == AST_PARAM && entry->dtype == DATA_STRING) {
-      fprintf(frontend->targetProg, "fnc StdOut, ADDR %s\n", entry->name);
-      regsChanged = true;
-    }
-    // For an integer, find or allocate a register to the value and print the value using the str$ macro
-    // also for temporeries
-    else if (frontend->instruction->op == AST_PARAM && entry->dtype == DATA_INT) {
-      // We need to return registers inside here because they could've changed
-      if (regsChanged) { generate_restore_relevant(frontend, saveRegs); generate_save_relevant(frontend, saveRegs); }
-      
-      fprintf(frontend->targetProg, "fnc StdOut, str$(%s)\n", generate_get_register_name(generate_move_to_register(frontend, frontend->instruction->arg1)));
-      regsChanged = true;
-    }
-    else {
-      generate_asm(frontend);
-      i--;
-    }
+/*
+generate_end_call finishes the innermost pending call or print once it reached all it's parameters
+Input: Backend
+Output: None
+*/
+void generate_end_call(asm_frontend* frontend) {
+
+  asm_call* pending = &frontend->calls[--frontend->callsSize];
+
+  if (pending->call->op == AST_PRINT) {
+    descriptor_reset_all_registers(frontend);
+  }
+  else {
+    emit_instruction(frontend->output, "CALL", pending->call->arg1->value, NULL);
   }
 
-  descriptor_reset_all_registers(frontend);
-  generate_restore_relevant(frontend, saveRegs);
+  generate_restore_relevant(frontend, pending->savedRegs);
 }
 
 /*
@@ -867,13 +1148,13 @@ register_T* generate_move_to_register(asm_frontend* frontend, arg_T* arg) {
   // If entry exists and value was not found in any register previously, store it in the found available register
   if (entry) {
     address_push(entry, reg, ADDRESS_REG);
-    fprintf(frontend->targetProg, "MOV %s, [%s]\n", name, (char*)arg->value);
+    emit_load(frontend->output, name, arg->value);
   }
   // Otherwise, if we want to move a number to a register, check if that number is 0, if so generate a XOR
   // instruction, and if it isn't just load it's value onto the register
   else if (arg->type == CHAR_P) {
-    !strcmp(arg->value, "0") ? fprintf(frontend->targetProg, "XOR %s, %s\n", name, name)
-      : fprintf(frontend->targetProg, "MOV %s, %s\n", name, (char*)arg->value);  
+    !strcmp(arg->value, "0") ? emit_instruction(frontend->output, "XOR", name, name)
+      : emit_instruction(frontend->output, "MOV", name, arg->value);
   }
   
   return reg;
@@ -902,11 +1183,11 @@ register_T* generate_move_new_value_to_register(asm_frontend* frontend, arg_T* a
 
   if (entry) {
     address_push(entry, reg, ADDRESS_REG);
-    fprintf(frontend->targetProg, "MOV %s, [%s]\n", name, (char*)arg->value);
+    emit_load(frontend->output, name, arg->value);
   }
   else {
-    !strcmp(arg->value, "0") ? fprintf(frontend->targetProg, "XOR %s %s\n", name, name)
-      : fprintf(frontend->targetProg, "MOV %s, %s\n", name, (char*)arg->value);    
+    !strcmp(arg->value, "0") ? emit_instruction(frontend->output, "XOR", name, name)
+      : emit_instruction(frontend->output, "MOV", name, arg->value);
   }
 
   return reg;
@@ -920,7 +1201,7 @@ Output: AX register
 register_T* generate_move_to_ax(asm_frontend* frontend, arg_T* arg) {
 
   register_T* reg = generate_check_variable_in_reg(frontend, arg);
-  arg_T** regDescList = NULL;
+  register_T descriptors = { 0 };
 
   if (!reg) {
 
@@ -933,12 +1214,18 @@ register_T* generate_move_to_ax(asm_frontend* frontend, arg_T* arg) {
   }
   else if (reg->reg != REG_AX) {
 
-    fprintf(frontend->targetProg, "XCHG EAX, %s\n", generate_get_register_name(reg));
+    emit_instruction(frontend->output, "XCHG", "EAX", generate_get_register_name(reg));
+
+    // Switch their register descriptors, with the sizes and the capacities that belong to them
+    descriptors = *frontend->registers[REG_AX];
 
-    // Switch their register descriptors
-    regDescList = frontend->registers[REG_AX]->regDescList;
     frontend->registers[REG_AX]->regDescList = reg->regDescList;
-    reg->regDescList = regDescList;
+    frontend->registers[REG_AX]->size = reg->size;
+    frontend->registers[REG_AX]->capacity = reg->capacity;
+
+    reg->regDescList = descriptors.regDescList;
+    reg->size = descriptors.size;
+    reg->capacity = descriptors.capacity;
     
   }
 
@@ -955,11 +1242,12 @@ void generate_free_ax(asm_frontend* frontend, register_T* reg) {
     descriptor_push(reg, frontend->registers[REG_AX]->regDescList[i]);
   }
 
-  fprintf(frontend->targetProg, "MOV %s, EAX\n", generate_get_register_name(reg));    // Move the value of AX to a different register
+  emit_instruction(frontend->output, "MOV", generate_get_register_name(reg), "EAX");    // Move the value of AX to a different register
 
   // Reset AX
   frontend->registers[REG_AX]->size = 0;
-  free(frontend->registers[REG_AX]->regDescList);
+  frontend->registers[REG_AX]->capacity = 0;
+  mfree(frontend->registers[REG_AX]->regDescList);
   frontend->registers[REG_AX]->regDescList = NULL;
 }
 
@@ -1136,12 +1424,14 @@ void generate_spill(asm_frontend* frontend, register_T* r) {
 
   entry_T* entry = NULL;
 
+  stats_add(STATS_SPILLS, 1);
+
   // For each value, store the value of the variable in itself
   for (unsigned int i = 0; i < r->size; i++) {
 
     if ((entry = table_search_entry(frontend->table, r->regDescList[i]->value))) {
 
-      fprintf(frontend->targetProg, "MOV [%s], %s\n", (char*)r->regDescList[i]->value, generate_get_register_name(r));
+      emit_store(frontend->output, r->regDescList[i]->value, generate_get_register_name(r));
       address_push(entry, r->regDescList[i]->value, ADDRESS_VAR);
     }
   }
@@ -1185,7 +1475,7 @@ void register_block_exit(asm_frontend* frontend, register_T* reg) {
     if (!table_search_in_specific_table(frontend->table, reg->regDescList[i]->value)
       && !entry_search_var(entry, reg->regDescList[i]->value)) {    // Here we check if the variable doesn't hold it's own value 
 
-      fprintf(frontend->targetProg, "MOV [%s], %s\n", (char*)reg->regDescList[i]->value, generate_get_register_name(reg));
+      emit_store(frontend->output, reg->regDescList[i]->value, generate_get_register_name(reg));
       address_remove_registers(entry);
       address_push(entry, reg->regDescList[i]->value, ADDRESS_VAR);
     }
@@ -1197,32 +1487,25 @@ void register_block_exit(asm_frontend* frontend, register_T* reg) {
 }
 
 /*
-generate_get_label generates a label name from a TAC instruction address
+generate_get_label generates a label name from the number the label instruction got when it was created
 Input: Backend, label instruction
-Output: Label name
+Output: Label name (valid until the next call)
 */
 char* generate_get_label(asm_frontend* frontend, TAC* label) {
 
-  char* name = NULL;
-  
-  // Search for label and return it
-  for (unsigned int i = 0; i < frontend->labelList->size && !name; i++) {
+  char digits[LABEL_NAME_SIZE] = { 0 };
+  char* digit = digits + LABEL_NAME_SIZE - 1;
+  unsigned int num = label->label - frontend->labelBase;
 
-    if (label == frontend->labelList->labels[i]) {
-      name = frontend->labelList->names[i];
-    }
-  }
-  // If label was not found, create a new one
-  if (!name) {
-    frontend->labelList->labels = mrealloc(frontend->labelList->labels, sizeof(TAC*) * ++frontend->labelList->size);  // Appending list
-    frontend->labelList->labels[frontend->labelList->size - 1] = label;
-    frontend->labelList->names = mrealloc(frontend->labelList->names, sizeof(char*) * frontend->labelList->size);
-    name = mcalloc(1, strlen("label") + numOfDigits(frontend->labelList->size) + 1);
-    sprintf(name, "label%zu", frontend->labelList->size);
-    frontend->labelList->names[frontend->labelList->size - 1] = name;
-  }
+  // Write the digits backwards from the end of the scratch buffer, then copy them after the prefix
+  do {
+    *--digit = '0' + num % 10;
+    num /= 10;
+  } while (num);
+
+  memcpy(frontend->labelName + frontend->labelPrefix, digit, digits + LABEL_NAME_SIZE - digit);
 
-  return name;
+  return frontend->labelName;
 }
 
 /*
@@ -1232,24 +1515,10 @@ Output: Register name
 */
 char* generate_get_register_name(register_T* r) {
 
-  // Switch types
-  switch (r->reg) {
-
-  case REG_AX: return "EAX";
-  case REG_BX: return "EBX";
-  case REG_CX: return "ECX";
-  case REG_DX: return "EDX";
-  case REG_CS: return "CS";
-  case REG_DS: return "DS";
-  case REG_SS: return "SS";
-  case REG_SP: return "ESP";
-  case REG_SI: return "ESI";
-  case REG_DI: return "EDI";
-  case REG_BP: return "EBP";
-  
-  default:     return NULL;
+  // Names are indexed by the register enum so we never rebuild them while emitting
+  static char* const names[REG_AMOUNT] = { "EAX", "EBX", "ECX", "EDX", "CS", "DS", "SS", "ESP", "ESI", "EDI", "EBP" };
 
-  }
+  return r->reg < REG_AMOUNT ? names[r->reg] : NULL;
 }
 
 /*
@@ -1292,7 +1561,7 @@ void generate_remove_descriptor(register_T* reg, arg_T* desc) {
     }
   }
 
-  reg->regDescList = mrealloc(reg->regDescList, --reg->size * sizeof(arg_T*));
+  reg->size--;    // The list keeps it's capacity
 }
 
 /*
@@ -1301,8 +1570,8 @@ Input: Backend
 Output: None
 */
 void restore_save_registers(asm_frontend* frontend) {
-  fprintf(frontend->targetProg, "POPA\n");
-  fprintf(frontend->targetProg, "PUSHA\n");
+  emit_line(frontend->output, "POPA");
+  emit_line(frontend->output, "PUSHA");
 }
 
 /*
@@ -1314,24 +1583,20 @@ void free_frontend(asm_frontend* frontend) {
 
   free_registers(frontend);
 
-  free(frontend->registers);
-
-  if (frontend->labelList) {
-    for (unsigned int i = 0; i < frontend->labelList->size; i++) {
-      free(frontend->labelList->names[i]);
-    }
+  mfree(frontend->registers);
+  mfree(frontend->labelName);
+  mfree(frontend->calls);
 
-    free(frontend->labelList->names);
-    free(frontend->labelList->labels);
-    free(frontend->labelList);
+  if (frontend->output) {
+    emitter_free(frontend->output);
   }
   
-  free(frontend);
+  mfree(frontend);
 }
 
 void free_registers(asm_frontend* frontend) {
   for (unsigned int i = 0; i < REG_AMOUNT; i++) {
     descriptor_reset(frontend, frontend->registers[i]);
-    free(frontend->registers[i]);
+    mfree(frontend->registers[i]);
   }
 }
@@ -2,11 +2,15 @@
 #define CODEGEN_H
 
 #include "TAC.h"
+#include "emitter.h"
+#include "cache.h"
+#include "threadPool.h"
 #include <stdint.h>
 
 #define GENERAL_REG_AMOUNT 4
 #define REG_AMOUNT 11
 #define TEMPLATE_SIZE 13
+#define LABEL_NAME_SIZE 16
 
 typedef struct REGISTER_STRUCT_STRUCT {
 
@@ -30,34 +34,79 @@ typedef struct REGISTER_STRUCT_STRUCT {
 
   arg_T** regDescList;  // Register descriptors: Stores variables and addresses that have their value in the current register
   size_t size;      // Size of register descriptors
+  size_t capacity;
 
 } register_T;
 
-typedef struct LABEL_LIST_STRUCT {
+/* A call or print whose parameters are still being generated, calls in it's parameters are pending on top of it */
+typedef struct ASM_CALL_STRUCT {
 
-  TAC** labels;
-  char** names;    // Just so I can free the allocated names later
+  TAC* call;
   size_t size;
+  size_t collected;     // Parameters that were reached so far
+  bool regsChanged;     // Print only restores the saved registers when they could've changed
 
-} label_list;
+  register_T* savedRegs[GENERAL_REG_AMOUNT];
+
+} asm_call;
 
 typedef struct ASM_BACKEND_STRUCT {
 
   register_T** registers;
 
-  label_list* labelList;
+  char* labelName;          // Scratch buffer for the label name that is currently being emitted, it starts with the function's name
+  size_t labelPrefix;       // Length of the function's name and "_label" at the start of the buffer
+  unsigned int labelBase;   // Amount of labels numbered before the function, labels are named by their number in the function
 
   TAC* instruction;
 
+  asm_call* calls;      // Calls that wait for their parameters, the innermost one is last
+  size_t callsSize;
+  size_t callsCapacity;
+
   table_T* table;
 
-  FILE* targetProg;
+  emitter_T* output;    // Buffered Assembly output, written to the target file in big chunks
 
 } asm_frontend;
 
+/* A function that is generated on it's own, into it's own buffer */
+typedef struct ASM_FUNCTION_JOB_STRUCT {
+
+  TAC* function;        // AST_FUNCTION instruction of the function
+  table_T* table;       // Symbol table of the function
+
+  emitter_T* output;    // Generated code, NULL when the code came from the function cache
+  char* code;
+  size_t size;
+
+  uint64_t hash;
+
+} asm_function_job;
+
+/* State of a thread that generates functions */
+typedef struct ASM_WORKER_STRUCT {
+
+  table_T* globals;     // Copy of the global scope, so threads don't share the address descriptors of global variables
+  cache_key key;
+
+} asm_worker;
+
+typedef struct ASM_GENERATION_STRUCT {
+
+  asm_function_job* jobs;
+  size_t size;
+
+  asm_worker* workers;
+  unsigned int threads;
+
+  cache_functions* cache;   // NULL when the function cache isn't used
+
+} asm_generation;
+
 asm_frontend* init_asm_frontend(table_T* table, TAC* head, char* targetName);
 
-void write_asm(table_T* table, TAC* head, char* targetName);
+void write_asm(table_T* table, TAC* head, char* targetName, char* cacheName);
 void generate_asm(asm_frontend* frontend);
 void generate_global_vars(asm_frontend* frontend, TAC* triple);
 void descriptor_push(register_T* reg, arg_T* descriptor);
@@ -67,7 +116,9 @@ void free_registers(asm_frontend* frontend);
 void generate_var_dec(asm_frontend* frontend);
 void generate_binop(asm_frontend* frontend);
 void generate_mul_div(asm_frontend* frontend);
+void generate_shift(asm_frontend* frontend);
 void generate_condition(asm_frontend* frontend);
+void generate_condition_exit(asm_frontend* frontend);
 void generate_if_false(asm_frontend* frontend);
 void generate_unconditional_jump(asm_frontend* frontend);
 void generate_asm_block(asm_frontend* frontend);
@@ -77,9 +128,16 @@ void generate_assignment(asm_frontend* frontend);
 void generate_block_exit(asm_frontend* frontend);
 void generate_main(asm_frontend* frontend);
 void generate_function(asm_frontend* frontend);
+void generate_functions(asm_frontend* frontend, cache_functions* functions);
+void generate_function_job(void* context, size_t index, unsigned int worker);
+
+asm_function_job* generate_collect_functions(asm_frontend* frontend, size_t* size);
 void generate_return(asm_frontend* frontend);
 void generate_func_call(asm_frontend* frontend);
 void generate_print(asm_frontend* frontend);
+void generate_param(asm_frontend* frontend);
+void generate_print_param(asm_frontend* frontend, asm_call* pending);
+void generate_end_call(asm_frontend* frontend);
 void generate_spill(asm_frontend* frontend, register_T* r);
 void descriptor_reset(asm_frontend* frontend, register_T* r);
 void descriptor_reset_all_registers(asm_frontend* frontend);
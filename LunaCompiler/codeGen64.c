@@ -0,0 +1,926 @@
+#include "codeGen64.h"
+
+// Temporaries live in callee saved registers so they survive function calls without being saved
+static const int tempRegisters[X64_TEMP_REG_AMOUNT] = { X64_RBX, X64_R12, X64_R13, X64_R14, X64_R15 };
+
+// System V argument registers, in order
+static const int argRegisters[X64_ARG_REG_AMOUNT] = { X64_RDI, X64_RSI, X64_RDX, X64_RCX, X64_R8, X64_R9 };
+
+/*
+init_x64_frontend initializes the x86-64 frontend
+Input: Program symbol table, TAC list
+Output: Frontend
+*/
+x64_frontend* init_x64_frontend(table_T* table, TAC_list* list) {
+
+  x64_frontend* frontend = mcalloc(1, sizeof(x64_frontend));
+
+  frontend->program = init_x64_program();
+  frontend->table = table;
+  frontend->instruction = list->head;
+
+  // Label numbers start from 1
+  frontend->labelsSize = list->labels + 1;
+  frontend->labels = mcalloc(frontend->labelsSize, sizeof(int));
+  memset(frontend->labels, 0xFF, frontend->labelsSize * sizeof(int));    // Fill with X64_NO_LABEL
+
+  return frontend;
+}
+
+/*
+write_x64 is the main function of the x86-64 backend, it writes a GNU assembler file for Linux
+Input: Symbol table, TAC list, target name for the file we want to produce
+Output: None
+*/
+void write_x64(table_T* table, TAC_list* list, char* targetName) {
+
+  x64_program* program = generate64_program(table, list);
+  FILE* targetProg = fopen(targetName, "w");
+  emitter_T* output = NULL;
+
+  if (!targetProg) {
+    printf("[ERROR]: Couldn't open %s for writing", targetName); error_exit();
+  }
+
+  runtime64_build(program);
+
+  output = init_emitter(targetProg);
+  x64_write_gas(program, output);
+
+  emitter_free(output);
+  fclose(targetProg);
+  x64_free_program(program);
+}
+
+/*
+write_x64_elf encodes the machine code itself and writes an ELF file, so no assembler or linker is needed
+Input: Symbol table, TAC list, target name, true for a static executable or false for a relocatable object
+Output: None
+*/
+void write_x64_elf(table_T* table, TAC_list* list, char* targetName, bool executable) {
+
+  x64_program* program = generate64_program(table, list);
+  x64_object* object = NULL;
+
+  runtime64_build(program);
+  object = x64_encode(program);
+
+  if (executable) {
+    elf_write_executable(object, x64_find_symbol(program, RUNTIME_ENTRY), targetName);
+  }
+  else {
+    elf_write_object(object, targetName);
+  }
+
+  x64_free_object(object);
+  x64_free_program(program);
+}
+
+/*
+generate64_program lowers the whole TAC list to an x86-64 program, the caller adds the runtime it wants
+Input: Symbol table, TAC list
+Output: Program
+*/
+x64_program* generate64_program(table_T* table, TAC_list* list) {
+
+  x64_frontend* frontend = init_x64_frontend(table, list);
+  x64_program* program = frontend->program;
+  int mainLabel = 0;
+
+  frontend->table->tableIndex = 0;
+
+  // Outside of functions there can only be global variables
+  while (frontend->instruction) {
+
+    switch (frontend->instruction->op) {
+
+      case AST_FUNCTION:     generate64_function(frontend); break;
+      case AST_VARIABLE_DEC: generate64_global_var(frontend); break;
+      default: printf("[Error]: Global variables must be initialized with a constant"); error_exit();
+    }
+
+    frontend->instruction = frontend->instruction->next;
+  }
+
+  mainLabel = x64_find_symbol(program, "main");
+
+  if (mainLabel == X64_NO_LABEL || !program->labels[mainLabel].defined) {
+    printf("[Error]: No main file to start executing from"); error_exit();
+  }
+
+  free_x64_frontend(frontend);
+
+  return program;
+}
+
+/*
+generate64_instruction checks for the operation in a TAC instruction inside a function and lowers it
+Input: Frontend
+Output: None
+*/
+void generate64_instruction(x64_frontend* frontend) {
+
+  TAC* instruction = frontend->instruction;
+
+  if (traversal_is_comparison(instruction->op)) {
+    generate64_compare(frontend);
+    return;
+  }
+
+  switch (instruction->op) {
+
+    case TOKEN_LBRACE:
+      // Go to the fitting symbol table for the new block
+      frontend->table->tableIndex++;
+      frontend->table = frontend->table->nestedScopes[frontend->table->tableIndex - 1];
+      break;
+
+    case TOKEN_RBRACE:
+      frontend->table->tableIndex = 0;
+      frontend->table = frontend->table->prev;
+      generate64_free_all(frontend);
+      break;
+
+    case AST_ADD:
+    case AST_SUB:
+    case AST_BAND:
+    case AST_BOR:
+    case AST_XOR:           generate64_binop(frontend); break;
+    case AST_SHL:
+    case AST_SHR:           generate64_shift(frontend); break;
+    case AST_MUL:           generate64_mul(frontend); break;
+    case AST_DIV:           generate64_div(frontend); break;
+    case AST_VARIABLE_DEC:  generate64_var_dec(frontend); break;
+    case AST_FUNC_CALL:     generate64_func_call(frontend); break;
+    case AST_PRINT:         generate64_print(frontend); break;
+    case AST_PARAM:         generate64_param(frontend); break;
+
+    // Statements end the life of every temporary, which also frees results of calls that were never used
+    case AST_ASSIGNMENT:    generate64_assignment(frontend); generate64_free_all(frontend); break;
+    case AST_IFZ:           generate64_if_false(frontend); generate64_free_all(frontend); break;
+    case AST_RETURN:        generate64_return(frontend); generate64_free_all(frontend); break;
+
+    case AST_GOTO:
+      x64_push(frontend->program, X64_JMP, x64_label_operand(generate64_label(frontend, instruction->arg1->value)), x64_none());
+      break;
+
+    case AST_LABEL:
+    case AST_LOOP_LABEL:
+      generate64_free_all(frontend);
+      x64_define_label(frontend->program, generate64_label(frontend, instruction));
+      break;
+
+    case AST_ASM: x64_push_raw(frontend->program, instruction->arg1->value); break;
+  }
+}
+
+/*
+generate64_global_var adds a global variable to the data section, global variables are initialized by the assignment after them
+Input: Frontend
+Output: None
+*/
+void generate64_global_var(x64_frontend* frontend) {
+
+  TAC* assignment = frontend->instruction->next;
+  entry_T* entry = table_search_entry(frontend->table, frontend->instruction->arg1->value);
+  char* value = NULL;
+
+  if (!assignment || assignment->op != AST_ASSIGNMENT || assignment->arg2->type != CHAR_P) {
+    printf("[Error]: Global variable '%s' must be initialized with a constant", entry->name); error_exit();
+  }
+
+  value = assignment->arg2->value;
+
+  if (entry->dtype == DATA_STRING) {
+    x64_add_global(frontend->program, entry->name, 0, x64_add_string(frontend->program, value));
+  }
+  else if (isNum(value)) {
+    x64_add_global(frontend->program, entry->name, atoll(value), X64_NO_LABEL);
+  }
+  else {
+    printf("[Error]: Global variable '%s' must be initialized with a constant", entry->name); error_exit();
+  }
+
+  frontend->instruction = assignment;    // Skip the assignment
+}
+
+/*
+generate64_function generates a function, it's locals live in a stack frame addressed from RBP
+Input: Frontend
+Output: None
+*/
+void generate64_function(x64_frontend* frontend) {
+
+  x64_program* program = frontend->program;
+  TAC* previous = NULL;
+  TAC* last = NULL;
+  entry_T* entry = NULL;
+
+  size_t counter = atoi(frontend->instruction->next->arg1->value);
+  size_t saves = 0;
+  long offset = 0;
+
+  // Reset the state of the previous function
+  frontend->frameSize = 0;
+  frontend->tempsSize = 0;
+  memset(frontend->regBusy, 0, sizeof(frontend->regBusy));
+  memset(frontend->regSaved, 0, sizeof(frontend->regSaved));
+
+  frontend->epilogue = x64_new_label(program, X64_TEXT);
+  x64_define_label(program, x64_symbol(program, frontend->instruction->arg1->value, X64_TEXT));
+
+  x64_push(program, X64_PUSH, x64_reg_operand(X64_RBP), x64_none());
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RBP), x64_reg_operand(X64_RSP));
+
+  // The frame size and the saved registers are only known at the end of the function, so leave room for them
+  frontend->prologue = x64_push(program, X64_SUB, x64_reg_operand(X64_RSP), x64_imm(0));
+
+  for (unsigned int i = 0; i < X64_TEMP_REG_AMOUNT; i++) {
+    x64_push(program, X64_NOP, x64_none(), x64_none());
+  }
+
+  frontend->table->tableIndex++;
+  frontend->table = frontend->table->nestedScopes[frontend->table->tableIndex - 1];
+
+  // The first parameters arrive in registers and get a slot in the frame, the rest are already on the stack
+  for (unsigned int i = 0; i < counter; i++) {
+
+    entry = frontend->table->entries[i];
+
+    if (i < X64_ARG_REG_AMOUNT) {
+      entry->offset = generate64_alloc_slot(frontend);
+      x64_push(program, X64_MOV, x64_mem(X64_RBP, entry->offset), x64_reg_operand(argRegisters[i]));
+    }
+    else {
+      entry->offset = 2 * X64_SLOT_SIZE + (i - X64_ARG_REG_AMOUNT) * X64_SLOT_SIZE;    // Above the saved RBP and return address
+    }
+  }
+
+  // Skipping number of parameters and start of block
+  frontend->instruction = frontend->instruction->next->next->next;
+
+  while (frontend->instruction->op != TOKEN_FUNC_END) {
+
+    previous = last;
+    last = frontend->instruction;
+    generate64_instruction(frontend);
+    frontend->instruction = frontend->instruction->next;
+  }
+
+  // Functions that end without a return statement return 0
+  if (!previous || previous->op != AST_RETURN || last->op != TOKEN_RBRACE) {
+    x64_push(program, X64_XOR, x64_reg_operand(X64_RAX), x64_reg_operand(X64_RAX));
+  }
+
+  x64_define_label(program, frontend->epilogue);
+
+  // Fill in the saves of the callee saved registers we used and restore them
+  for (unsigned int i = 0; i < X64_TEMP_REG_AMOUNT; i++) {
+
+    if (!frontend->regSaved[tempRegisters[i]]) { continue; }
+
+    offset = generate64_alloc_slot(frontend);
+
+    program->instructions[frontend->prologue + 1 + saves].op = X64_MOV;
+    program->instructions[frontend->prologue + 1 + saves].dst = x64_mem(X64_RBP, offset);
+    program->instructions[frontend->prologue + 1 + saves].src = x64_reg_operand(tempRegisters[i]);
+    saves++;
+
+    x64_push(program, X64_MOV, x64_reg_operand(tempRegisters[i]), x64_mem(X64_RBP, offset));
+  }
+
+  x64_push(program, X64_LEAVE, x64_none(), x64_none());
+  x64_push(program, X64_RET, x64_none(), x64_none());
+
+  // Keep the stack aligned for the calls the function makes
+  frontend->frameSize = (frontend->frameSize + X64_STACK_ALIGNMENT - 1) / X64_STACK_ALIGNMENT * X64_STACK_ALIGNMENT;
+
+  if (frontend->frameSize) {
+    program->instructions[frontend->prologue].src = x64_imm(frontend->frameSize);
+  }
+  else {
+    program->instructions[frontend->prologue].op = X64_NOP;
+  }
+}
+
+/*
+generate64_var_dec gives a local variable a slot in the stack frame
+Input: Frontend
+Output: None
+*/
+void generate64_var_dec(x64_frontend* frontend) {
+
+  entry_T* entry = table_search_entry(frontend->table, frontend->instruction->arg1->value);
+  entry->offset = generate64_alloc_slot(frontend);
+}
+
+/*
+generate64_binop generates addition, subtraction and the bitwise operations, the result is computed in the register of the first operand
+when it is a temporary, so chains of operations don't move values around
+Input: Frontend
+Output: None
+*/
+void generate64_binop(x64_frontend* frontend) {
+
+  TAC* instruction = frontend->instruction;
+  x64_operand arg1 = generate64_operand(frontend, instruction->arg1);
+  x64_operand arg2 = generate64_operand(frontend, instruction->arg2);
+  int reg = 0;
+  int op = X64_ADD;
+
+  switch (instruction->op) {
+
+    case AST_SUB:  op = X64_SUB; break;
+    case AST_BAND: op = X64_AND; break;
+    case AST_BOR:  op = X64_OR; break;
+    case AST_XOR:  op = X64_XOR; break;
+  }
+
+  generate64_free(frontend, instruction->arg1);
+
+  reg = generate64_get_register(frontend, arg2.type == OPERAND_REG ? arg2.reg : -1);
+
+  if (arg1.type != OPERAND_REG || arg1.reg != reg) {
+    x64_push(frontend->program, X64_MOV, x64_reg_operand(reg), arg1);
+  }
+
+  x64_push(frontend->program, op, x64_reg_operand(reg), generate64_fit(frontend, arg2, X64_R11));
+
+  generate64_free(frontend, instruction->arg2);
+  generate64_set_temp(frontend, instruction, reg);
+}
+
+/*
+generate64_shift generates shifts, an amount that isn't a constant has to be in CL.
+RCX only holds arguments right before a call, so it's free while an expression is computed
+Input: Frontend
+Output: None
+*/
+void generate64_shift(x64_frontend* frontend) {
+
+  TAC* instruction = frontend->instruction;
+  x64_operand arg1 = generate64_operand(frontend, instruction->arg1);
+  x64_operand arg2 = generate64_operand(frontend, instruction->arg2);
+  int reg = 0;
+
+  // The processor only uses the lowest 6 bits of the amount
+  if (arg2.type == OPERAND_IMM) {
+    arg2.value &= 63;
+  }
+  else {
+    x64_push(frontend->program, X64_MOV, x64_reg_operand(X64_RCX), arg2);
+    arg2 = x64_reg_operand(X64_RCX);
+  }
+
+  generate64_free(frontend, instruction->arg1);
+  generate64_free(frontend, instruction->arg2);
+
+  reg = generate64_get_register(frontend, -1);
+
+  if (arg1.type != OPERAND_REG || arg1.reg != reg) {
+    x64_push(frontend->program, X64_MOV, x64_reg_operand(reg), arg1);
+  }
+
+  x64_push(frontend->program, instruction->op == AST_SHL ? X64_SHL : X64_SAR, x64_reg_operand(reg), arg2);
+
+  generate64_set_temp(frontend, instruction, reg);
+}
+
+/*
+generate64_mul generates multiplication
+Input: Frontend
+Output: None
+*/
+void generate64_mul(x64_frontend* frontend) {
+
+  TAC* instruction = frontend->instruction;
+  x64_operand arg1 = generate64_operand(frontend, instruction->arg1);
+  x64_operand arg2 = generate64_operand(frontend, instruction->arg2);
+  size_t index = 0;
+  int reg = 0;
+
+  generate64_free(frontend, instruction->arg1);
+
+  reg = generate64_get_register(frontend, arg2.type == OPERAND_REG ? arg2.reg : -1);
+
+  if (arg1.type != OPERAND_REG || arg1.reg != reg) {
+    x64_push(frontend->program, X64_MOV, x64_reg_operand(reg), arg1);
+  }
+
+  // Multiplying by a constant has it's own three operand form
+  if (arg2.type == OPERAND_IMM && x64_fits_imm32(arg2.value)) {
+    index = x64_push(frontend->program, X64_IMUL3, x64_reg_operand(reg), x64_reg_operand(reg));
+    frontend->program->instructions[index].imm = arg2.value;
+  }
+  else {
+    x64_push(frontend->program, X64_IMUL, x64_reg_operand(reg), generate64_fit(frontend, arg2, X64_R11));
+  }
+
+  generate64_free(frontend, instruction->arg2);
+  generate64_set_temp(frontend, instruction, reg);
+}
+
+/*
+generate64_div generates division, which always divides RDX:RAX
+Input: Frontend
+Output: None
+*/
+void generate64_div(x64_frontend* frontend) {
+
+  TAC* instruction = frontend->instruction;
+  x64_operand arg1 = generate64_operand(frontend, instruction->arg1);
+  x64_operand arg2 = generate64_operand(frontend, instruction->arg2);
+  int reg = 0;
+
+  x64_push(frontend->program, X64_MOV, x64_reg_operand(X64_RAX), arg1);
+  x64_push(frontend->program, X64_CQO, x64_none(), x64_none());
+
+  // IDIV can't divide by a constant
+  if (arg2.type == OPERAND_IMM) {
+    x64_push(frontend->program, X64_MOV, x64_reg_operand(X64_R11), arg2);
+    arg2 = x64_reg_operand(X64_R11);
+  }
+
+  x64_push(frontend->program, X64_IDIV, arg2, x64_none());
+
+  generate64_free(frontend, instruction->arg1);
+  generate64_free(frontend, instruction->arg2);
+
+  reg = generate64_get_register(frontend, -1);
+  x64_push(frontend->program, X64_MOV, x64_reg_operand(reg), x64_reg_operand(X64_RAX));
+  generate64_set_temp(frontend, instruction, reg);
+}
+
+/*
+generate64_compare generates a comparison, when it's the condition of the IFZ instruction that follows it, the IFZ jumps on the flags.
+Otherwise the flags are turned into 1 or 0
+Input: Frontend
+Output: None
+*/
+void generate64_compare(x64_frontend* frontend) {
+
+  TAC* instruction = frontend->instruction;
+  x64_operand arg1 = generate64_operand(frontend, instruction->arg1);
+  x64_operand arg2 = generate64_operand(frontend, instruction->arg2);
+  int reg = 0;
+
+  // CMP needs it's first operand in a register unless the second one is, and it can't be a constant
+  if (arg1.type == OPERAND_IMM || (arg1.type != OPERAND_REG && arg2.type != OPERAND_REG)) {
+    x64_push(frontend->program, X64_MOV, x64_reg_operand(X64_RAX), arg1);
+    arg1 = x64_reg_operand(X64_RAX);
+  }
+
+  x64_push(frontend->program, X64_CMP, arg1, generate64_fit(frontend, arg2, X64_R11));
+
+  generate64_free(frontend, instruction->arg1);
+  generate64_free(frontend, instruction->arg2);
+
+  if (traversal_is_condition(instruction)) { return; }
+
+  // Moves don't change the flags, so a temporary can still be spilled to get the register
+  reg = generate64_get_register(frontend, -1);
+
+  x64_push_setcc(frontend->program, generate64_condition(instruction->op), reg);
+  x64_push(frontend->program, X64_MOVZXB, x64_reg_operand(reg), x64_reg_operand(reg));
+
+  generate64_set_temp(frontend, instruction, reg);
+}
+
+/*
+generate64_if_false generates a jump for IFZ operations
+Input: Frontend
+Output: None
+*/
+void generate64_if_false(x64_frontend* frontend) {
+
+  TAC* instruction = frontend->instruction;
+  int label = generate64_label(frontend, instruction->arg2->value);
+  x64_operand value;
+
+  // The comparison right before us already set the flags, so jump if it was false
+  if (instruction->arg1->type == TAC_P && traversal_is_condition(instruction->arg1->value)) {
+    x64_push_jcc(frontend->program, x64_invert_cond(generate64_condition(((TAC*)instruction->arg1->value)->op)), label);
+    return;
+  }
+
+  value = generate64_operand(frontend, instruction->arg1);
+
+  // A constant condition is either always false or never false
+  if (value.type == OPERAND_IMM) {
+
+    if (!value.value) {
+      x64_push(frontend->program, X64_JMP, x64_label_operand(label), x64_none());
+    }
+  }
+  else {
+
+    value.type == OPERAND_REG ? x64_push(frontend->program, X64_TEST, value, value)
+      : x64_push(frontend->program, X64_CMP, value, x64_imm(0));
+
+    x64_push_jcc(frontend->program, X64_COND_E, label);
+  }
+
+  generate64_free(frontend, instruction->arg1);
+}
+
+/*
+generate64_assignment generates an assignment, string variables hold the address of their literal
+Input: Frontend
+Output: None
+*/
+void generate64_assignment(x64_frontend* frontend) {
+
+  TAC* instruction = frontend->instruction;
+  entry_T* entry = table_search_entry(frontend->table, instruction->arg1->value);
+  x64_operand variable = generate64_variable(frontend, entry);
+  x64_operand value;
+
+  if (entry->dtype == DATA_STRING && instruction->arg2->type == CHAR_P && !table_search_entry(frontend->table, instruction->arg2->value)) {
+    x64_push(frontend->program, X64_LEA, x64_reg_operand(X64_RAX), x64_rip(x64_add_string(frontend->program, instruction->arg2->value)));
+    x64_push(frontend->program, X64_MOV, variable, x64_reg_operand(X64_RAX));
+    return;
+  }
+
+  value = generate64_operand(frontend, instruction->arg2);
+
+  // There are no memory to memory moves, and memory can only get 32 bit constants
+  if (value.type == OPERAND_MEM || value.type == OPERAND_RIP || (value.type == OPERAND_IMM && !x64_fits_imm32(value.value))) {
+    x64_push(frontend->program, X64_MOV, x64_reg_operand(X64_RAX), value);
+    value = x64_reg_operand(X64_RAX);
+  }
+
+  x64_push(frontend->program, X64_MOV, variable, value);
+
+  generate64_free(frontend, instruction->arg2);
+}
+
+/*
+generate64_func_call starts a function call, it waits for it's parameters and is generated once the last one is reached
+Input: Frontend
+Output: None
+*/
+void generate64_func_call(x64_frontend* frontend) {
+
+  size_t size = atoi(frontend->instruction->arg2->value);
+  x64_call pending = { frontend->instruction, size, 0, mcalloc(size + 1, sizeof(arg_T*)) };
+
+  // The parameters can have calls in them, so they are kept on a stack instead of generating them here
+  vector_push(frontend->calls, frontend->callsSize, frontend->callsCapacity, pending);
+
+  if (!size) {
+    generate64_end_call(frontend);
+  }
+}
+
+/*
+generate64_print starts print, each parameter is printed with a call to the runtime as soon as we reach it
+Input: Frontend
+Output: None
+*/
+void generate64_print(x64_frontend* frontend) {
+
+  x64_call pending = { frontend->instruction, atoi(frontend->instruction->arg2->value), 0, NULL };
+
+  if (pending.size) {
+    vector_push(frontend->calls, frontend->callsSize, frontend->callsCapacity, pending);
+  }
+}
+
+/*
+generate64_param takes a parameter of the innermost pending call or print
+Input: Frontend
+Output: None
+*/
+void generate64_param(x64_frontend* frontend) {
+
+  x64_call* pending = &frontend->calls[frontend->callsSize - 1];
+
+  if (!pending->params) {
+    generate64_print_param(frontend, frontend->instruction->arg1);
+  }
+  else {
+    pending->params[pending->collected] = frontend->instruction->arg1;
+  }
+
+  if (++pending->collected == pending->size) {
+    generate64_end_call(frontend);
+  }
+}
+
+/*
+generate64_end_call generates the innermost pending call once it has all it's parameters
+The first arguments are passed in registers and the rest on the stack
+Input: Frontend
+Output: None
+*/
+void generate64_end_call(x64_frontend* frontend) {
+
+  x64_call pending = frontend->calls[--frontend->callsSize];
+  x64_program* program = frontend->program;
+  x64_operand value;
+
+  size_t size = pending.size;
+  size_t stack = size > X64_ARG_REG_AMOUNT ? size - X64_ARG_REG_AMOUNT : 0;
+  size_t padding = stack % 2;    // Keep the stack aligned to 16 bytes at the call
+  arg_T** params = pending.params;
+
+  int reg = 0;
+
+  if (!params) {
+    return;
+  }
+
+  // Parameters come from last to first, so the ones that go on the stack are first
+  if (padding) {
+    x64_push(program, X64_SUB, x64_reg_operand(X64_RSP), x64_imm(X64_SLOT_SIZE));
+  }
+
+  for (unsigned int i = 0; i < stack; i++) {
+    x64_push(program, X64_PUSH, generate64_fit(frontend, generate64_operand(frontend, params[i]), X64_R11), x64_none());
+  }
+
+  for (size_t i = stack; i < size; i++) {
+
+    value = generate64_operand(frontend, params[i]);
+    x64_push(program, X64_MOV, x64_reg_operand(argRegisters[size - 1 - i]), value);
+  }
+
+  for (unsigned int i = 0; i < size; i++) {
+    generate64_free(frontend, params[i]);
+  }
+
+  x64_push(program, X64_CALL, x64_label_operand(x64_symbol(program, pending.call->arg1->value, X64_TEXT)), x64_none());
+
+  if (stack) {
+    x64_push(program, X64_ADD, x64_reg_operand(X64_RSP), x64_imm((stack + padding) * X64_SLOT_SIZE));
+  }
+
+  // Move the result out of RAX so it survives the next calls
+  reg = generate64_get_register(frontend, -1);
+  x64_push(program, X64_MOV, x64_reg_operand(reg), x64_reg_operand(X64_RAX));
+  generate64_set_temp(frontend, pending.call, reg);
+
+  mfree(params);
+}
+
+/*
+generate64_print_param prints a single value with the fitting runtime function
+Input: Frontend, value to print
+Output: None
+*/
+void generate64_print_param(x64_frontend* frontend, arg_T* arg) {
+
+  x64_program* program = frontend->program;
+  entry_T* entry = arg->type == CHAR_P ? table_search_entry(frontend->table, arg->value) : NULL;
+  char* function = RUNTIME_PRINT_INT;
+
+  // String literals are printed from the read only data
+  if (arg->type == CHAR_P && !entry && !isNum(arg->value)) {
+    x64_push(program, X64_LEA, x64_reg_operand(X64_RDI), x64_rip(x64_add_string(program, arg->value)));
+    function = RUNTIME_PRINT_STRING;
+  }
+  else {
+
+    if (entry && entry->dtype == DATA_STRING) {
+      function = RUNTIME_PRINT_STRING;
+    }
+
+    x64_push(program, X64_MOV, x64_reg_operand(X64_RDI), generate64_operand(frontend, arg));
+    generate64_free(frontend, arg);
+  }
+
+  x64_push(program, X64_CALL, x64_label_operand(x64_symbol(program, function, X64_TEXT)), x64_none());
+}
+
+/*
+generate64_return generates a return, the value is returned in RAX
+Input: Frontend
+Output: None
+*/
+void generate64_return(x64_frontend* frontend) {
+
+  TAC* instruction = frontend->instruction;
+
+  x64_push(frontend->program, X64_MOV, x64_reg_operand(X64_RAX), generate64_operand(frontend, instruction->arg1));
+  generate64_free(frontend, instruction->arg1);
+
+  // A return at the end of the function can fall through to the exit code
+  if (!(instruction->next->op == TOKEN_RBRACE && instruction->next->next->op == TOKEN_FUNC_END)) {
+    x64_push(frontend->program, X64_JMP, x64_label_operand(frontend->epilogue), x64_none());
+  }
+}
+
+/*
+generate64_operand returns the operand that holds the value of a TAC argument
+Input: Frontend, argument
+Output: Operand
+*/
+x64_operand generate64_operand(x64_frontend* frontend, arg_T* arg) {
+
+  x64_temp* temp = NULL;
+  entry_T* entry = NULL;
+
+  if (arg->type == TAC_P || arg->type == TEMP_P) {
+
+    // Instructions without a value (such as print) evaluate to 0
+    temp = generate64_find_temp(frontend, arg->value);
+    return temp ? temp->location : x64_imm(0);
+  }
+
+  if ((entry = table_search_entry(frontend->table, arg->value))) {
+    return generate64_variable(frontend, entry);
+  }
+
+  return x64_imm(isNum(arg->value) ? atoll(arg->value) : 0);
+}
+
+/*
+generate64_variable returns the memory operand of a variable
+Input: Frontend, symbol table entry of the variable
+Output: Operand
+*/
+x64_operand generate64_variable(x64_frontend* frontend, entry_T* entry) {
+  return entry->offset ? x64_mem(X64_RBP, entry->offset) : x64_rip(x64_symbol(frontend->program, entry->name, X64_DATA));
+}
+
+/*
+generate64_fit makes sure an operand can be used as the source of an arithmetic instruction,
+constants that don't fit in 32 bits are moved to a scratch register first
+Input: Frontend, operand, scratch register
+Output: Usable operand
+*/
+x64_operand generate64_fit(x64_frontend* frontend, x64_operand operand, int scratch) {
+
+  if (operand.type == OPERAND_IMM && !x64_fits_imm32(operand.value)) {
+    x64_push(frontend->program, X64_MOV, x64_reg_operand(scratch), operand);
+    operand = x64_reg_operand(scratch);
+  }
+
+  return operand;
+}
+
+/*
+generate64_get_register finds a free temporary register, spilling a temporary to the stack frame if all of them are taken
+Input: Frontend, register that must not be spilled (-1 for none)
+Output: Register
+*/
+int generate64_get_register(x64_frontend* frontend, int keep) {
+
+  x64_temp* temp = NULL;
+  int reg = 0;
+
+  for (unsigned int i = 0; i < X64_TEMP_REG_AMOUNT; i++) {
+
+    if (!frontend->regBusy[tempRegisters[i]]) {
+
+      frontend->regBusy[tempRegisters[i]] = true;
+      frontend->regSaved[tempRegisters[i]] = true;
+
+      return tempRegisters[i];
+    }
+  }
+
+  // Move the oldest temporary that is in a register to the stack frame
+  for (size_t i = 0; i < frontend->tempsSize; i++) {
+
+    temp = &frontend->temps[i];
+
+    if (temp->location.type != OPERAND_REG || temp->location.reg == keep) { continue; }
+
+    reg = temp->location.reg;
+    temp->location = x64_mem(X64_RBP, generate64_alloc_slot(frontend));
+
+    stats_add(STATS_SPILLS, 1);
+
+    x64_push(frontend->program, X64_MOV, temp->location, x64_reg_operand(reg));
+
+    return reg;
+  }
+
+  printf("[Error]: Ran out of registers"); error_exit();
+}
+
+/*
+generate64_set_temp records that a register holds the result of an instruction
+Input: Frontend, instruction, register
+Output: None
+*/
+void generate64_set_temp(x64_frontend* frontend, TAC* instruction, int reg) {
+
+  vector_reserve(frontend->temps, frontend->tempsCapacity, frontend->tempsSize + 1);
+
+  frontend->temps[frontend->tempsSize].tac = instruction;
+  frontend->temps[frontend->tempsSize].location = x64_reg_operand(reg);
+  frontend->tempsSize++;
+
+  frontend->regBusy[reg] = true;
+}
+
+/*
+generate64_find_temp searches the temporary that holds the result of an instruction
+Input: Frontend, instruction
+Output: Temporary, NULL if the instruction has no value
+*/
+x64_temp* generate64_find_temp(x64_frontend* frontend, TAC* instruction) {
+
+  for (size_t i = 0; i < frontend->tempsSize; i++) {
+
+    if (frontend->temps[i].tac == instruction) {
+      return &frontend->temps[i];
+    }
+  }
+
+  return NULL;
+}
+
+/*
+generate64_free ends the life of a temporary once it's value was used
+Input: Frontend, argument that was used
+Output: None
+*/
+void generate64_free(x64_frontend* frontend, arg_T* arg) {
+
+  x64_temp* temp = NULL;
+
+  if (arg->type != TAC_P && arg->type != TEMP_P) { return; }
+
+  if (!(temp = generate64_find_temp(frontend, arg->value))) { return; }
+
+  if (temp->location.type == OPERAND_REG) {
+    frontend->regBusy[temp->location.reg] = false;
+  }
+
+  // Keep the order of the rest so the oldest temporary is always spilled first
+  memmove(temp, temp + 1, (frontend->tempsSize - (temp - frontend->temps) - 1) * sizeof(x64_temp));
+  frontend->tempsSize--;
+}
+
+/*
+generate64_free_all frees all temporaries
+Input: Frontend
+Output: None
+*/
+void generate64_free_all(x64_frontend* frontend) {
+
+  frontend->tempsSize = 0;
+
+  for (unsigned int i = 0; i < X64_TEMP_REG_AMOUNT; i++) {
+    frontend->regBusy[tempRegisters[i]] = false;
+  }
+}
+
+/*
+generate64_alloc_slot allocates an 8 byte slot in the stack frame of the current function
+Input: Frontend
+Output: Offset of the slot from RBP
+*/
+long generate64_alloc_slot(x64_frontend* frontend) {
+
+  frontend->frameSize += X64_SLOT_SIZE;
+  return -frontend->frameSize;
+}
+
+/*
+generate64_label returns the program label of a TAC label, creating it when it's first used
+Input: Frontend, label instruction
+Output: Program label
+*/
+int generate64_label(x64_frontend* frontend, TAC* label) {
+
+  if (frontend->labels[label->label] == X64_NO_LABEL) {
+    frontend->labels[label->label] = x64_new_label(frontend->program, X64_TEXT);
+  }
+
+  return frontend->labels[label->label];
+}
+
+/*
+generate64_condition converts a comparison operation to the condition that is true when the comparison is true
+Input: Comparison operation
+Output: Condition
+*/
+int generate64_condition(int op) {
+
+  switch (op) {
+
+    case TOKEN_LESS:   return X64_COND_L;
+    case TOKEN_MORE:   return X64_COND_G;
+    case TOKEN_ELESS:  return X64_COND_LE;
+    case TOKEN_EMORE:  return X64_COND_GE;
+    case TOKEN_DEQUAL: return X64_COND_E;
+    default:           return X64_COND_NE;
+  }
+}
+
+/*
+free_x64_frontend frees the frontend, but not the program it generated
+Input: Frontend
+Output: None
+*/
+void free_x64_frontend(x64_frontend* frontend) {
+
+  mfree(frontend->labels);
+  mfree(frontend->calls);
+  mfree(frontend->temps);
+  mfree(frontend);
+}
@@ -0,0 +1,111 @@
+#ifndef CODEGEN64_H
+#define CODEGEN64_H
+
+#include "TAC.h"
+#include "x64.h"
+#include "runtime64.h"
+#include "elf.h"
+
+#define X64_TEMP_REG_AMOUNT 5
+#define X64_ARG_REG_AMOUNT 6
+#define X64_SLOT_SIZE 8
+#define X64_STACK_ALIGNMENT 16
+
+/* What the compiler produces from a program */
+typedef enum OUTPUT_ENUM {
+
+  OUTPUT_MASM,          // MASM Assembly, assembled and linked with the MASM32 sdk
+  OUTPUT_GAS,           // x86-64 GNU assembler source, assembled and linked with as and ld
+  OUTPUT_ELF,           // x86-64 static Linux executable, written directly
+  OUTPUT_ELF_OBJECT,    // x86-64 relocatable ELF object, written directly
+  OUTPUT_JIT,           // x86-64 machine code that runs inside the compiler, nothing is written
+  OUTPUT_VM,            // Bytecode that runs in the VM inside the compiler, on any host
+
+} output_T;
+
+typedef struct X64_TEMP_STRUCT {
+
+  TAC* tac;
+  x64_operand location;    // Register or spill slot that holds the result of the instruction
+
+} x64_temp;
+
+/* A call or print whose parameters are still being generated, calls in it's parameters are pending on top of it */
+typedef struct X64_CALL_STRUCT {
+
+  TAC* call;
+  size_t size;
+  size_t collected;     // Parameters that were reached so far
+  arg_T** params;       // NULL for print, it prints each parameter as soon as we reach it
+
+} x64_call;
+
+typedef struct X64_FRONTEND_STRUCT {
+
+  x64_program* program;
+
+  TAC* instruction;
+
+  table_T* table;
+
+  int* labels;               // Program label of every TAC label, indexed by the label number the TAC got
+  unsigned int labelsSize;
+
+  x64_call* calls;           // Calls that wait for their parameters, the innermost one is last
+  size_t callsSize;
+  size_t callsCapacity;
+
+  x64_temp* temps;           // Temporaries that are currently alive
+  size_t tempsSize;
+  size_t tempsCapacity;
+
+  bool regBusy[X64_REG_AMOUNT];     // Temporary registers that currently hold a value
+  bool regSaved[X64_REG_AMOUNT];    // Callee saved registers the current function used and has to restore
+
+  long frameSize;
+  size_t prologue;           // Index of the stack allocation instruction, patched once the function is done
+  int epilogue;              // Label of the function exit code
+
+} x64_frontend;
+
+x64_frontend* init_x64_frontend(table_T* table, TAC_list* list);
+x64_program* generate64_program(table_T* table, TAC_list* list);
+
+x64_operand generate64_operand(x64_frontend* frontend, arg_T* arg);
+x64_operand generate64_variable(x64_frontend* frontend, entry_T* entry);
+x64_operand generate64_fit(x64_frontend* frontend, x64_operand operand, int scratch);
+
+void write_x64(table_T* table, TAC_list* list, char* targetName);
+void write_x64_elf(table_T* table, TAC_list* list, char* targetName, bool executable);
+void generate64_instruction(x64_frontend* frontend);
+void generate64_global_var(x64_frontend* frontend);
+void generate64_function(x64_frontend* frontend);
+void generate64_var_dec(x64_frontend* frontend);
+void generate64_binop(x64_frontend* frontend);
+void generate64_shift(x64_frontend* frontend);
+void generate64_mul(x64_frontend* frontend);
+void generate64_div(x64_frontend* frontend);
+void generate64_compare(x64_frontend* frontend);
+void generate64_if_false(x64_frontend* frontend);
+void generate64_assignment(x64_frontend* frontend);
+void generate64_func_call(x64_frontend* frontend);
+void generate64_print(x64_frontend* frontend);
+void generate64_param(x64_frontend* frontend);
+void generate64_end_call(x64_frontend* frontend);
+void generate64_print_param(x64_frontend* frontend, arg_T* arg);
+void generate64_return(x64_frontend* frontend);
+void generate64_set_temp(x64_frontend* frontend, TAC* instruction, int reg);
+void generate64_free(x64_frontend* frontend, arg_T* arg);
+void generate64_free_all(x64_frontend* frontend);
+void free_x64_frontend(x64_frontend* frontend);
+
+x64_temp* generate64_find_temp(x64_frontend* frontend, TAC* instruction);
+
+int generate64_get_register(x64_frontend* frontend, int keep);
+int generate64_label(x64_frontend* frontend, TAC* label);
+int generate64_condition(int op);
+
+long generate64_alloc_slot(x64_frontend* frontend);
+
+
+#endif
@@ -0,0 +1,179 @@
+# Compile check: compiles inputs that broke the compiler before and checks what it made, like the names of the files
+# it writes in batch mode. Linux and other Unix systems only.
+# Run it with the compiler that was built: python compileCheck.py --compiler ./LunaCompiler
+
+import argparse
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import tempfile
+
+from benchmark import Program
+
+# Output file of the backends that write one, MASM is the backend without a flag
+EXTENSIONS = {"": ".asm", "-x64": ".s", "-obj": ".o"}
+
+# Nesting of the calls in the deep calls check, deeper than the stack of the compiler allows for recursion
+CALL_DEPTH = 40000
+
+
+def compile_batch(compiler, directory, files, backend):
+    """Compiles files in batch mode from a directory, returns the exit code"""
+
+    return subprocess.run([compiler, "-j", "2"] + files + ([backend] if backend else []), cwd=directory,
+                          stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL).returncode
+
+
+def read(path):
+    """Returns the contents of a file, None if it doesn't exist"""
+
+    if not os.path.exists(path):
+        return None
+
+    with open(path, "rb") as file:
+        return file.read()
+
+
+def check_batch_paths(compiler, directory):
+    """Compiles files given with relative paths ("./", "../" and a directory with a dot in it's name) in one batch, every
+    output has to be next to it's source file and be the same as compiling the file alone"""
+
+    failures = []
+    work = os.path.join(directory, "work")
+    files = ["./one.luna", "../other/two.luna", "./sub.dir/three.luna"]
+
+    for index, file in enumerate(files):
+        path = os.path.normpath(os.path.join(work, file))
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+
+        with open(path, "w", encoding="utf-8") as source:
+            source.write(Program("english").generate(4 * (index + 1), 1, 1, 2, 1))
+
+    for backend, extension in EXTENSIONS.items():
+
+        if compile_batch(compiler, work, files, backend):
+            failures.append("batch %s: the batch failed" % (backend or "MASM"))
+
+        batch = [read(os.path.normpath(os.path.join(work, os.path.splitext(file)[0] + extension))) for file in files]
+
+        for file, output in zip(files, batch):
+            path = os.path.normpath(os.path.join(work, file))
+
+            compile_batch(compiler, work, [path], backend)
+
+            if output is None or output != read(os.path.splitext(path)[0] + extension):
+                failures.append("batch %s: %s didn't get it's own output" % (backend or "MASM", file))
+
+        if read(os.path.join(work, extension)) is not None:
+            failures.append("batch %s: an output without a name was written" % (backend or "MASM"))
+
+    return failures
+
+
+def check_batch_errors(compiler, directory):
+    """Compiles a batch where some files have errors, the other files still have to compile, the batch has to fail, and
+    nothing is assembled, linked or left behind for the files with errors"""
+
+    failures = []
+    good = ["one.luna", "two.luna", "three.luna"]
+    bad = ["syntax.luna", "missing.luna", "notes.txt"]
+
+    for index, file in enumerate(good):
+        with open(os.path.join(directory, file), "w", encoding="utf-8") as source:
+            source.write(Program("english").generate(4 * (index + 1), 1, 1, 2, 1))
+
+    with open(os.path.join(directory, "syntax.luna"), "w", encoding="utf-8") as source:
+        source.write("int main() {\n  int x = ;\n  return 0;\n}\n")
+
+    with open(os.path.join(directory, "notes.txt"), "w", encoding="utf-8") as source:
+        source.write("int main() {\n  return 0;\n}\n")
+
+    for backend in ("-x64", "-obj"):
+        extension = EXTENSIONS[backend]
+
+        if not compile_batch(compiler, directory, bad[:1] + good + bad[1:], backend):
+            failures.append("errors %s: the batch didn't fail" % backend)
+
+        for file in good:
+            name = os.path.splitext(file)[0]
+
+            if read(os.path.join(directory, name + extension)) is None:
+                failures.append("errors %s: %s didn't compile" % (backend, file))
+
+            if read(os.path.join(directory, name)) is not None:
+                failures.append("errors %s: %s was linked" % (backend, file))
+
+        if read(os.path.join(directory, "syntax" + extension)) is not None:
+            failures.append("errors %s: the file with an error has an output" % backend)
+
+    return failures
+
+
+def check_deep_calls(compiler, directory):
+    """Compiles calls nested CALL_DEPTH times as arguments of each other, as an initializer, a statement and inside
+    print, every backend that can run the program here has to print the right values"""
+
+    failures = []
+    source = os.path.join(directory, "deep.luna")
+    expected = b"%d\n%d\n" % (CALL_DEPTH + 1, 2 * CALL_DEPTH + 1)
+    backends = ["-vm", "-obj"]
+
+    with open(source, "w", encoding="utf-8") as file:
+        file.write("int f(int a) {\n  return a + 1;\n}\nint main() {\n")
+        file.write("  int x = %s1%s;\n  print(x, \"\\n\");\n" % ("f(" * CALL_DEPTH, ")" * CALL_DEPTH))
+        file.write("  %s1%s;\n" % ("f(" * CALL_DEPTH, ")" * CALL_DEPTH))
+        file.write("  print(%s1%s, \"\\n\");\n  return 0;\n}\n" % ("1 + f(" * CALL_DEPTH, ")" * CALL_DEPTH))
+
+    # The x86-64 backends that run what they made only work on x86-64 Linux
+    if sys.platform.startswith("linux") and platform.machine() in ("x86_64", "AMD64"):
+        backends += ["-run", "-elf"]
+
+    for backend in backends:
+
+        result = subprocess.run([compiler, source, backend], cwd=directory, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+        output = result.stdout
+
+        if backend == "-elf" and not result.returncode:
+            result = subprocess.run([os.path.splitext(source)[0]], cwd=directory, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+            output = result.stdout
+
+        if result.returncode:
+            failures.append("deep calls %s: exit code %d" % (backend, result.returncode))
+        elif backend != "-obj" and not output.endswith(expected):
+            failures.append("deep calls %s: the program printed the wrong values" % backend)
+
+    return failures
+
+
+CHECKS = [check_batch_paths, check_batch_errors, check_deep_calls]
+
+
+def main():
+
+    here = os.path.dirname(os.path.abspath(__file__))
+
+    arguments = argparse.ArgumentParser(description="Compiles inputs that broke the compiler before and checks the results")
+    arguments.add_argument("--compiler", default=os.path.join(here, "LunaCompiler"))
+    options = arguments.parse_args()
+
+    compiler = os.path.abspath(options.compiler)
+    failures = []
+
+    for check in CHECKS:
+
+        directory = tempfile.mkdtemp(prefix="lunaCheck")
+        failures += check(compiler, directory)
+        shutil.rmtree(directory, ignore_errors=True)
+
+    for failure in failures:
+        print("Failed: " + failure)
+
+    print("%d checks, %d failures" % (len(CHECKS), len(failures)))
+
+    sys.exit(1 if failures else 0)
+
+
+if __name__ == "__main__":
+    main()
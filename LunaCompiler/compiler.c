@@ -0,0 +1,387 @@
+#include "compiler.h"
+
+/*
+compile_file reads a source file and compiles it to the output the options ask for
+Input: Name of the source file, compile options
+Output: The value the program returned, when it ran inside the compiler
+*/
+long long compile_file(char* sourceName, compile_options* options) {
+
+  FILE* file = NULL;
+
+  char* contents = NULL;
+
+  long long result = 0;
+
+  if (strcmp(get_filename_ext(sourceName), "luna")) {
+    printf("[ERROR]: Unrecognized file extention\n"); error_exit();
+  }
+
+  if (!(file = fopen(sourceName, "r"))) {    // Read file
+    printf("[ERROR]: File does not exist\n"); error_exit();
+  }
+
+  stats_switch(STATS_READ);
+  
+  contents = read_file(file);             // Read contents of file
+
+  if (!contents) {
+    printf("[ERROR]: Couldn't read file contents"); error_exit();
+  }
+
+  result = compile_source(sourceName, contents, options);
+
+  mfree(contents);
+
+  return result;
+}
+
+/*
+compile_source compiles source code to the output the options ask for
+Input: Name of the source file (the output and cache files are named after it), source code, compile options
+Output: The value the program returned, when it ran inside the compiler
+*/
+long long compile_source(char* sourceName, char* contents, compile_options* options) {
+
+  char* newFilename = NULL;
+
+  long long result = 0;
+
+  lexer_T* lexer = NULL;
+  parser_T* parser = NULL;
+  AST* root = NULL;
+  TAC_list* instructions = NULL;
+  table_T* table = NULL;
+
+  char* cacheFilename = NULL;
+  char* functionsFilename = NULL;
+  cache_T* cache = NULL;
+  uint64_t hash = 0;
+
+  newFilename = compile_output_filename(sourceName, options->output);
+  
+  // An unchanged file can skip straight to code generation with the IR from it's cache file
+  if (options->useCache) {
+    stats_switch(STATS_CACHE);
+    hash = hash_bytes(contents, strlen(contents));
+    cacheFilename = make_new_filename(sourceName, ".lunac");
+    functionsFilename = make_new_filename(sourceName, ".lunaf");
+    cache = cache_load(cacheFilename, hash);
+  }
+
+  if (cache) {
+    instructions = cache->list;
+    table = cache->table;
+  }
+  else {
+    stats_switch(STATS_PARSE);
+    lexer = init_lexer(contents);           // Initialize lexer
+    parser = init_parser(lexer);            // Initialize Parser
+    root = parser_parse(parser);            // Parse the tokens into an AST
+    stats_switch(STATS_IR);
+    instructions = traversal_visit(root);   // Visit the AST and generate an intermidiate representation
+    table = parser->table;
+
+    if (options->useCache) {
+      stats_switch(STATS_CACHE);
+      cache_write(cacheFilename, hash, table, instructions);
+    }
+  }
+
+  //table_print_table(parser->table, 0);
+  if (options->printIR) {
+    traversal_print_instructions(instructions);
+  }
+
+  result = compile_instructions(table, instructions, options, newFilename, functionsFilename);
+
+  stats_switch(STATS_FREE);
+
+  // Free everything
+  if (cache) {
+    cache_free(cache);
+  }
+  else {
+    lexer_free_tokens(lexer);
+    parser_free_chunks(parser);
+    AST_free_AST(root);
+    traversal_free_array(instructions);
+    table_free_table(parser->table);
+    mfree(lexer);
+    mfree(parser);
+  }
+
+  mfree(cacheFilename);
+  mfree(functionsFilename);
+  mfree(newFilename);
+
+  stats_switch(STATS_NONE);
+
+  return result;
+}
+
+/*
+compile_document compiles a document that is already parsed, the document can't be compiled again after it
+since the backends change it's symbol tables
+Input: Name of the source file, document, compile options
+Output: The value the program returned, when it ran inside the compiler
+*/
+long long compile_document(char* sourceName, document_T* document, compile_options* options) {
+
+  char* newFilename = compile_output_filename(sourceName, options->output);
+  char* functionsFilename = options->useCache ? make_new_filename(sourceName, ".lunaf") : NULL;
+
+  long long result = 0;
+
+  TAC_list* instructions = NULL;
+
+  stats_switch(STATS_IR);
+  instructions = traversal_visit(document->root);
+
+  if (options->printIR) {
+    traversal_print_instructions(instructions);
+  }
+
+  result = compile_instructions(document->parser->table, instructions, options, newFilename, functionsFilename);
+
+  stats_switch(STATS_FREE);
+
+  traversal_free_array(instructions);
+
+  mfree(functionsFilename);
+  mfree(newFilename);
+
+  stats_switch(STATS_NONE);
+
+  return result;
+}
+
+/*
+compile_instructions makes the output the options ask for out of the IR of a program
+Input: Global symbol table, IR, compile options, name of the output file, name of the function cache file (NULL without -cache)
+Output: The value the program returned, when it ran inside the compiler
+*/
+long long compile_instructions(table_T* table, TAC_list* instructions, compile_options* options, char* newFilename, char* functionsFilename) {
+
+  long long result = 0;
+
+  bc_program* program = NULL;
+
+  stats_switch(STATS_BACKEND);
+
+  // Write the Assembly code from the given IR
+  switch (options->output) {
+
+    case OUTPUT_MASM:
+      write_asm(table, instructions->head, newFilename, functionsFilename);
+
+      if (options->assemble) {
+        stats_switch(STATS_RUN);
+        assemble_file(newFilename);
+      }
+
+      break;
+
+    case OUTPUT_GAS:
+      write_x64(table, instructions, newFilename);
+
+      if (options->assemble) {
+        stats_switch(STATS_RUN);
+        assemble_file_x64(newFilename);
+      }
+
+      break;
+
+    case OUTPUT_ELF:
+      write_x64_elf(table, instructions, newFilename, true);
+
+      if (options->assemble) {
+        stats_switch(STATS_RUN);
+        run_file(newFilename);
+      }
+
+      break;
+
+    case OUTPUT_ELF_OBJECT: write_x64_elf(table, instructions, newFilename, false); break;
+    case OUTPUT_JIT:        result = jit_run(table, instructions); break;
+
+    case OUTPUT_VM:
+      program = bytecode_lower(table, instructions);
+      stats_switch(STATS_RUN);
+      result = vm_run(program);
+      bytecode_free_program(program);
+      break;
+  }
+
+  return result;
+}
+
+/*
+compile_output_filename makes the name of the file the compiler writes for a source file
+Input: Name of the source file, kind of output
+Output: The code filename with the extention of the output
+*/
+char* compile_output_filename(char* sourceName, int output) {
+
+  // Extention of the file the compiler writes for every kind of output
+  const char* const extentions[] = { ".asm", ".s", "", ".o", "", "" };
+
+  return make_new_filename(sourceName, extentions[output]);
+}
+
+/*
+compile_parse_flag applies an optional flag to the compile options
+Input: Compile options, flag
+Output: False if the flag isn't known
+*/
+bool compile_parse_flag(compile_options* options, char* flag) {
+
+  if (!strcmp(flag, "-x64"))        { options->output = OUTPUT_GAS; }
+  else if (!strcmp(flag, "-elf"))   { options->output = OUTPUT_ELF; }
+  else if (!strcmp(flag, "-obj"))   { options->output = OUTPUT_ELF_OBJECT; }
+  else if (!strcmp(flag, "-run"))   { options->output = OUTPUT_JIT; }
+  else if (!strcmp(flag, "-vm"))    { options->output = OUTPUT_VM; }
+  else if (!strcmp(flag, "-cache")) { options->useCache = true; }
+  else if (!strcmp(flag, "-stats")) { stats_enable(false); }
+  else if (!strcmp(flag, "-stats=json")) { stats_enable(true); }
+  else if (!strcmp(flag, "-allocs")) { allocations_enable(); }
+  else if (!strcmp(flag, "-e"))     { }    // Source code in English or Hebrew, the lexer reads both
+  else if (!strcmp(flag, "-h"))     { }
+  else { return false; }
+
+  return true;
+}
+
+/*
+batch_add_file adds a file to the files of a batch
+Input: Batch, filename
+Output: None
+*/
+void batch_add_file(batch_T* batch, char* filename) {
+
+  char* file = mcalloc(strlen(filename) + 1, sizeof(char));
+
+  strcpy(file, filename);
+  vector_push(batch->files, batch->size, batch->capacity, file);
+}
+
+/*
+batch_read_response_file adds every file that is listed in a response file to a batch, the names are separated by whitespace
+Input: Batch, name of the response file
+Output: None
+*/
+void batch_read_response_file(batch_T* batch, char* filename) {
+
+  FILE* file = fopen(filename, "r");
+  char* contents = NULL;
+  char* name = NULL;
+
+  if (!file || !(contents = read_file(file))) {
+    printf("[ERROR]: Couldn't read response file %s\n", filename); exit(1);
+  }
+
+  for (name = strtok(contents, " \t\r\n"); name; name = strtok(NULL, " \t\r\n")) {
+    batch_add_file(batch, name);
+  }
+
+  mfree(contents);
+}
+
+/*
+batch_compile compiles all the files of a batch on a pool of threads, biggest files first
+Input: Batch, amount of threads
+Output: Amount of files that had an error
+*/
+size_t batch_compile(batch_T* batch, unsigned int threads) {
+
+  long* sizes = mcalloc(batch->size + 1, sizeof(long));
+  FILE* file = NULL;
+  size_t index = 0;
+  size_t failed = 0;
+
+  batch->order = mcalloc(batch->size + 1, sizeof(size_t));
+  batch->failed = mcalloc(batch->size + 1, sizeof(bool));
+
+  for (size_t i = 0; i < batch->size; i++) {
+
+    if ((file = fopen(batch->files[i], "r"))) {
+      fseek(file, 0, SEEK_END);
+      sizes[i] = ftell(file);
+      fclose(file);
+    }
+
+    // Insertion sort, batches are small enough
+    for (index = i; index && sizes[batch->order[index - 1]] < sizes[i]; index--) {
+      batch->order[index] = batch->order[index - 1];
+    }
+
+    batch->order[index] = i;
+  }
+
+  // Every thread already compiles a file, so the compilation of a file doesn't use more threads.
+  // An error can only jump back to the file's job on the thread that runs it, so a file alone in the batch is the only one that can use more
+  if (threads > 1 || batch->size > 1) {
+    pool_set_default_threads(1);
+  }
+
+  pool_run(threads, batch->size, batch_job, batch);
+
+  for (size_t i = 0; i < batch->size; i++) {
+    failed += batch->failed[i];
+  }
+
+  mfree(sizes);
+
+  return failed;
+}
+
+/*
+batch_job compiles one file of a batch, it runs on a thread of the pool
+Input: Batch, index of the file in the order of compilation, index of the thread
+Output: None
+*/
+void batch_job(void* context, size_t index, unsigned int worker) {
+
+  batch_T* batch = context;
+  size_t file = batch->order[index];
+  char* output = NULL;
+  jmp_buf jump;
+
+  // An error in the source code jumps back here, so only this file stops and the other threads keep compiling theirs
+  errorJump = &jump;
+
+  if (!setjmp(jump)) {
+    compile_file(batch->files[file], batch->options);
+  }
+  else {
+    printf("\n[ERROR]: %s didn't compile\n", batch->files[file]);
+    batch->failed[file] = true;
+
+    // What the file's output had before the error isn't a whole program, a build shouldn't find it
+    if (!strcmp(get_filename_ext(batch->files[file]), "luna") && batch->options->output != OUTPUT_JIT && batch->options->output != OUTPUT_VM) {
+      output = compile_output_filename(batch->files[file], batch->options->output);
+      remove(output);
+      mfree(output);
+    }
+
+    stats_switch(STATS_NONE);
+  }
+
+  errorJump = NULL;
+}
+
+/*
+batch_free frees the files of a batch
+Input: Batch
+Output: None
+*/
+void batch_free(batch_T* batch) {
+
+  for (size_t i = 0; i < batch->size; i++) {
+    mfree(batch->files[i]);
+  }
+
+  mfree(batch->files);
+  mfree(batch->order);
+  mfree(batch->failed);
+}
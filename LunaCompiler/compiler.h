@@ -0,0 +1,49 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+#include "codeGen.h"
+#include "codeGen64.h"
+#include "jit.h"
+#include "vm.h"
+#include "cache.h"
+#include "document.h"
+
+/* How a file is compiled, set by the flags that come after the file names */
+typedef struct COMPILE_OPTIONS_STRUCT {
+
+  int output;       // Kind of output, see output_T
+  bool useCache;
+  bool printIR;     // Print the TAC of the program, only done for single files
+  bool assemble;    // Assemble, link and run the output after writing it, like the compiler always did
+
+} compile_options;
+
+/* Files that are compiled in one process, with a thread pool */
+typedef struct BATCH_STRUCT {
+
+  char** files;
+  size_t size;
+  size_t capacity;
+
+  size_t* order;    // Files from the biggest to the smallest, so a big file doesn't start last
+  bool* failed;     // Files that had an error
+
+  compile_options* options;
+
+} batch_T;
+
+long long compile_file(char* sourceName, compile_options* options);
+long long compile_source(char* sourceName, char* contents, compile_options* options);
+long long compile_document(char* sourceName, document_T* document, compile_options* options);
+long long compile_instructions(table_T* table, TAC_list* instructions, compile_options* options, char* newFilename, char* functionsFilename);
+
+char* compile_output_filename(char* sourceName, int output);
+
+bool compile_parse_flag(compile_options* options, char* flag);
+
+void batch_add_file(batch_T* batch, char* filename);
+void batch_read_response_file(batch_T* batch, char* filename);
+size_t batch_compile(batch_T* batch, unsigned int threads);
+void batch_job(void* context, size_t index, unsigned int worker);
+void batch_free(batch_T* batch);
+
+#endif
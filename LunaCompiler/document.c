@@ -0,0 +1,204 @@
+#include "document.h"
+
+/*
+init_document makes a document out of source code and parses it
+Input: Source code, amount of bytes
+Output: Document
+*/
+document_T* init_document(const char* contents, size_t size) {
+
+  document_T* document = mcalloc(1, sizeof(document_T));
+
+  document->capacity = size + 1;
+  document->contents = mcalloc(document->capacity, sizeof(char));
+  document->size = size;
+
+  memcpy(document->contents, contents, size);
+
+  document_parse(document);
+
+  return document;
+}
+
+/*
+document_parse parses all of the document
+Input: Document
+Output: None
+*/
+void document_parse(document_T* document) {
+
+  document->lexer = init_lexer(document->contents);
+  document->parser = init_parser(document->lexer);
+
+  // Only statements that were parsed on their own can be parsed again alone, without them every edit parses everything
+  if (!(document->root = parser_lib_parallel(document->parser, 0))) {
+    document->root = parser_lib(document->parser);
+  }
+}
+
+/*
+document_apply edits a document and parses it again, only the body of the function the edit is in when it can
+Input: Document, edit that is inside the source code
+Output: True if only one function was parsed again
+*/
+bool document_apply(document_T* document, document_edit* edit) {
+
+  parser_chunk* chunk = document_find_function(document, edit);
+  long lines = document_replace(document, edit);
+
+  if (chunk && document_reparse_function(document, chunk, edit, lines)) {
+    return true;
+  }
+
+  document_free_tree(document);
+  document_parse(document);
+
+  return false;
+}
+
+/*
+document_find_function finds the function an edit is in, the edit has to be between the braces of the function's body
+so the header of the function and the statements around it don't change
+Input: Document, edit
+Output: Statement of the function, NULL if the edit isn't inside the body of one function
+*/
+parser_chunk* document_find_function(document_T* document, document_edit* edit) {
+
+  parser_chunk* chunk = NULL;
+
+  for (size_t i = 0; i < document->parser->chunksSize; i++) {
+
+    chunk = &document->parser->chunks[i];
+
+    if (chunk->table && edit->offset > chunk->start + chunk->body && edit->offset + edit->removed < chunk->start + chunk->length) {
+      return chunk;
+    }
+  }
+
+  return NULL;
+}
+
+/*
+document_replace replaces the removed bytes of an edit with the inserted ones
+Input: Document, edit
+Output: Amount of lines the edit added, negative when it removed lines
+*/
+long document_replace(document_T* document, document_edit* edit) {
+
+  size_t size = document->size - edit->removed + edit->size;
+  long lines = (long)scanner.newlines(edit->inserted, edit->size, NULL) - (long)scanner.newlines(document->contents + edit->offset, edit->removed, NULL);
+
+  vector_reserve(document->contents, document->capacity, size + 1);
+
+  memmove(document->contents + edit->offset + edit->size, document->contents + edit->offset + edit->removed, document->size - edit->offset - edit->removed);
+  memcpy(document->contents + edit->offset, edit->inserted, edit->size);
+
+  document->size = size;
+  document->contents[size] = '\0';
+
+  // The main lexer only finds lines now, it's line table is made again when it's needed
+  document->lexer->contents = document->contents;
+  document->lexer->contentsLength = size;
+
+  mfree(document->lexer->lines);
+  document->lexer->lines = NULL;
+
+  return lines;
+}
+
+/*
+document_reparse_function lexes and parses the body of a function again after an edit inside it,
+the tokens of the header, the function node and the scopes of the arguments are kept
+Input: Document, statement of the function, the edit that was applied to it, amount of lines the edit added
+Output: False if the function doesn't end at the same brace anymore, then the document has to be parsed again
+*/
+bool document_reparse_function(document_T* document, parser_chunk* chunk, document_edit* edit, long lines) {
+
+  parser_T* parser = chunk->parser;
+  lexer_T* lexer = parser->lexer;
+  lexer_chunk* statements = NULL;
+  size_t length = chunk->length - edit->removed + edit->size;
+  size_t size = 0;
+  char* contents = mcalloc(length + 1, sizeof(char));
+
+  memcpy(contents, document->contents + chunk->start, length);
+
+  // A brace or a string that was opened or closed by the edit can end the function somewhere else
+  if (!(statements = lexer_split_statements(contents, &size)) || size != 1 || statements[0].length != length) {
+    mfree(statements);
+    mfree(contents);
+    return false;
+  }
+
+  mfree(statements);
+
+  AST_free_AST(chunk->node->function_body);
+  chunk->node->function_body = NULL;
+
+  for (size_t i = chunk->headerTokens; i < lexer->tokensSize; i++) {
+    mfree(lexer->tokens[i]->value);
+    mfree(lexer->tokens[i]);
+  }
+
+  lexer->tokensSize = chunk->headerTokens;
+
+  // Only the arguments stay in the function's scope
+  table_truncate(chunk->table, chunk->node->size);
+
+  mfree(chunk->contents);
+  mfree(lexer->lines);
+
+  chunk->contents = lexer->contents = contents;
+  chunk->length = lexer->contentsLength = length;
+
+  lexer->lines = NULL;
+  lexer->index = chunk->body;
+  lexer->c = contents[lexer->index];
+
+  parser->token = lexer_get_next_token(lexer);
+  parser->table = chunk->table;
+
+  parser_function_job(&chunk, 0, 0);
+
+  // The statements after the function moved
+  for (parser_chunk* next = chunk + 1; next < document->parser->chunks + document->parser->chunksSize; next++) {
+
+    next->start = next->start - edit->removed + edit->size;
+    next->parser->lexer->lineBase += lines;
+  }
+
+  return true;
+}
+
+/*
+document_free_tree frees the tokens, the AST and the symbol tables of a document
+Input: Document
+Output: None
+*/
+void document_free_tree(document_T* document) {
+
+  lexer_free_tokens(document->lexer);
+  parser_free_chunks(document->parser);
+  AST_free_AST(document->root);
+  table_free_table(document->parser->table);
+
+  mfree(document->lexer);
+  mfree(document->parser);
+
+  document->lexer = NULL;
+  document->parser = NULL;
+  document->root = NULL;
+}
+
+/*
+document_free frees a document
+Input: Document
+Output: None
+*/
+void document_free(document_T* document) {
+
+  document_free_tree(document);
+
+  mfree(document->contents);
+  mfree(document);
+}
@@ -0,0 +1,46 @@
+#ifndef DOCUMENT_H
+#define DOCUMENT_H
+#include "parser.h"
+
+/*
+A document is source code that stays parsed while it is edited, like a file that is open in an editor.
+Every top level statement is parsed by a parser of it's own (see parser_lib_parallel), so an edit inside the body
+of a function only lexes and parses that body again, the other functions keep their subtrees and their scopes
+*/
+typedef struct DOCUMENT_STRUCT {
+
+  char* contents;
+  size_t size;
+  size_t capacity;
+
+  lexer_T* lexer;
+  parser_T* parser;
+  AST* root;
+
+} document_T;
+
+/* The removed bytes at the offset are replaced by the inserted bytes */
+typedef struct DOCUMENT_EDIT_STRUCT {
+
+  size_t offset;
+  size_t removed;
+
+  const char* inserted;
+  size_t size;
+
+} document_edit;
+
+document_T* init_document(const char* contents, size_t size);
+
+parser_chunk* document_find_function(document_T* document, document_edit* edit);
+
+bool document_apply(document_T* document, document_edit* edit);
+bool document_reparse_function(document_T* document, parser_chunk* chunk, document_edit* edit, long lines);
+
+long document_replace(document_T* document, document_edit* edit);
+
+void document_parse(document_T* document);
+void document_free_tree(document_T* document);
+void document_free(document_T* document);
+
+#endif
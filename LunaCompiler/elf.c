@@ -0,0 +1,298 @@
+#include "elf.h"
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+static const char* const sectionNames[X64_SECTION_AMOUNT] = { ".text", ".data", ".rodata" };
+
+/*
+elf_write_executable writes a static Linux executable that needs no linker
+The text and read only data share one read and execute segment, the data gets a writable segment of it's own
+Input: Encoded object, label of the entry point, target filename
+Output: None
+*/
+void elf_write_executable(x64_object* object, int entry, char* filename) {
+
+  FILE* file = fopen(filename, "wb");
+  emitter_T** sections = object->sections;
+
+  elf64_header header;
+  elf64_program_header segments[2];
+  uint64_t addresses[X64_SECTION_AMOUNT] = { 0 };
+  size_t offsets[X64_SECTION_AMOUNT] = { 0 };
+
+  uint16_t segmentAmount = sections[X64_DATA]->size ? 2 : 1;
+
+  if (!file) {
+    printf("[ERROR]: Couldn't open %s for writing", filename); error_exit();
+  }
+
+  // Place every section, the data starts on a new page so it can have different permissions
+  offsets[X64_TEXT] = elf_align(sizeof(elf64_header) + segmentAmount * sizeof(elf64_program_header), X64_TEXT_ALIGNMENT);
+  offsets[X64_RODATA] = elf_align(offsets[X64_TEXT] + sections[X64_TEXT]->size, X64_TEXT_ALIGNMENT);
+  offsets[X64_DATA] = elf_align(offsets[X64_RODATA] + sections[X64_RODATA]->size, ELF_PAGE_SIZE);
+
+  for (unsigned int i = 0; i < X64_SECTION_AMOUNT; i++) {
+    addresses[i] = ELF_BASE_ADDRESS + offsets[i];
+  }
+
+  x64_link(object, addresses);
+
+  elf_init_header(&header, ELF_TYPE_EXEC);
+  header.entry = addresses[X64_TEXT] + object->program->labels[entry].offset;
+  header.phoff = sizeof(elf64_header);
+  header.phentsize = sizeof(elf64_program_header);
+  header.phnum = segmentAmount;
+
+  memset(segments, 0, sizeof(segments));
+
+  segments[0].type = ELF_PT_LOAD;
+  segments[0].flags = ELF_PF_R | ELF_PF_X;
+  segments[0].vaddr = segments[0].paddr = ELF_BASE_ADDRESS;
+  segments[0].filesz = segments[0].memsz = offsets[X64_RODATA] + sections[X64_RODATA]->size;
+  segments[0].align = ELF_PAGE_SIZE;
+
+  segments[1].type = ELF_PT_LOAD;
+  segments[1].flags = ELF_PF_R | ELF_PF_W;
+  segments[1].offset = offsets[X64_DATA];
+  segments[1].vaddr = segments[1].paddr = addresses[X64_DATA];
+  segments[1].filesz = segments[1].memsz = sections[X64_DATA]->size;
+  segments[1].align = ELF_PAGE_SIZE;
+
+  fwrite(&header, sizeof(header), 1, file);
+  fwrite(segments, sizeof(elf64_program_header), segmentAmount, file);
+
+  elf_write_padding(file, offsets[X64_TEXT]);
+  fwrite(sections[X64_TEXT]->buffer, 1, sections[X64_TEXT]->size, file);
+  elf_write_padding(file, offsets[X64_RODATA]);
+  fwrite(sections[X64_RODATA]->buffer, 1, sections[X64_RODATA]->size, file);
+
+  if (sections[X64_DATA]->size) {
+    elf_write_padding(file, offsets[X64_DATA]);
+    fwrite(sections[X64_DATA]->buffer, 1, sections[X64_DATA]->size, file);
+  }
+
+  fclose(file);
+
+#ifndef _WIN32
+  chmod(filename, 0755);
+#endif
+}
+
+/*
+elf_write_object writes a relocatable object that can be linked with other objects
+References between sections are written as relocations against the section symbols, named labels become global symbols
+Input: Encoded object, target filename
+Output: None
+*/
+void elf_write_object(x64_object* object, char* filename) {
+
+  FILE* file = fopen(filename, "wb");
+  x64_program* program = object->program;
+  x64_label* label = NULL;
+  x64_reloc* reloc = NULL;
+
+  emitter_T* symbols = init_emitter(NULL);
+  emitter_T* strings = init_emitter(NULL);
+  emitter_T* sectionStrings = init_emitter(NULL);
+  emitter_T* relocs[X64_SECTION_AMOUNT] = { NULL };
+
+  elf64_header header;
+  elf64_section_header headers[ELF_SECTION_AMOUNT];
+  elf64_symbol symbol;
+  elf64_rela rela;
+
+  size_t offset = sizeof(elf64_header);
+
+  if (!file) {
+    printf("[ERROR]: Couldn't open %s for writing", filename); error_exit();
+  }
+
+  memset(headers, 0, sizeof(headers));
+
+  emit_char(strings, '\0');
+  emit_char(sectionStrings, '\0');
+
+  // The null symbol, then a symbol for every section so relocations can point into them
+  memset(&symbol, 0, sizeof(symbol));
+  emit_bytes(symbols, (char*)&symbol, sizeof(symbol));
+
+  for (unsigned int i = 0; i < X64_SECTION_AMOUNT; i++) {
+
+    symbol.info = (ELF_STB_LOCAL << 4) | ELF_STT_SECTION;
+    symbol.shndx = ELF_SECTION_TEXT + i;
+    emit_bytes(symbols, (char*)&symbol, sizeof(symbol));
+  }
+
+  for (size_t i = 0; i < program->labelsSize; i++) {
+
+    label = &program->labels[i];
+
+    if (!label->name || !label->defined) { continue; }
+
+    symbol.name = (uint32_t)strings->size;
+    symbol.info = (ELF_STB_GLOBAL << 4) | (label->section == X64_TEXT ? ELF_STT_FUNC : ELF_STT_OBJECT);
+    symbol.shndx = ELF_SECTION_TEXT + label->section;
+    symbol.value = label->offset;
+
+    emit_bytes(strings, label->name, strlen(label->name) + 1);
+    emit_bytes(symbols, (char*)&symbol, sizeof(symbol));
+  }
+
+  for (unsigned int i = 0; i < X64_SECTION_AMOUNT; i++) {
+    relocs[i] = init_emitter(NULL);
+  }
+
+  for (size_t i = 0; i < object->relocsSize; i++) {
+
+    reloc = &object->relocs[i];
+    label = &program->labels[reloc->label];
+
+    rela.offset = reloc->offset;
+    rela.info = ((uint64_t)(1 + label->section) << 32) | (reloc->type == X64_RELOC_PC32 ? ELF_R_X86_64_PC32 : ELF_R_X86_64_64);
+    rela.addend = (int64_t)label->offset + reloc->addend;
+
+    emit_bytes(relocs[reloc->section], (char*)&rela, sizeof(rela));
+  }
+
+  // Describe every section, their contents follow the header in the same order
+  for (unsigned int i = 0; i < X64_SECTION_AMOUNT; i++) {
+
+    headers[ELF_SECTION_TEXT + i].name = (uint32_t)sectionStrings->size;
+    headers[ELF_SECTION_TEXT + i].type = ELF_SHT_PROGBITS;
+    headers[ELF_SECTION_TEXT + i].flags = ELF_SHF_ALLOC | (i == X64_TEXT ? ELF_SHF_EXECINSTR : 0) | (i == X64_DATA ? ELF_SHF_WRITE : 0);
+    headers[ELF_SECTION_TEXT + i].size = object->sections[i]->size;
+    headers[ELF_SECTION_TEXT + i].addralign = i == X64_TEXT ? X64_TEXT_ALIGNMENT : 8;
+
+    emit_bytes(sectionStrings, sectionNames[i], strlen(sectionNames[i]) + 1);
+  }
+
+  headers[ELF_SECTION_RELA_TEXT].name = (uint32_t)sectionStrings->size;
+  emit_bytes(sectionStrings, ".rela.text", sizeof(".rela.text"));
+  headers[ELF_SECTION_RELA_DATA].name = (uint32_t)sectionStrings->size;
+  emit_bytes(sectionStrings, ".rela.data", sizeof(".rela.data"));
+
+  for (unsigned int i = ELF_SECTION_RELA_TEXT; i <= ELF_SECTION_RELA_DATA; i++) {
+
+    headers[i].type = ELF_SHT_RELA;
+    headers[i].flags = ELF_SHF_INFO_LINK;
+    headers[i].size = relocs[i == ELF_SECTION_RELA_TEXT ? X64_TEXT : X64_DATA]->size;
+    headers[i].link = ELF_SECTION_SYMTAB;
+    headers[i].info = i == ELF_SECTION_RELA_TEXT ? ELF_SECTION_TEXT : ELF_SECTION_DATA;
+    headers[i].addralign = 8;
+    headers[i].entsize = sizeof(elf64_rela);
+  }
+
+  headers[ELF_SECTION_SYMTAB].name = (uint32_t)sectionStrings->size;
+  emit_bytes(sectionStrings, ".symtab", sizeof(".symtab"));
+  headers[ELF_SECTION_SYMTAB].type = ELF_SHT_SYMTAB;
+  headers[ELF_SECTION_SYMTAB].size = symbols->size;
+  headers[ELF_SECTION_SYMTAB].link = ELF_SECTION_STRTAB;
+  headers[ELF_SECTION_SYMTAB].info = 1 + X64_SECTION_AMOUNT;    // Index of the first global symbol
+  headers[ELF_SECTION_SYMTAB].addralign = 8;
+  headers[ELF_SECTION_SYMTAB].entsize = sizeof(elf64_symbol);
+
+  headers[ELF_SECTION_STRTAB].name = (uint32_t)sectionStrings->size;
+  emit_bytes(sectionStrings, ".strtab", sizeof(".strtab"));
+  headers[ELF_SECTION_STRTAB].type = ELF_SHT_STRTAB;
+  headers[ELF_SECTION_STRTAB].size = strings->size;
+  headers[ELF_SECTION_STRTAB].addralign = 1;
+
+  // An empty stack note tells the linker the program doesn't need an executable stack
+  headers[ELF_SECTION_STACK_NOTE].name = (uint32_t)sectionStrings->size;
+  emit_bytes(sectionStrings, ".note.GNU-stack", sizeof(".note.GNU-stack"));
+  headers[ELF_SECTION_STACK_NOTE].type = ELF_SHT_PROGBITS;
+  headers[ELF_SECTION_STACK_NOTE].addralign = 1;
+
+  headers[ELF_SECTION_SHSTRTAB].name = (uint32_t)sectionStrings->size;
+  emit_bytes(sectionStrings, ".shstrtab", sizeof(".shstrtab"));
+  headers[ELF_SECTION_SHSTRTAB].type = ELF_SHT_STRTAB;
+  headers[ELF_SECTION_SHSTRTAB].size = sectionStrings->size;
+  headers[ELF_SECTION_SHSTRTAB].addralign = 1;
+
+  for (unsigned int i = ELF_SECTION_TEXT; i < ELF_SECTION_AMOUNT; i++) {
+    offset = elf_align(offset, headers[i].addralign);
+    headers[i].offset = offset;
+    offset += headers[i].size;
+  }
+
+  elf_init_header(&header, ELF_TYPE_REL);
+  header.shoff = elf_align(offset, 8);
+  header.shentsize = sizeof(elf64_section_header);
+  header.shnum = ELF_SECTION_AMOUNT;
+  header.shstrndx = ELF_SECTION_SHSTRTAB;
+
+  fwrite(&header, sizeof(header), 1, file);
+
+  for (unsigned int i = ELF_SECTION_TEXT; i < ELF_SECTION_AMOUNT; i++) {
+
+    elf_write_padding(file, headers[i].offset);
+
+    switch (i) {
+
+      case ELF_SECTION_TEXT:
+      case ELF_SECTION_DATA:
+      case ELF_SECTION_RODATA:    fwrite(object->sections[i - ELF_SECTION_TEXT]->buffer, 1, headers[i].size, file); break;
+      case ELF_SECTION_RELA_TEXT: fwrite(relocs[X64_TEXT]->buffer, 1, headers[i].size, file); break;
+      case ELF_SECTION_RELA_DATA: fwrite(relocs[X64_DATA]->buffer, 1, headers[i].size, file); break;
+      case ELF_SECTION_SYMTAB:    fwrite(symbols->buffer, 1, headers[i].size, file); break;
+      case ELF_SECTION_STRTAB:    fwrite(strings->buffer, 1, headers[i].size, file); break;
+      case ELF_SECTION_SHSTRTAB:  fwrite(sectionStrings->buffer, 1, headers[i].size, file); break;
+    }
+  }
+
+  elf_write_padding(file, header.shoff);
+  fwrite(headers, sizeof(elf64_section_header), ELF_SECTION_AMOUNT, file);
+
+  fclose(file);
+
+  for (unsigned int i = 0; i < X64_SECTION_AMOUNT; i++) {
+    emitter_free(relocs[i]);
+  }
+
+  emitter_free(symbols);
+  emitter_free(strings);
+  emitter_free(sectionStrings);
+}
+
+/*
+elf_init_header fills in the parts of the ELF header that are the same for every file we write
+Input: Header, file type
+Output: None
+*/
+void elf_init_header(elf64_header* header, uint16_t type) {
+
+  memset(header, 0, sizeof(elf64_header));
+
+  memcpy(header->ident, "\x7F" "ELF", 4);
+  header->ident[4] = ELF_CLASS64;
+  header->ident[5] = ELF_DATA_LSB;
+  header->ident[6] = ELF_VERSION;
+
+  header->type = type;
+  header->machine = ELF_MACHINE_X86_64;
+  header->version = ELF_VERSION;
+  header->ehsize = sizeof(elf64_header);
+}
+
+/*
+elf_write_padding writes zeros until the file reaches an offset
+Input: File, offset
+Output: None
+*/
+void elf_write_padding(FILE* file, size_t offset) {
+
+  for (long position = ftell(file); (size_t)position < offset; position++) {
+    fputc(0, file);
+  }
+}
+
+/*
+elf_align rounds an offset up to an alignment
+Input: Offset, alignment (a power of 2)
+Output: Aligned offset
+*/
+size_t elf_align(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) & ~(alignment - 1);
+}
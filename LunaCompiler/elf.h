@@ -0,0 +1,132 @@
+#ifndef ELF_H
+#define ELF_H
+#include "x64Encoder.h"
+
+#define ELF_BASE_ADDRESS 0x400000
+#define ELF_PAGE_SIZE 0x1000
+
+#define ELF_CLASS64 2
+#define ELF_DATA_LSB 1
+#define ELF_VERSION 1
+#define ELF_MACHINE_X86_64 62
+
+#define ELF_TYPE_REL 1
+#define ELF_TYPE_EXEC 2
+
+#define ELF_PT_LOAD 1
+#define ELF_PF_X 1
+#define ELF_PF_W 2
+#define ELF_PF_R 4
+
+#define ELF_SHT_PROGBITS 1
+#define ELF_SHT_SYMTAB 2
+#define ELF_SHT_STRTAB 3
+#define ELF_SHT_RELA 4
+
+#define ELF_SHF_WRITE 0x1
+#define ELF_SHF_ALLOC 0x2
+#define ELF_SHF_EXECINSTR 0x4
+#define ELF_SHF_INFO_LINK 0x40
+
+#define ELF_STB_LOCAL 0
+#define ELF_STB_GLOBAL 1
+#define ELF_STT_NOTYPE 0
+#define ELF_STT_OBJECT 1
+#define ELF_STT_FUNC 2
+#define ELF_STT_SECTION 3
+
+#define ELF_R_X86_64_64 1
+#define ELF_R_X86_64_PC32 2
+
+/* Section header indices of a relocatable object written by elf_write_object */
+typedef enum ELF_SECTION_ENUM {
+
+  ELF_SECTION_NULL,
+  ELF_SECTION_TEXT,
+  ELF_SECTION_DATA,
+  ELF_SECTION_RODATA,
+  ELF_SECTION_RELA_TEXT,
+  ELF_SECTION_RELA_DATA,
+  ELF_SECTION_SYMTAB,
+  ELF_SECTION_STRTAB,
+  ELF_SECTION_SHSTRTAB,
+  ELF_SECTION_STACK_NOTE,
+  ELF_SECTION_AMOUNT
+
+} elf_section;
+
+/* The ELF structures are written as they are, which matches the file format on a little endian host */
+typedef struct ELF64_HEADER_STRUCT {
+
+  unsigned char ident[16];
+  uint16_t type;
+  uint16_t machine;
+  uint32_t version;
+  uint64_t entry;
+  uint64_t phoff;
+  uint64_t shoff;
+  uint32_t flags;
+  uint16_t ehsize;
+  uint16_t phentsize;
+  uint16_t phnum;
+  uint16_t shentsize;
+  uint16_t shnum;
+  uint16_t shstrndx;
+
+} elf64_header;
+
+typedef struct ELF64_PROGRAM_HEADER_STRUCT {
+
+  uint32_t type;
+  uint32_t flags;
+  uint64_t offset;
+  uint64_t vaddr;
+  uint64_t paddr;
+  uint64_t filesz;
+  uint64_t memsz;
+  uint64_t align;
+
+} elf64_program_header;
+
+typedef struct ELF64_SECTION_HEADER_STRUCT {
+
+  uint32_t name;
+  uint32_t type;
+  uint64_t flags;
+  uint64_t addr;
+  uint64_t offset;
+  uint64_t size;
+  uint32_t link;
+  uint32_t info;
+  uint64_t addralign;
+  uint64_t entsize;
+
+} elf64_section_header;
+
+typedef struct ELF64_SYMBOL_STRUCT {
+
+  uint32_t name;
+  unsigned char info;
+  unsigned char other;
+  uint16_t shndx;
+  uint64_t value;
+  uint64_t size;
+
+} elf64_symbol;
+
+typedef struct ELF64_RELA_STRUCT {
+
+  uint64_t offset;
+  uint64_t info;
+  int64_t addend;
+
+} elf64_rela;
+
+void elf_write_executable(x64_object* object, int entry, char* filename);
+void elf_write_object(x64_object* object, char* filename);
+void elf_init_header(elf64_header* header, uint16_t type);
+void elf_write_padding(FILE* file, size_t offset);
+
+size_t elf_align(size_t offset, size_t alignment);
+
+#endif
@@ -0,0 +1,171 @@
+#include "emitter.h"
+
+/*
+init_emitter initializes an output emitter that collects generated code in a growable buffer
+Input: File to stream the buffer to, NULL to keep all output in memory
+Output: Emitter
+*/
+emitter_T* init_emitter(FILE* target) {
+
+  emitter_T* emitter = mcalloc(1, sizeof(emitter_T));
+
+  emitter->capacity = EMITTER_INITIAL_SIZE;
+  emitter->buffer = mcalloc(1, emitter->capacity);
+  emitter->target = target;
+
+  return emitter;
+}
+
+/*
+emitter_reserve makes sure the buffer can hold a given amount of extra bytes, doubling it's capacity when needed
+Input: Emitter, amount of bytes we are about to append
+Output: None
+*/
+void emitter_reserve(emitter_T* emitter, size_t size) {
+
+  vector_reserve(emitter->buffer, emitter->capacity, emitter->size + size);
+}
+
+/*
+emit_bytes appends raw bytes to the emitter, streaming the buffer to the target once it's big enough
+Input: Emitter, bytes to append, amount of bytes
+Output: None
+*/
+void emit_bytes(emitter_T* emitter, const char* bytes, size_t length) {
+
+  emitter_reserve(emitter, length);
+  memcpy(emitter->buffer + emitter->size, bytes, length);
+  emitter->size += length;
+
+  // Stream big chunks to the file so the buffer doesn't grow as big as the whole program
+  if (emitter->target && emitter->size >= EMITTER_CHUNK_SIZE) {
+    emitter_flush(emitter);
+  }
+}
+
+/*
+emit_string appends a string to the emitter
+Input: Emitter, string to append
+Output: None
+*/
+void emit_string(emitter_T* emitter, const char* string) {
+  emit_bytes(emitter, string, strlen(string));
+}
+
+/*
+emit_char appends a single character to the emitter
+Input: Emitter, character
+Output: None
+*/
+void emit_char(emitter_T* emitter, char c) {
+  emit_bytes(emitter, &c, 1);
+}
+
+/*
+emit_number appends the decimal representation of a number without going through printf
+Input: Emitter, number
+Output: None
+*/
+void emit_number(emitter_T* emitter, long long num) {
+
+  char digits[24] = { 0 };
+  size_t index = sizeof(digits);
+  unsigned long long value = num < 0 ? 0ULL - (unsigned long long)num : (unsigned long long)num;
+
+  do {
+    digits[--index] = '0' + value % 10;
+    value /= 10;
+  } while (value);
+
+  if (num < 0) {
+    digits[--index] = '-';
+  }
+
+  emit_bytes(emitter, digits + index, sizeof(digits) - index);
+}
+
+/*
+emit_line appends a string and ends the line
+Input: Emitter, line to append
+Output: None
+*/
+void emit_line(emitter_T* emitter, const char* line) {
+  emit_string(emitter, line);
+  emit_char(emitter, '\n');
+}
+
+/*
+emit_instruction appends an instruction of the form "OP arg1, arg2", any missing argument should be NULL
+Input: Emitter, operation, first argument, second argument
+Output: None
+*/
+void emit_instruction(emitter_T* emitter, const char* op, const char* arg1, const char* arg2) {
+
+  emit_string(emitter, op);
+
+  if (arg1) {
+    emit_char(emitter, ' ');
+    emit_string(emitter, arg1);
+  }
+
+  if (arg2) {
+    emit_bytes(emitter, ", ", 2);
+    emit_string(emitter, arg2);
+  }
+
+  emit_char(emitter, '\n');
+}
+
+/*
+emit_load appends a MOV instruction that loads a variable from memory to a register
+Input: Emitter, register name, variable name
+Output: None
+*/
+void emit_load(emitter_T* emitter, const char* reg, const char* var) {
+
+  emit_bytes(emitter, "MOV ", 4);
+  emit_string(emitter, reg);
+  emit_bytes(emitter, ", [", 3);
+  emit_string(emitter, var);
+  emit_bytes(emitter, "]\n", 2);
+}
+
+/*
+emit_store appends a MOV instruction that stores a register in a variable's memory
+Input: Emitter, variable name, register name
+Output: None
+*/
+void emit_store(emitter_T* emitter, const char* var, const char* reg) {
+
+  emit_bytes(emitter, "MOV [", 5);
+  emit_string(emitter, var);
+  emit_bytes(emitter, "], ", 3);
+  emit_string(emitter, reg);
+  emit_char(emitter, '\n');
+}
+
+/*
+emitter_flush writes all the buffered output to the target file in one write
+Input: Emitter
+Output: None
+*/
+void emitter_flush(emitter_T* emitter) {
+
+  if (!emitter->target || !emitter->size) { return; }
+
+  fwrite(emitter->buffer, 1, emitter->size, emitter->target);
+  emitter->size = 0;
+}
+
+/*
+emitter_free flushes whatever is left in the emitter and frees it
+Input: Emitter
+Output: None
+*/
+void emitter_free(emitter_T* emitter) {
+
+  emitter_flush(emitter);
+
+  mfree(emitter->buffer);
+  mfree(emitter);
+}
@@ -0,0 +1,32 @@
+#ifndef EMITTER_H
+#define EMITTER_H
+#include "io.h"
+
+#define EMITTER_INITIAL_SIZE 4096
+#define EMITTER_CHUNK_SIZE 65536    // Amount of buffered bytes before the emitter streams them to the target file
+
+typedef struct EMITTER_STRUCT {
+
+  char* buffer;
+  size_t size;
+  size_t capacity;
+
+  FILE* target;    // When NULL, everything stays in the buffer until the caller takes it
+
+} emitter_T;
+
+emitter_T* init_emitter(FILE* target);
+
+void emit_string(emitter_T* emitter, const char* string);
+void emit_bytes(emitter_T* emitter, const char* bytes, size_t length);
+void emit_char(emitter_T* emitter, char c);
+void emit_number(emitter_T* emitter, long long num);
+void emit_line(emitter_T* emitter, const char* line);
+void emit_instruction(emitter_T* emitter, const char* op, const char* arg1, const char* arg2);
+void emit_load(emitter_T* emitter, const char* reg, const char* var);
+void emit_store(emitter_T* emitter, const char* var, const char* reg);
+void emitter_reserve(emitter_T* emitter, size_t size);
+void emitter_flush(emitter_T* emitter);
+void emitter_free(emitter_T* emitter);
+
+#endif
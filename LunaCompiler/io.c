@@ -1,5 +1,21 @@
 #include "io.h"
 
+THREAD_LOCAL jmp_buf* errorJump = NULL;
+
+/*
+error_exit stops the compilation after an error was printed, in batch mode only the file with the error stops
+Input: None
+Output: None
+*/
+NORETURN void error_exit() {
+
+  if (errorJump) {
+    longjmp(*errorJump, 1);
+  }
+
+  exit(1);
+}
+
 /*
 read_file takes a file and returns it's contents in a string
 Input: File
@@ -8,20 +24,22 @@ Output: Contents of the file
 char* read_file(FILE* file) {
 
   char* contents = NULL;
-  char ch = 0;
-  size_t i = 0;
+  size_t size = 0;
+  size_t capacity = 0;
+  size_t read = 0;
+
+  // Read the file in blocks until the end of it is reached, the buffer doubles when it's full
+  do {
+    vector_reserve(contents, capacity, size + READ_BLOCK_SIZE);
 
-  contents = mcalloc(1, sizeof(char));
+    read = fread(contents + size, sizeof(char), capacity - size - 1, file);
+    size += read;
 
-  // While end of file is not reached, advance file string data and put the current char in it
-  while ((ch = fgetc(file)) != EOF) {
-  contents = mrealloc(contents, ++i);
-  contents[i - 1] = ch;
-  } 
+  } while (read);
 
   // Terminate string with a 0
-  contents = mrealloc(contents, ++i);
-  contents[i - 1] = '\0';     
+  contents[size] = '\0';
+  vector_shrink(contents, size + 1, capacity);
 
   fclose(file);
 
@@ -35,39 +53,27 @@ const char* get_filename_ext(const char* name) {
 }
 
 /*
-make_new_filename gets a file and changes it's extention to the desired one
+make_new_filename gets a file and changes it's extention to the desired one, a file without an extention gets it added
 Input: Filename, desired new extention
 Output: The same filename with a the desired extention
 */
 char* make_new_filename(const char* name, const char* extention) {
 
-  char* newFilename = mcalloc(1, sizeof(char));
-
-  unsigned int i = 0;
-  size_t size = 0;
-  size_t length = strlen(name);
+  const char* base = name;
+  const char* dot = NULL;
+  char* newFilename = NULL;
+  size_t length = 0;
 
-  for (i = 0; i < length; i++) {
+  // The extention is after the last dot of the file's own name, the directories before it can have dots too ("./", "../")
+  for (const char* separator = name; (separator = strpbrk(separator, "/\\")); base = ++separator) { }
 
-    // For every normal character, we copy it as is
-    if (name[i] != '.') {
-      newFilename = mrealloc(newFilename, ++size);
-      newFilename[size - 1] = name[i];
-    }
-    // When extention reached we copy the .asm extention instead
-    else {
-      // Before using strcat, we have to terminate the current string
-      newFilename = mrealloc(newFilename, ++size);
-      newFilename[size - 1] = '\0';
+  dot = strrchr(base, '.');
+  length = dot ? (size_t)(dot - name) : strlen(name);
 
-      size += strlen(extention) + 1;
+  newFilename = mcalloc(length + strlen(extention) + 1, sizeof(char));
+  memcpy(newFilename, name, length);
+  strcpy(newFilename + length, extention);
 
-      newFilename = mrealloc(newFilename, size);
-      strcat(newFilename, extention);
-      break;
-    }
-  }
-    
   return newFilename;
 }
 
@@ -106,30 +112,135 @@ bool isNum(char* value) {
   return flag;
 }
 
+/*
+hash_bytes hashes a block of memory with 64 bit FNV-1a
+Input: Data, size of data in bytes
+Output: Hash
+*/
+uint64_t hash_bytes(const void* data, size_t size) {
+
+  const unsigned char* bytes = data;
+  uint64_t hash = 14695981039346656037ULL;
+
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+
+  return hash;
+}
+
 void assemble_file(char* filename) {
 
   char* command = NULL;
   char* objectFilename = make_new_filename(filename, ".obj");
   char* exeFilename = make_new_filename(filename, ".exe");
 
-  command = mcalloc(1, strlen("C:\\masm32\\bin\\ml /c /Zd /coff %s") + strlen(filename) + 1);
-  sprintf(command, "C:\\masm32\\bin\\ml /c /Zd /coff %s", filename);
+  command = mcalloc(1, strlen("C:\\masm32\\bin\\ml /c /Zd /coff \"%s\"") + strlen(filename) + 1);
+  sprintf(command, "C:\\masm32\\bin\\ml /c /Zd /coff \"%s\"", filename);
   system(command);
 
-  free(command);
+  mfree(command);
 
-  command = mcalloc(1, strlen("C:\\masm32\\bin\\Link /SUBSYSTEM:CONSOLE %s") + strlen(objectFilename) + 1);
-  sprintf(command, "C:\\masm32\\bin\\Link /SUBSYSTEM:CONSOLE %s", objectFilename);
+  command = mcalloc(1, strlen("C:\\masm32\\bin\\Link /SUBSYSTEM:CONSOLE \"%s\"") + strlen(objectFilename) + 1);
+  sprintf(command, "C:\\masm32\\bin\\Link /SUBSYSTEM:CONSOLE \"%s\"", objectFilename);
   system(command);
 
-  free(command);
+  mfree(command);
   //system("cls");
-  system(exeFilename);
+  command = mcalloc(1, strlen("\"%s\"") + strlen(exeFilename) + 1);
+  sprintf(command, "\"%s\"", exeFilename);
+  system(command);
+
+  mfree(command);
+
+  mfree(objectFilename);
+  mfree(exeFilename);
+}
+
+
+/*
+assemble_file_x64 assembles and links a GNU assembler file made by the x86-64 backend with the system tools, then runs it
+The program has it's own entry point and runtime, so it is linked without any library
+Input: Assembly filename
+Output: None
+*/
+void assemble_file_x64(char* filename) {
+
+  char* command = NULL;
+  char* objectFilename = make_new_filename(filename, ".o");
+  char* exeFilename = make_new_filename(filename, "");
+  char* source = quote_filename(filename);
+  char* object = quote_filename(objectFilename);
+  char* exe = quote_filename(exeFilename);
+
+  command = mcalloc(1, strlen("as -o %s %s") + strlen(object) + strlen(source) + 1);
+  sprintf(command, "as -o %s %s", object, source);
+  system(command);
+
+  mfree(command);
+
+  command = mcalloc(1, strlen("ld -o %s %s") + strlen(exe) + strlen(object) + 1);
+  sprintf(command, "ld -o %s %s", exe, object);
+  system(command);
+
+  mfree(command);
+
+  run_file(exeFilename);
+
+  mfree(source);
+  mfree(object);
+  mfree(exe);
+  mfree(objectFilename);
+  mfree(exeFilename);
+}
+
+/*
+run_file runs an executable we produced on Linux
+Input: Executable filename
+Output: None
+*/
+void run_file(char* filename) {
+
+  char* path = mcalloc(1, strlen("./") + strlen(filename) + 1);
+  char* command = NULL;
 
-  free(objectFilename);
-  free(exeFilename);
+  // Programs in the current directory have to be run with a path
+  sprintf(path, strchr(filename, '/') ? "%s" : "./%s", filename);
+  command = quote_filename(path);
+  system(command);
+
+  mfree(command);
+  mfree(path);
 }
 
+/*
+quote_filename puts a filename in single quotes for the shell, so spaces and other special characters stay part of the name
+Input: Filename
+Output: The quoted filename, a quote inside the name is closed, escaped and opened again
+*/
+char* quote_filename(const char* filename) {
+
+  char* quoted = mcalloc(strlen(filename) * 4 + 3, sizeof(char));
+  size_t size = 0;
+
+  quoted[size++] = '\'';
+
+  for (; *filename; filename++) {
+
+    if (*filename == '\'') {
+      memcpy(quoted + size, "'\\''", 4);
+      size += 4;
+    }
+    else {
+      quoted[size++] = *filename;
+    }
+  }
+
+  quoted[size] = '\'';
+
+  return quoted;
+}
 
 /*
 myFgets will perform the fgets command and also remove the newline
@@ -6,23 +6,65 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include "stats.h"
+#include "allocations.h"
 
 
-static inline void* mcalloc(size_t count, size_t size) {
+/* Every allocation goes through these, with the line that called them so -allocs can count allocations by where they happen */
+#define mcalloc(count, size) mcalloc_at(count, size, __FILE__, __LINE__)
+#define mrealloc(ptr, size) mrealloc_at(ptr, size, __FILE__, __LINE__)
+
+static inline void* mcalloc_at(size_t count, size_t size, const char* file, unsigned int line) {
 
   void* ptr = calloc(count, size);
 
+  stats_add(STATS_ALLOCATIONS, 1);
+  stats_add(STATS_BYTES, count * size);
+
   if (!ptr) { printf("Heap error"); exit(1); }
 
+  if (allocations.enabled) { allocations_add(ptr, count * size, file, line); }
+
   return ptr;
 }
 
-static inline void* mrealloc(void* ptr, size_t size) {
+static inline void* mrealloc_at(void* ptr, size_t size, const char* file, unsigned int line) {
+
+  void* tmp = allocations.enabled ? allocations_realloc(ptr, size, file, line) : realloc(ptr, size);
+
+  stats_add(STATS_ALLOCATIONS, 1);
+  stats_add(STATS_BYTES, size);
 
-  void* tmp = realloc(ptr, size);
-  return tmp ? tmp : ptr;
+  // A size of 0 frees the block and can return NULL, any other NULL means the block couldn't grow
+  if (!tmp && size) { printf("Heap error"); exit(1); }
+
+  return tmp;
 }
 
+static inline void mfree(void* ptr) {
+
+  if (allocations.enabled && ptr) { allocations_remove(ptr); }
+
+  free(ptr);
+}
+
+#define READ_BLOCK_SIZE 4096
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#define NORETURN __declspec(noreturn)
+#else
+#define THREAD_LOCAL _Thread_local
+#define NORETURN __attribute__((noreturn))
+#endif
+
+/* Where an error in the source code jumps to on this thread, NULL when an error ends the process */
+extern THREAD_LOCAL jmp_buf* errorJump;
+
+NORETURN void error_exit();
+
 char* read_file(FILE* file);
 const char* get_filename_ext(const char* name);
 char* make_new_filename(const char* name, const char* extention);
@@ -31,9 +73,16 @@ bool isNum(char* value);
 
 size_t numOfDigits(long num);
 
+uint64_t hash_bytes(const void* data, size_t size);
+
 void assemble_file(char* filename);
+void assemble_file_x64(char* filename);
+void run_file(char* filename);
+char* quote_filename(const char* filename);
 void myFgets(char str[], int n);
 
+#include "vector.h"
+
 
 #endif
  
\ No newline at end of file
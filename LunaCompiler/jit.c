@@ -0,0 +1,92 @@
+#include "jit.h"
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+/*
+jit_run compiles the program to machine code in memory and runs it's main function inside the compiler's process
+Print is bound to native functions of the compiler instead of the system call runtime
+Input: Symbol table, TAC list
+Output: The value main returned
+*/
+long long jit_run(table_T* table, TAC_list* list) {
+
+#if defined(__x86_64__) && !defined(_WIN32)
+
+  x64_program* program = generate64_program(table, list);
+  x64_object* object = NULL;
+  emitter_T** sections = NULL;
+
+  uint64_t addresses[X64_SECTION_AMOUNT] = { 0 };
+  size_t offsets[X64_SECTION_AMOUNT] = { 0 };
+  size_t size = 0;
+
+  char* memory = NULL;
+  jit_main function = NULL;
+  long long result = 0;
+
+  runtime64_build_native(program, RUNTIME_PRINT_INT, (void*)jit_print_int);
+  runtime64_build_native(program, RUNTIME_PRINT_STRING, (void*)jit_print_string);
+
+  object = x64_encode(program);
+  sections = object->sections;
+
+  // Same layout as an executable, the data gets pages of it's own so the code can be made read only
+  offsets[X64_RODATA] = elf_align(sections[X64_TEXT]->size, X64_TEXT_ALIGNMENT);
+  offsets[X64_DATA] = elf_align(offsets[X64_RODATA] + sections[X64_RODATA]->size, JIT_PAGE_SIZE);
+  size = elf_align(offsets[X64_DATA] + sections[X64_DATA]->size, JIT_PAGE_SIZE);
+
+  memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (memory == MAP_FAILED) {
+    printf("[Error]: Couldn't allocate memory for the program"); error_exit();
+  }
+
+  for (unsigned int i = 0; i < X64_SECTION_AMOUNT; i++) {
+    addresses[i] = (uint64_t)(uintptr_t)(memory + offsets[i]);
+  }
+
+  x64_link(object, addresses);
+
+  for (unsigned int i = 0; i < X64_SECTION_AMOUNT; i++) {
+    memcpy(memory + offsets[i], sections[i]->buffer, sections[i]->size);
+  }
+
+  if (mprotect(memory, offsets[X64_DATA], PROT_READ | PROT_EXEC)) {
+    printf("[Error]: Couldn't make the program executable"); error_exit();
+  }
+
+  function = (jit_main)(uintptr_t)(addresses[X64_TEXT] + program->labels[x64_find_symbol(program, "main")].offset);
+
+  x64_free_object(object);
+  x64_free_program(program);
+
+  stats_switch(STATS_RUN);
+
+  result = function();
+
+  fflush(stdout);
+  munmap(memory, size);
+
+  return result;
+
+#else
+
+  printf("[Error]: Running programs in the compiler is only supported on x86-64 Linux"); error_exit();
+
+#endif
+}
+
+/*
+jit_print_int and jit_print_string are the print functions of programs that run in the compiler
+Input: Value to print
+Output: None
+*/
+void jit_print_int(long long value) {
+  printf("%lld", value);
+}
+
+void jit_print_string(const char* string) {
+  fputs(string, stdout);
+}
@@ -0,0 +1,14 @@
+#ifndef JIT_H
+#define JIT_H
+#include "codeGen64.h"
+
+#define JIT_PAGE_SIZE 0x1000
+
+typedef long long (*jit_main)(void);
+
+long long jit_run(table_T* table, TAC_list* list);
+
+void jit_print_int(long long value);
+void jit_print_string(const char* string);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+#include "lexer.h"
+
+/* Generated by keywords.py, do not edit */
+
+#define KEYWORD_TABLE_SIZE 32
+#define KEYWORD_MIN_LENGTH 2
+#define KEYWORD_MAX_LENGTH 12
+
+// Hash of the bytes of an identifier, every keyword has a slot of it's own
+#define KEYWORD_HASH(word, length) (((unsigned char)(word)[0] * 1 + (unsigned char)(word)[1] * 3 \
+  + (unsigned char)(word)[(length) - 1] * 13 + (length)) % KEYWORD_TABLE_SIZE)
+
+static const lexer_keyword keywordTable[KEYWORD_TABLE_SIZE] = {
+
+  { NULL, 0, 0, 0, NULL },
+  { "\xD7\x9E\xD7\xA1\xD7\xA4\xD7\xA8", 8, TOKEN_KEYWORD, INT_T, "int" },                       // int
+  { NULL, 0, 0, 0, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { "\xD7\x90\xD7\x9D", 4, TOKEN_KEYWORD, IF_T, "if" },                                         // if
+  { NULL, 0, 0, 0, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { "\xD7\xAA\xD7\x97\xD7\x96\xD7\x99\xD7\xA8", 10, TOKEN_KEYWORD, RETURN_T, "return" },        // return
+  { NULL, 0, 0, 0, NULL },
+  { "\xD7\x91\xD7\x96\xD7\x9E\xD7\x9F\xD7\xA9", 10, TOKEN_KEYWORD, WHILE_T, "while" },          // while
+  { NULL, 0, 0, 0, NULL },
+  { "if", 2, TOKEN_KEYWORD, IF_T, NULL },
+  { "\xD7\xAA\xD7\x93\xD7\xA4\xD7\x99\xD7\xA1", 10, TOKEN_ID, OUT_T, "print" },                 // print
+  { NULL, 0, 0, 0, NULL },
+  { "else", 4, TOKEN_KEYWORD, ELSE_T, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { "string", 6, TOKEN_KEYWORD, STRING_T, NULL },
+  { "\xD7\x90\xD7\x97\xD7\xA8\xD7\xAA", 8, TOKEN_KEYWORD, ELSE_T, "else" },                     // else
+  { NULL, 0, 0, 0, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { "while", 5, TOKEN_KEYWORD, WHILE_T, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { "int", 3, TOKEN_KEYWORD, INT_T, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { "\xD7\xA8\xD7\x90\xD7\xA9\xD7\x99", 8, TOKEN_ID, -1, "main" },                              // main
+  { "return", 6, TOKEN_KEYWORD, RETURN_T, NULL },
+  { NULL, 0, 0, 0, NULL },
+  { "\xD7\x9E\xD7\x97\xD7\xA8\xD7\x95\xD7\x96\xD7\xAA", 12, TOKEN_KEYWORD, STRING_T, "string" },// string
+};
+
+#endif
@@ -0,0 +1,87 @@
+# Generates keywords.h, the perfect hash table the lexer finds keywords with
+# Run it again after changing the keywords: python keywords.py > keywords.h
+
+import itertools
+
+TABLE_SIZE = 32
+
+# Spelling, token type, keyword and the English value of the token (None keeps the spelling)
+KEYWORDS = [
+    ("if", "TOKEN_KEYWORD", "IF_T", None),
+    ("else", "TOKEN_KEYWORD", "ELSE_T", None),
+    ("while", "TOKEN_KEYWORD", "WHILE_T", None),
+    ("int", "TOKEN_KEYWORD", "INT_T", None),
+    ("string", "TOKEN_KEYWORD", "STRING_T", None),
+    ("return", "TOKEN_KEYWORD", "RETURN_T", None),
+
+    ("אם", "TOKEN_KEYWORD", "IF_T", "if"),
+    ("אחרת", "TOKEN_KEYWORD", "ELSE_T", "else"),
+    ("בזמןש", "TOKEN_KEYWORD", "WHILE_T", "while"),
+    ("מספר", "TOKEN_KEYWORD", "INT_T", "int"),
+    ("מחרוזת", "TOKEN_KEYWORD", "STRING_T", "string"),
+    ("תחזיר", "TOKEN_KEYWORD", "RETURN_T", "return"),
+
+    # Names of the built in function and of the main function are identifiers in both languages
+    ("תדפיס", "TOKEN_ID", "OUT_T", "print"),
+    ("ראשי", "TOKEN_ID", "-1", "main"),
+]
+
+
+def keyword_hash(word, a, b, c):
+    return (word[0] * a + word[1] * b + word[-1] * c + len(word)) % TABLE_SIZE
+
+
+def find_multipliers(words):
+    for a, b, c in itertools.product(range(1, 64), repeat=3):
+        if len({keyword_hash(word, a, b, c) for word in words}) == len(words):
+            return a, b, c
+
+    raise SystemExit("No perfect hash for the keywords, make TABLE_SIZE bigger")
+
+
+def c_string(word):
+    return '"' + "".join(chr(byte) if byte < 0x80 else "\\x%02X" % byte for byte in word) + '"'
+
+
+def main():
+
+    words = [spelling.encode("utf-8") for spelling, _, _, _ in KEYWORDS]
+    a, b, c = find_multipliers(words)
+
+    slots = [None] * TABLE_SIZE
+    for word, (spelling, type, keyword, value) in zip(words, KEYWORDS):
+        slots[keyword_hash(word, a, b, c)] = (word, spelling, type, keyword, value)
+
+    print("#ifndef KEYWORDS_H")
+    print("#define KEYWORDS_H")
+    print('#include "lexer.h"')
+    print()
+    print("/* Generated by keywords.py, do not edit */")
+    print()
+    print("#define KEYWORD_TABLE_SIZE %d" % TABLE_SIZE)
+    print("#define KEYWORD_MIN_LENGTH %d" % min(len(word) for word in words))
+    print("#define KEYWORD_MAX_LENGTH %d" % max(len(word) for word in words))
+    print()
+    print("// Hash of the bytes of an identifier, every keyword has a slot of it's own")
+    print("#define KEYWORD_HASH(word, length) (((unsigned char)(word)[0] * %d + (unsigned char)(word)[1] * %d \\" % (a, b))
+    print("  + (unsigned char)(word)[(length) - 1] * %d + (length)) %% KEYWORD_TABLE_SIZE)" % c)
+    print()
+    print("static const lexer_keyword keywordTable[KEYWORD_TABLE_SIZE] = {")
+    print()
+
+    for slot in slots:
+        if not slot:
+            print("  { NULL, 0, 0, 0, NULL },")
+            continue
+
+        word, spelling, type, keyword, value = slot
+        entry = "  { %s, %d, %s, %s, %s }," % (c_string(word), len(word), type, keyword, c_string(value.encode()) if value else "NULL")
+        print(entry if spelling.isascii() else "%-96s// %s" % (entry, value))
+
+    print("};")
+    print()
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,12 @@
 #include "lexer.h"
+#include "keywords.h"
+#include "lexerTable.h"
+
+/*
+English letter of every Hebrew letter, in the order of their encoding (Alef to Tav),
+final letters get the letter of their normal form
+*/
+static const char hebrewLetters[] = "abcdefghijkklmmnnopqqrrstuv";
 
 /*
 init_lexer initializes the lexer with the source code (contents)
@@ -11,11 +19,17 @@ lexer_T* init_lexer(char* contents) {
 
   lexer->contents = contents;
   lexer->contentsLength = strlen(contents);
+  // Skip the byte order mark that some editors write at the start of UTF-8 files
+  if (!strncmp(contents, "\xEF\xBB\xBF", 3)) {
+    lexer->index = 3;
+  }
+
   lexer->c = contents[lexer->index];
 
-  lexer->lineIndex = 1;
+  lexer->lineBase = 1;
 
   lexer->tokens = mcalloc(1, sizeof(token_T*));
+  lexer->tokensCapacity = 1;
 
   return lexer;
 }
@@ -30,19 +44,13 @@ void lexer_advance(lexer_T* lexer) {
 }
 
 /*
-lexer_peek returns the file character from the current index position of the lexer + the offset the function is given
-Input: Lexer, offset to add to current index
-Output: File character in the desired position
+lexer_skip advances the lexer by a run of characters that was already scanned, the run can't go past the end of the source code
+Input: Lexer, amount of characters
+Output: None
 */
-char lexer_peek(lexer_T* lexer, size_t offset) {
-
-  char lexeme = -1;
-
-  if (lexer->index + 1 < lexer->contentsLength) {
-    lexeme = lexer->contents[lexer->index + offset];
-  }
-
-  return lexeme;
+void lexer_skip(lexer_T* lexer, size_t size) {
+  lexer->index += size;
+  lexer->c = lexer->contents[lexer->index];
 }
 
 /*
@@ -55,47 +63,30 @@ token_T* lexer_token_peek(lexer_T* lexer, unsigned int offset) {
   token_T* token = NULL;
 
   size_t saveLoc = lexer->index;
-  size_t saveLine = lexer->lineIndex;
 
   for (unsigned int i = 0; i < offset; i++) {
     token = lexer_get_next_token(lexer);
   }
 
   lexer->index = saveLoc;    // Return previous index
-  lexer->lineIndex = saveLine;
   lexer->c = lexer->contents[lexer->index];
 
   return token;
 }
 
 /*
-lexer_advance_current initializes a token with a type and a value
-Input: Lexer, type of token
+lexer_make_token makes a token out of the characters the lexer matched and advances past them
+Input: Lexer, type of token, amount of characters
 Output: Initialized token
 */
-token_T* lexer_advance_current(lexer_T* lexer, int type) {
+token_T* lexer_make_token(lexer_T* lexer, int type, size_t length) {
 
-  token_T* token = NULL;
-  char* value = mcalloc(1, VALUE_SIZE);
+  char* value = mcalloc(length + 1, sizeof(char));
   
-  value[0] = lexer->c;
+  memcpy(value, lexer->contents + lexer->index, length);
+  lexer_skip(lexer, length);
 
-  // If token is 2 characters long (e.g: <=, ==)
-  if (type == TOKEN_ELESS || type == TOKEN_EMORE || type == TOKEN_DEQUAL || type == TOKEN_NEQUAL) {
-    
-    value = mrealloc(value, VALUE_SIZE + 1);
-    lexer_advance(lexer);
-    value[1] = lexer->c;
-    value[2] = '\0';
-  }
-  else  {
-    value[1] = '\0';
-  }
-    
-  token = init_token(type, value);
-  lexer_advance(lexer);
-
-  return token;
+  return init_token(type, value);
 }
 
 /*
@@ -106,13 +97,7 @@ Output: None
 void lexer_skip_whitespace(lexer_T* lexer) {
 
   // Skipping Whitespace
-  while (lexer->c == ' ' || lexer->c == '\n' || lexer->c == '\t') {
-    if (lexer->c == '\n') {
-      lexer->lineIndex++;
-    }
-      
-    lexer_advance(lexer);
-  }
+  lexer_skip(lexer, scanner.whitespace(lexer->contents + lexer->index));
 
   lexer_skip_comments(lexer);
 }
@@ -122,19 +107,10 @@ void lexer_skip_comments(lexer_T* lexer) {
   // Skipping comments
   if (lexer->c == '~') {
 
-    while (lexer->c != '\n') {
-
-      if (lexer->c == '\0') {
-        break;
-      }
-        
-      lexer_advance(lexer);
-    }
+    lexer_skip(lexer, scanner.line(lexer->contents + lexer->index));
       
     lexer_advance(lexer);    // Skipping newline
 
-    lexer->lineIndex++;      // Advance newline index
-
     lexer_skip_whitespace(lexer);
   }
 }
@@ -147,48 +123,60 @@ Output: The new token
 token_T* lexer_get_next_token(lexer_T* lexer) {
 
   token_T* token = NULL;
+  size_t length = 0;
+  size_t offset = 0;
+  int type = 0;
 
   lexer_skip_whitespace(lexer);
 
-  if (isalpha(lexer->c))      { token = lexer_collect_id(lexer); }
-  else if (isdigit(lexer->c)) { token = lexer_collect_number(lexer); }
-  else if (lexer->c == '#')   { token = lexer_asm(lexer); }
-  else {
-
-    switch (lexer->c) {
-
-      case '!': token = lexer_peek(lexer, 1) == '=' ? lexer_advance_current(lexer, TOKEN_NEQUAL)
-        : lexer_advance_current(lexer, TOKEN_NOT); break;
-
-      case '=': token = lexer_peek(lexer, 1) == '=' ? lexer_advance_current(lexer, TOKEN_DEQUAL) 
-        : lexer_advance_current(lexer, TOKEN_EQUALS); break;
-
-      case '<': token = lexer_peek(lexer, 1) == '=' ? lexer_advance_current(lexer, TOKEN_ELESS)
-        : lexer_advance_current(lexer, TOKEN_LESS); break;
-
-      case '>': token = lexer_peek(lexer, 1) == '=' ? lexer_advance_current(lexer, TOKEN_EMORE)
-        : lexer_advance_current(lexer, TOKEN_MORE); break;
-
-      case '"': token = lexer_collect_string(lexer);                break;
-      case ';': token = lexer_advance_current(lexer, TOKEN_SEMI);   break;
-      case '(': token = lexer_advance_current(lexer, TOKEN_LPAREN); break;
-      case ')': token = lexer_advance_current(lexer, TOKEN_RPAREN); break;
-      case '*': token = lexer_advance_current(lexer, TOKEN_MUL);    break;
-      case '+': token = lexer_advance_current(lexer, TOKEN_ADD);    break;
-      case '/': token = lexer_advance_current(lexer, TOKEN_DIV);    break;
-      case '-': token = lexer_advance_current(lexer, TOKEN_SUB);    break;
-      case ',': token = lexer_advance_current(lexer, TOKEN_COMMA);  break;
-      case '{': token = lexer_advance_current(lexer, TOKEN_LBRACE); break;
-      case '}': token = lexer_advance_current(lexer, TOKEN_RBRACE); break;
-      case '\0': token = lexer_advance_current(lexer, TOKEN_EOF);   break;
-      default: printf("[Error in line %zu]: Unknown lexeme: '%c'", lexer->lineIndex, lexer->c); exit(1);
-    }
+  offset = lexer->index;
+
+  switch (type = lexer_match(lexer, &length)) {
+
+    // Identifiers, strings and Assembly blocks are only matched by their first character, their collectors read the rest
+    case TOKEN_ID:     token = lexer_collect_id(lexer);     break;
+    case TOKEN_STRING: token = lexer_collect_string(lexer); break;
+    case TOKEN_ASM:    token = lexer_asm(lexer);            break;
+
+    // The end of the file has no characters to advance past
+    case TOKEN_EOF: token = init_token(TOKEN_EOF, mcalloc(1, sizeof(char))); break;
+
+    case -1: printf("[Error in line %zu]: Unknown lexeme: '%c'", lexer_line(lexer, offset), lexer->c); error_exit();
+
+    default: token = lexer_make_token(lexer, type, length); break;
   }
   
+  token->offset = offset;
+
   lexer_token_list_push(lexer, token);  // Push token
   return token;
 }
 
+/*
+lexer_match runs the lexer's DFA from the current character, one table lookup for every character, and keeps the longest match
+Input: Lexer, pointer to store the length of the match in
+Output: Type of the token that was matched, -1 if no token starts at the current character
+*/
+int lexer_match(lexer_T* lexer, size_t* length) {
+
+  const unsigned char* text = (const unsigned char*)lexer->contents + lexer->index;
+  unsigned int state = LEXER_START_STATE;
+  int type = -1;
+
+  for (size_t i = 0; (state = lexerTransitions[state][lexerClasses[text[i]]]) != LEXER_DEAD_STATE; i++) {
+
+    if (lexerAccepts[state] != -1) {
+      type = lexerAccepts[state];
+      *length = i + 1;
+    }
+
+    // Only the start state leaves the dead state for the 0 at the end, and nothing comes after it
+    if (!text[i]) { break; }
+  }
+
+  return type;
+}
+
 /*
 lexer_collect_id collects an identifier token
 Input: Lexer
@@ -196,58 +184,119 @@ Output: Identifier token
 */
 token_T* lexer_collect_id(lexer_T* lexer) {
 
-  char* id = mcalloc(1, sizeof(char));
+  char* id = NULL;
   size_t size = 0;
+  size_t capacity = 0;
+  size_t start = lexer->index;
+
+  const lexer_keyword* keyword = NULL;
+  token_T* token = NULL;
   
-  /* An ID has to start with a letter but can contain numbers, letters and underscore */
-  while (isalpha(lexer->c) || isdigit(lexer->c) || lexer->c == '_') {
+  // Most identifiers are only English, they are copied in one go
+  size = scanner.identifier(lexer->contents + start);
+  capacity = size + 1;
+  id = mcalloc(capacity, sizeof(char));
+  memcpy(id, lexer->contents + start, size);
+  lexer_skip(lexer, size);
+
+  /* An ID has to start with a letter but can contain numbers, letters and underscore, the rest of it has Hebrew letters */
+  while (lexer_is_hebrew(lexer) || isalpha(lexer->c) || isdigit(lexer->c) || lexer->c == '_') {
+
+    if (lexer_is_hebrew(lexer)) {
+      id = lexer_collect_hebrew(lexer, id, &size, &capacity);
+      continue;
+    }
 
-    id = mrealloc(id, ++size);
-    id[size - 1] = lexer->c;
+    vector_push(id, size, capacity, lexer->c);
     lexer_advance(lexer);
   }
 
-  // Terminate the string with a 0
-  id = mrealloc(id, size + 1);
-  id[size] = '\0';
+  // Terminate the string with a 0, only identifiers with Hebrew letters grew past their size
+  vector_push(id, size, capacity, '\0');
+  vector_shrink(id, size, capacity);
+
+  if (!(keyword = lexer_find_keyword(lexer->contents + start, lexer->index - start))) {
+    return init_token(TOKEN_ID, id);
+  }
+
+  // Hebrew words get the value of the English word, so the rest of the compiler only sees English
+  if (keyword->value) {
+    mfree(id);
+    id = mcalloc(strlen(keyword->value) + 1, sizeof(char));
+    strcpy(id, keyword->value);
+  }
+
+  token = init_token(keyword->type, id);
+  token->keyword = keyword->keyword;
+
+  return token;
+}
+
+/*
+lexer_find_keyword finds a reserved word of one of the languages with a perfect hash, so only one word is ever compared
+Input: Bytes of the identifier in the source code, amount of bytes
+Output: The reserved word, NULL if the identifier isn't reserved
+*/
+const lexer_keyword* lexer_find_keyword(const char* word, size_t length) {
+
+  const lexer_keyword* keyword = NULL;
+
+  if (length < KEYWORD_MIN_LENGTH || length > KEYWORD_MAX_LENGTH) {
+    return NULL;
+  }
+
+  keyword = &keywordTable[KEYWORD_HASH(word, length)];
 
-  return init_token(TOKEN_ID, id);
+  return keyword->length == length && !memcmp(keyword->word, word, length) ? keyword : NULL;
 }
  
 /*
-lexer_collect_number collects a number token
-Input: Lexer
-Output: Number token
+lexer_collect_hebrew collects a run of Hebrew letters and adds it to an identifier written with English letters,
+so Hebrew and English identifiers reach the parser the same way
+Input: Lexer, identifier so far, pointers to the size and the capacity of the identifier
+Output: The identifier
 */
-token_T* lexer_collect_number(lexer_T* lexer) {
+char* lexer_collect_hebrew(lexer_T* lexer, char* id, size_t* size, size_t* capacity) {
 
-  char* num = NULL;
-  size_t size = 0;
+  while (lexer_is_hebrew(lexer)) {
 
-  /* Collect number */
-  while (isdigit(lexer->c)) {
-    num = mrealloc(num, ++size);
-    num[size - 1] = lexer->c;
+    vector_push(id, *size, *capacity, hebrewLetters[(unsigned char)lexer->contents[lexer->index + 1] - HEBREW_FIRST_LETTER]);
+
+    lexer_advance(lexer);
     lexer_advance(lexer);
   }
-  /* Terminate string with a 0 */
-  num = mrealloc(num, size + 1);
-  num[size] = '\0';
 
-  return init_token(TOKEN_NUMBER, num);
+  return id;
+}
+
+/*
+lexer_is_hebrew checks if the lexer is at the start of a Hebrew letter
+Input: Lexer
+Output: True if the next 2 bytes are a Hebrew letter
+*/
+bool lexer_is_hebrew(lexer_T* lexer) {
+
+  unsigned char second = 0;
+
+  if ((unsigned char)lexer->c != HEBREW_LEAD_BYTE) {
+    return false;
+  }
+
+  second = (unsigned char)lexer->contents[lexer->index + 1];
+  return second >= HEBREW_FIRST_LETTER && second <= HEBREW_LAST_LETTER;
 }
 
 token_T* lexer_asm(lexer_T* lexer) {
 
   char* code = NULL;
   size_t size = 0;
+  size_t capacity = 0;
 
   lexer_advance(lexer);
   while (lexer->c == '\t') { lexer_advance(lexer); }
   
   while (lexer->c != '#') {
-    code = mrealloc(code, ++size);
-    code[size - 1] = lexer->c;
+    vector_push(code, size, capacity, lexer->c);
     lexer_advance(lexer);
     while (lexer->c == '\t') { lexer_advance(lexer); }
   }
@@ -255,8 +304,8 @@ token_T* lexer_asm(lexer_T* lexer) {
   lexer_advance(lexer);
 
   /* Terminate string with a 0 */
-  code = mrealloc(code, size + 1);
-  code[size] = '\0';
+  vector_push(code, size, capacity, '\0');
+  vector_shrink(code, size, capacity);
 
   return init_token(TOKEN_ASM, code);
 }
@@ -268,10 +317,11 @@ Output: String token
 */
 token_T* lexer_collect_string(lexer_T* lexer) {
 
-  char* string = mcalloc(1, sizeof(char));
+  char* string = NULL;
   size_t size = 0;
+  size_t capacity = 0;
 
-  size_t line = lexer->lineIndex;
+  size_t start = lexer->index;
 
   lexer_advance(lexer);
 
@@ -281,23 +331,123 @@ token_T* lexer_collect_string(lexer_T* lexer) {
     // If we reached the end of the file without getting an ending quote, raise error
     if (lexer->c == '\0') {
 
-      printf("[Error in line %zu]: Start of string was never ended", line);
-      exit(1);
+      printf("[Error in line %zu]: Start of string was never ended", lexer_line(lexer, start));
+      error_exit();
     }
 
-    string = mrealloc(string, ++size);
-    string[size - 1] = lexer->c;  
+    vector_push(string, size, capacity, lexer->c);
     lexer_advance(lexer);
   }
   // Terminate string with a 0
-  string = mrealloc(string, size + 1);
-  string[size] = '\0';
+  vector_push(string, size, capacity, '\0');
+  vector_shrink(string, size, capacity);
 
   lexer_advance(lexer);
 
   return init_token(TOKEN_STRING, string);
 }
 
+/*
+lexer_split_statements splits the source code into it's top level statements, skipping strings, Assembly blocks and comments
+the same way the lexer does, so their braces and semicolons don't count
+Input: Source code, pointer to store the amount of statements in
+Output: Statements in the order they appear, NULL if the braces don't match or there is code after the last statement
+*/
+lexer_chunk* lexer_split_statements(char* contents, size_t* size) {
+
+  lexer_chunk* chunks = NULL;
+  size_t capacity = 0;
+  size_t depth = 0;
+  size_t start = 0;
+  bool empty = true;    // Only whitespace and comments since the end of the last statement
+  char* end = NULL;
+
+  *size = 0;
+
+  for (size_t i = 0; contents[i]; i++) {
+
+    switch (contents[i]) {
+
+    case '\n':
+    case ' ':
+    case '\t': break;
+
+    // Comments go until the end of the line
+    case '~':
+      i += scanner.line(contents + i + 1);
+      break;
+
+    case '"':
+    case '#':
+
+      if (!(end = strchr(contents + i + 1, contents[i]))) {
+        mfree(chunks);
+        return NULL;
+      }
+
+      i = end - contents;
+      empty = false;
+      break;
+
+    case '{': depth++; empty = false; break;
+
+    case '}':
+
+      if (!depth) {
+        mfree(chunks);
+        return NULL;
+      }
+
+      if (!--depth) {
+        chunks = lexer_push_chunk(chunks, size, &capacity, start, i + 1, true);
+        start = i + 1;
+        empty = true;
+      }
+
+      break;
+
+    case ';':
+
+      if (!depth) {
+        chunks = lexer_push_chunk(chunks, size, &capacity, start, i + 1, false);
+        start = i + 1;
+        empty = true;
+      }
+      else {
+        empty = false;
+      }
+
+      break;
+
+    default: empty = false; break;
+    }
+  }
+
+  if (depth || !empty) {
+    mfree(chunks);
+    return NULL;
+  }
+
+  return chunks;
+}
+
+/*
+lexer_push_chunk adds a statement to the list of statements, growing it when it's full
+Input: Statements, amount of statements, capacity of the list, start and end of the statement, true if it ends with a block
+Output: The list of statements
+*/
+lexer_chunk* lexer_push_chunk(lexer_chunk* chunks, size_t* size, size_t* capacity, size_t start, size_t end, bool block) {
+
+  vector_reserve(chunks, *capacity, *size + 1);
+
+  chunks[*size].start = start;
+  chunks[*size].length = end - start;
+  chunks[*size].block = block;
+  (*size)++;
+
+  return chunks;
+}
+
 /*
 lexer_token_list_push pushes a token to the list of tokens so we can free them later
 Input: Lexer, token to push
@@ -305,22 +455,81 @@ Output: None
 */
 void lexer_token_list_push(lexer_T* lexer, token_T* token) {
 
-  lexer->tokens = mrealloc(lexer->tokens, sizeof(token_T*) * ++lexer->tokensSize);
-  lexer->tokens[lexer->tokensSize - 1] = token;
+  vector_push(lexer->tokens, lexer->tokensSize, lexer->tokensCapacity, token);
+
+  stats_add(STATS_TOKENS, 1);
 }
 
 /*
-lexer_free_tokens frees the list of tokens and their values
+lexer_free_tokens frees the list of tokens and their values, and the line table
 Input: Lexer with the list of tokens
 Output: None
 */
 void lexer_free_tokens(lexer_T* lexer) {
 
   for (unsigned int i = 0; i < lexer->tokensSize; i++) {
-    free(lexer->tokens[i]->value);
-    free(lexer->tokens[i]);
+    mfree(lexer->tokens[i]->value);
+    mfree(lexer->tokens[i]);
+  }
+
+  mfree(lexer->tokens);
+  mfree(lexer->lines);
+}
+
+/*
+lexer_build_lines makes the table of the offsets of the newlines of the source code, it is only made when a line is needed
+Input: Lexer
+Output: None
+*/
+void lexer_build_lines(lexer_T* lexer) {
+
+  lexer->linesSize = scanner.newlines(lexer->contents, lexer->contentsLength, NULL);
+  lexer->lines = mcalloc(lexer->linesSize + 1, sizeof(size_t));
+
+  scanner.newlines(lexer->contents, lexer->contentsLength, lexer->lines);
+}
+
+/*
+lexer_position finds the line and the column of an offset in the source code, with a binary search on the line table
+Input: Lexer, offset, pointers to store the line and the column in (both start at 1)
+Output: None
+*/
+void lexer_position(lexer_T* lexer, size_t offset, size_t* line, size_t* column) {
+
+  size_t low = 0;
+  size_t high = 0;
+  size_t middle = 0;
+
+  if (!lexer->lines) {
+    lexer_build_lines(lexer);
+  }
+
+  high = lexer->linesSize;
+
+  // Find the amount of newlines before the offset
+  while (low < high) {
+
+    middle = low + (high - low) / 2;
+
+    if (lexer->lines[middle] < offset) { low = middle + 1; }
+    else { high = middle; }
   }
 
-  free(lexer->tokens);
+  *line = lexer->lineBase + low;
+  *column = low ? offset - lexer->lines[low - 1] : offset + 1;
+}
+
+/*
+lexer_line finds the line of an offset in the source code
+Input: Lexer, offset
+Output: Line of the offset
+*/
+size_t lexer_line(lexer_T* lexer, size_t offset) {
+
+  size_t line = 0;
+  size_t column = 0;
+
+  lexer_position(lexer, offset, &line, &column);
+
+  return line;
 }
- 
\ No newline at end of file
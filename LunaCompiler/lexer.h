@@ -1,38 +1,83 @@
 #ifndef LEXER_H
 #define LEXER_H
 #include "AST.h"
-#define VALUE_SIZE 2
+#include "scan.h"
+
+// Hebrew letters are encoded in UTF-8 as 0xD7 followed by 0x90 (Alef) up to 0xAA (Tav)
+#define HEBREW_LEAD_BYTE 0xD7
+#define HEBREW_FIRST_LETTER 0x90
+#define HEBREW_LAST_LETTER 0xAA
 
 typedef struct LEXER_STRUCT {
 
   token_T** tokens;
   size_t tokensSize;
+  size_t tokensCapacity;
 
   size_t index;
-  size_t lineIndex;
   size_t contentsLength;
 
+  size_t lineBase;      // Line the contents start in, statements that are lexed on their own don't start in the first line
+  size_t* lines;        // Offsets of the newlines, NULL until a line is needed
+  size_t linesSize;
+
   char* contents;
   char c;
 
 } lexer_T;
 
+/* A top level statement of the source code, found by matching braces without making tokens */
+typedef struct LEXER_CHUNK_STRUCT {
+
+  size_t start;
+  size_t length;
+
+  bool block;       // The statement ends with a block, so it can be a function
+
+} lexer_chunk;
+
+/* A reserved word of one of the languages, see keywords.h */
+typedef struct LEXER_KEYWORD_STRUCT {
+
+  const char* word;     // UTF-8 bytes of the word
+  size_t length;
+  int type;             // Type of the token, keywords or the identifiers that have a Hebrew name
+  int keyword;          // See KEYWORD_ENUM
+  const char* value;    // English value of the token, NULL if it is the word itself
+
+} lexer_keyword;
+
 
 void lexer_advance(lexer_T* lexer);
+void lexer_skip(lexer_T* lexer, size_t size);
 void lexer_skip_whitespace(lexer_T* lexer);
 void lexer_skip_comments(lexer_T* lexer);
 void lexer_token_list_push(lexer_T* lexer, token_T* token);
 void lexer_free_tokens(lexer_T* lexer);
 
 lexer_T* init_lexer(char* contents);
+token_T* lexer_make_token(lexer_T* lexer, int type, size_t length);
 token_T* lexer_token_peek(lexer_T* lexer, unsigned int offset);
 token_T* lexer_get_next_token(lexer_T* lexer);
 token_T* lexer_collect_id(lexer_T* lexer);
-token_T* lexer_collect_number(lexer_T* lexer);
 token_T* lexer_collect_string(lexer_T* lexer);
 token_T* lexer_asm(lexer_T* lexer);
 
-char lexer_peek(lexer_T* lexer, size_t offset);
+char* lexer_collect_hebrew(lexer_T* lexer, char* id, size_t* size, size_t* capacity);
+
+const lexer_keyword* lexer_find_keyword(const char* word, size_t length);
+
+bool lexer_is_hebrew(lexer_T* lexer);
+
+int lexer_match(lexer_T* lexer, size_t* length);
+
+lexer_chunk* lexer_split_statements(char* contents, size_t* size);
+lexer_chunk* lexer_push_chunk(lexer_chunk* chunks, size_t* size, size_t* capacity, size_t start, size_t end, bool block);
+
+void lexer_build_lines(lexer_T* lexer);
+void lexer_position(lexer_T* lexer, size_t offset, size_t* line, size_t* column);
+
+size_t lexer_line(lexer_T* lexer, size_t offset);
 
 #endif
  
\ No newline at end of file
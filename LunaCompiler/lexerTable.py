@@ -0,0 +1,154 @@
+# Generates lexerTable.h, the DFA lexer_get_next_token finds the type and the length of the next token with
+# Run it again after changing the tokens: python lexerTable.py > lexerTable.h
+
+LETTERS = set(range(ord("a"), ord("z") + 1)) | set(range(ord("A"), ord("Z") + 1))
+DIGITS = set(range(ord("0"), ord("9") + 1))
+HEBREW_LEAD = {0xD7}
+HEBREW_LETTERS = set(range(0x90, 0xAB))
+
+
+def literal(text):
+    return [({ord(char)}, False) for char in text]
+
+
+# Every rule is a sequence of (bytes, repeat) items and the token it makes, when two rules match the same text the first one wins.
+# Identifiers, strings and Assembly blocks only match their first character, the lexer collects the rest of them
+RULES = [
+    (literal("=="), "TOKEN_DEQUAL"),
+    (literal("="), "TOKEN_EQUALS"),
+    (literal("!="), "TOKEN_NEQUAL"),
+    (literal("!"), "TOKEN_NOT"),
+    (literal("<="), "TOKEN_ELESS"),
+    (literal("<<"), "TOKEN_SHL"),
+    (literal("<"), "TOKEN_LESS"),
+    (literal(">="), "TOKEN_EMORE"),
+    (literal(">>"), "TOKEN_SHR"),
+    (literal(">"), "TOKEN_MORE"),
+    (literal("&&"), "TOKEN_LAND"),
+    (literal("&"), "TOKEN_BAND"),
+    (literal("||"), "TOKEN_LOR"),
+    (literal("|"), "TOKEN_BOR"),
+    (literal("^"), "TOKEN_XOR"),
+    (literal(";"), "TOKEN_SEMI"),
+    (literal("("), "TOKEN_LPAREN"),
+    (literal(")"), "TOKEN_RPAREN"),
+    (literal("*"), "TOKEN_MUL"),
+    (literal("+"), "TOKEN_ADD"),
+    (literal("/"), "TOKEN_DIV"),
+    (literal("-"), "TOKEN_SUB"),
+    (literal(","), "TOKEN_COMMA"),
+    (literal("{"), "TOKEN_LBRACE"),
+    (literal("}"), "TOKEN_RBRACE"),
+    ([(DIGITS, True)], "TOKEN_NUMBER"),
+    ([(LETTERS, False)], "TOKEN_ID"),
+    ([(HEBREW_LEAD, False), (HEBREW_LETTERS, False)], "TOKEN_ID"),
+    (literal('"'), "TOKEN_STRING"),
+    (literal("#"), "TOKEN_ASM"),
+    ([({0}, False)], "TOKEN_EOF"),
+]
+
+
+def character_classes():
+    """Bytes that every rule treats the same way share a class, class 0 is the bytes no rule uses"""
+
+    sets = []
+    for items, _ in RULES:
+        for bytes, _ in items:
+            if bytes not in sets:
+                sets.append(bytes)
+
+    signatures = {}
+    classes = []
+    for byte in range(256):
+        signature = tuple(byte in bytes for bytes in sets)
+        if not any(signature):
+            classes.append(0)
+            continue
+        classes.append(signatures.setdefault(signature, len(signatures) + 1))
+
+    return classes, len(signatures) + 1
+
+
+def step(positions, byte):
+    """NFA positions are (rule, items matched), a repeated item can match again"""
+
+    result = set()
+    for rule, matched in positions:
+        items = RULES[rule][0]
+        if matched < len(items) and byte in items[matched][0]:
+            result.add((rule, matched + 1))
+        if matched > 0 and items[matched - 1][1] and byte in items[matched - 1][0]:
+            result.add((rule, matched))
+
+    return frozenset(result)
+
+
+def build():
+
+    classes, classCount = character_classes()
+    representative = [classes.index(index) for index in range(classCount)]
+
+    dead = frozenset()
+    start = frozenset((rule, 0) for rule in range(len(RULES)))
+    states = [dead, start]
+    numbers = {dead: 0, start: 1}
+    transitions = []
+
+    index = 0
+    while index < len(states):
+        row = []
+        for byte in representative:
+            target = step(states[index], byte) if states[index] else dead
+            if target not in numbers:
+                numbers[target] = len(states)
+                states.append(target)
+            row.append(numbers[target])
+        transitions.append(row)
+        index += 1
+
+    accepts = []
+    for state in states:
+        done = [rule for rule, matched in state if matched == len(RULES[rule][0])]
+        accepts.append(RULES[min(done)][1] if done else "-1")
+
+    return classes, classCount, transitions, accepts
+
+
+def main():
+
+    classes, classCount, transitions, accepts = build()
+
+    print("#ifndef LEXERTABLE_H")
+    print("#define LEXERTABLE_H")
+    print('#include "tokens.h"')
+    print()
+    print("/* Generated by lexerTable.py, do not edit */")
+    print()
+    print("#define LEXER_STATES %d" % len(transitions))
+    print("#define LEXER_CLASSES %d" % classCount)
+    print("#define LEXER_DEAD_STATE 0")
+    print("#define LEXER_START_STATE 1")
+    print()
+    print("// Character class of every byte")
+    print("static const unsigned char lexerClasses[256] = {")
+    for row in range(0, 256, 16):
+        print("  " + ", ".join("%2d" % value for value in classes[row:row + 16]) + ",")
+    print("};")
+    print()
+    print("// Next state of every state and character class")
+    print("static const unsigned char lexerTransitions[LEXER_STATES][LEXER_CLASSES] = {")
+    for row in transitions:
+        print("  { " + ", ".join("%2d" % value for value in row) + " },")
+    print("};")
+    print()
+    print("// Token type of the accepting states, -1 for the other states")
+    print("static const int lexerAccepts[LEXER_STATES] = {")
+    for accept in accepts:
+        print("  %s," % accept)
+    print("};")
+    print()
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()
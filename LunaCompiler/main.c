@@ -1,91 +1,103 @@
-#include "codeGen.h"
+#include "server.h"
 #define SIZE 100
 
 
 int main(int argc, char** argv) {
 
-  FILE* file = NULL;
+  compile_options options = { OUTPUT_MASM, false, true, true };
+  batch_T batch = { 0 };
+  long long result = 0;
+  int threads = 0;
+  size_t failed = 0;
 
-  char* command = NULL;
-  char* filename = NULL;
-  char* newFilename = NULL;
+  scan_init();    // Pick the fastest scanners for the lexer before anything is lexed
 
-  char* contents = NULL;
+  // Batch mode: LunaCompiler -j <threads> <files, @response files and flags>
+  if (argv[1] && !strcmp(argv[1], "-j")) {
 
-  // Raise error if user didn't input filename or compile mode
-  if (!argv[1] || !argv[2]) {
-    printf("[ERROR]: Some file input is missing"); exit(1);
-  }
+    if (!argv[2] || (threads = atoi(argv[2])) < 0) {
+      printf("[ERROR]: -j needs an amount of threads"); exit(1);
+    }
 
-  newFilename = make_new_filename(argv[1], ".asm");  // Set output filename to be the code filename with a .asm extention
-  
-  // If user wants to compile in Hebrew, run the translator and replace the file with the translated file
-  if (!strcmp(argv[2], "-h")) {
+    // A batch only writes the outputs, a build links them itself
+    options.printIR = false;
+    options.assemble = false;
+    batch.options = &options;
 
-    /* 
-    Allocate a string to run the python translator file
-    The translator takes a source code and replaces Hebrew keywords with English keywords
-    NOTE: Hebrew words that are not reserved get translated to a gibberish English word
-    */
-    command = mcalloc(1, strlen("python translator.py ") + strlen(argv[1]) + 1);
-    sprintf(command, "python translator.py %s", argv[1]);
-    system(command);
+    for (int i = 3; i < argc; i++) {
 
-    filename = mcalloc(1, strlen(argv[1]) + strlen("translated_") + 1);
-    sprintf(filename, "translated_%s", argv[1]);
+      if (argv[i][0] == '@') {
+        batch_read_response_file(&batch, argv[i] + 1);
+      }
+      else if (argv[i][0] != '-') {
+        batch_add_file(&batch, argv[i]);
+      }
+      else if (!compile_parse_flag(&options, argv[i])) {
+        printf("[ERROR]: Unrecognized flag %s", argv[i]); exit(1);
+      }
+    }
 
-    free(command);
-  }
-  // Otherwise, we just want to use the normal filename
-  else {
-    filename = mcalloc(1, strlen(argv[1]) + 1);
-    strcpy(filename, argv[1]);
+    if (!batch.size) {
+      printf("[ERROR]: Some file input is missing"); exit(1);
+    }
+
+    // With -stats the files are compiled one at a time, so every phase only counts the allocations of one file
+    failed = batch_compile(&batch, stats.enabled ? 1 : threads ? (unsigned int)threads : pool_default_threads());
+
+    if (failed) {
+      printf("[ERROR]: %zu of %zu files didn't compile\n", failed, batch.size);
+    }
+
+    batch_free(&batch);
+
+    if (stats.enabled) {
+      stats_report(stderr);
+    }
+
+    return failed ? 1 : 0;
   }
 
-  if (strcmp(get_filename_ext(filename), "luna")) {
-    printf("[ERROR]: Unrecognized file extention\n"); exit(1);
+  // Server mode: LunaCompiler -server <socket path> <flags>
+  if (argv[1] && !strcmp(argv[1], "-server")) {
+
+    if (!argv[2]) {
+      printf("[ERROR]: -server needs a socket path"); exit(1);
+    }
+
+    options.printIR = false;
+    options.assemble = false;
+    options.useCache = true;
+
+    for (int i = 3; i < argc; i++) {
+
+      if (!compile_parse_flag(&options, argv[i])) {
+        printf("[ERROR]: Unrecognized flag %s", argv[i]); exit(1);
+      }
+    }
+
+    return server_run(argv[2], &options);
   }
 
-  if (!(file = fopen(filename, "r"))) {    // Read file
-    printf("[ERROR]: File does not exist\n"); exit(1);
+  // Raise error if user didn't input filename or compile mode
+  if (!argv[1] || !argv[2]) {
+    printf("[ERROR]: Some file input is missing"); exit(1);
   }
-  
-  contents = read_file(file);             // Read contents of file
 
-  if (!contents) {
-    printf("[ERROR]: Couldn't read file contents"); exit(1);
+  // The compile mode is a flag too, the lexer reads Hebrew and English so it doesn't change anything
+  for (int i = 2; i < argc; i++) {
+
+    if (!compile_parse_flag(&options, argv[i])) {
+      printf("[ERROR]: Unrecognized flag %s", argv[i]); exit(1);
+    }
   }
-  
-  lexer_T* const lexer = init_lexer(contents);           // Initialize lexer
-  parser_T* const parser = init_parser(lexer);           // Initialize Parser
-  AST* const root = parser_parse(parser);                // Parse the tokens into an AST
-  TAC_list* const instructions = traversal_visit(root);  // Visit the AST and generate an intermidiate representation
-
-  //table_print_table(parser->table, 0);
-  traversal_print_instructions(instructions);
-  
-  // Write the Assembly code from the given IR
-  write_asm(parser->table, instructions->head, newFilename);
-
-  assemble_file(newFilename);
-
-  // Free everything
-  lexer_free_tokens(lexer);
-  AST_free_AST(root);
-  traversal_free_array(instructions);
-  table_free_table(parser->table);
-  free(contents);
-  free(lexer);
-  free(parser->reserved);
-  free(parser);
-
-  // If we made a new file for the translated version from Hebrew, delete that file
-  if (!strcmp(argv[2], "-h")) {
-    remove(filename);
+
+  result = compile_file(argv[1], &options);
+
+  // The report goes to stderr, so it doesn't mix with the IR and the output of programs that run in the compiler
+  if (stats.enabled) {
+    stats_report(stderr);
   }
-    
-  free(newFilename);
-  free(filename);
-    
-  return 0;
+
+  // When the program ran inside the compiler, exit with the value it returned like the program itself would
+  return (int)result;
 }
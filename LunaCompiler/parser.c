@@ -1,5 +1,39 @@
 #include "parser.h"
 
+/*
+Operators of expressions by their token, the rest of the tokens have a precedence of 0.
+The precedences are the same as in C, from || that binds the loosest to * and / that bind the tightest
+*/
+static const parser_operator parserOperators[TOKEN_END] = {
+
+  [TOKEN_LOR]    = { AST_BOR, TOKEN_LOR, 1 },
+  [TOKEN_LAND]   = { AST_BAND, TOKEN_LAND, 2 },
+  [TOKEN_BOR]    = { AST_BOR, TOKEN_BOR, 3 },
+  [TOKEN_XOR]    = { AST_XOR, TOKEN_XOR, 4 },
+  [TOKEN_BAND]   = { AST_BAND, TOKEN_BAND, 5 },
+  [TOKEN_DEQUAL] = { AST_COMPARE, TOKEN_DEQUAL, 6 },
+  [TOKEN_NEQUAL] = { AST_COMPARE, TOKEN_NEQUAL, 6 },
+  [TOKEN_LESS]   = { AST_COMPARE, TOKEN_LESS, 7 },
+  [TOKEN_MORE]   = { AST_COMPARE, TOKEN_MORE, 7 },
+  [TOKEN_ELESS]  = { AST_COMPARE, TOKEN_ELESS, 7 },
+  [TOKEN_EMORE]  = { AST_COMPARE, TOKEN_EMORE, 7 },
+  [TOKEN_SHL]    = { AST_SHL, TOKEN_SHL, 8 },
+  [TOKEN_SHR]    = { AST_SHR, TOKEN_SHR, 8 },
+  [TOKEN_ADD]    = { AST_ADD, TOKEN_ADD, 9 },
+  [TOKEN_SUB]    = { AST_SUB, TOKEN_SUB, 9 },
+  [TOKEN_MUL]    = { AST_MUL, TOKEN_MUL, 10 },
+  [TOKEN_DIV]    = { AST_DIV, TOKEN_DIV, 10 },
+};
+
+/* Operators that go before an operand, + does nothing so it is skipped instead */
+static const parser_operator parserUnaryOperators[TOKEN_END] = {
+
+  [TOKEN_SUB] = { AST_SUB, TOKEN_SUB, PARSER_UNARY_PRECEDENCE },
+  [TOKEN_NOT] = { AST_COMPARE, TOKEN_NOT, PARSER_UNARY_PRECEDENCE },
+};
+
+static const parser_operator parserParenthesis = { TOKEN_LPAREN, TOKEN_LPAREN, 0 };    // Waits on the operator stack until it's closed
+
 /*
 init_parser initializes the parser
 Input: Lexer
@@ -15,17 +49,34 @@ parser_T* init_parser(lexer_T* lexer) {
   parser->table = init_table(NULL);  // Initialize root table and set parent to NULL
 
   table_add_builtin_functions(parser->table);
-
-  parser->reserved = mcalloc(1, sizeof(char*) * RESERVED_SIZE);  // Allocate an array for the reserved values
-
-  // For each reserved value, add it to the array
-  for (unsigned int i = 0; i < RESERVED_SIZE; i++) {
-    parser->reserved[i] = reserved_to_string(i);
-  }
     
   return parser;
 }
 
+/*
+init_chunk_parser initializes a parser for one top level statement, it shares the symbol table and the keywords of the main parser
+Input: Main parser, chunk to store the parser in, the statement's place in the source code
+Output: Parser
+*/
+parser_T* init_chunk_parser(parser_T* parser, parser_chunk* chunk, lexer_chunk* statement) {
+
+  parser_T* chunkParser = mcalloc(1, sizeof(parser_T));
+
+  // The lexer needs the statement to end with a 0
+  chunk->contents = mcalloc(statement->length + 1, sizeof(char));
+  memcpy(chunk->contents, parser->lexer->contents + statement->start, statement->length);
+
+  chunkParser->lexer = init_lexer(chunk->contents);
+  chunkParser->lexer->lineBase = lexer_line(parser->lexer, statement->start);
+  chunkParser->token = lexer_get_next_token(chunkParser->lexer);
+
+  chunkParser->table = parser->table;
+
+  chunk->parser = chunkParser;
+
+  return chunkParser;
+}
+
 /*
 parser_expect advances the parser if the next token is matching the function's given token
 Input: Parser, expected type
@@ -39,10 +90,10 @@ token_T* parser_expect(parser_T* parser, int type) {
   }
   else {
     // For ID tokens print the wrong ID token and the one missing and for other tokens just print them as is
-    parser->token->type == TOKEN_ID ? printf("[Error in line %zu]: Missing token %s, got: %s", parser->lexer->lineIndex, typeToString(type), parser->token->value) 
-      : printf("[Error in line %zu]: Missing token %s, got: %s", parser->lexer->lineIndex, typeToString(type), typeToString(parser->token->type));
+    parser->token->type == TOKEN_ID || parser->token->type == TOKEN_KEYWORD ? printf("[Error in line %zu]: Missing token %s, got: %s", parser_line(parser), typeToString(type), parser->token->value) 
+      : printf("[Error in line %zu]: Missing token %s, got: %s", parser_line(parser), typeToString(type), typeToString(parser->token->type));
 
-    exit(1);  // Terminate with error
+    error_exit();  // Terminate with error
   }
 
   return parser->token;
@@ -54,6 +105,14 @@ Input: Parser
 Output: Root of the abstract syntax tree
 */
 AST* parser_parse(parser_T* parser) {
+
+  AST* root = NULL;
+
+  // With more than one core, the bodies of the functions are parsed in parallel
+  if (pool_default_threads() > 1 && (root = parser_lib_parallel(parser, 2))) {
+    return root;
+  }
+
   return parser_lib(parser);  // Start parsing the tokens and set the root of the AST to be the start of the program
 }
 
@@ -66,35 +125,164 @@ AST* parser_lib(parser_T* parser) {
 
   AST* root = init_AST(AST_PROGRAM);  // Initialize program node
   AST* node = NULL;
-  size_t funcCounter = 0;
-  size_t globalCounter = 0;
 
   do {
     // Global statements only include functions and global declarations
     node = parser_statement(parser);
+    parser_add_global(parser, root, node);
 
-    // For functions, advance the function list of the program
-    if (node->type == AST_FUNCTION) {
-      root->function_list = mrealloc(root->function_list, sizeof(AST*) * ++funcCounter);
-      root->function_list[funcCounter - 1] = node;
-    }
-    // For anything global that is not a function, advance the children component of the program
-    else if (node->type == AST_VARIABLE_DEC) {  
-      root->children = mrealloc(root->children, sizeof(AST*) * ++globalCounter);
-      root->children[globalCounter - 1] = node;
+  } while (parser->token->type != TOKEN_EOF);
+
+  return root;
+}
+
+/*
+parser_lib_parallel parses the program like parser_lib, but every top level statement gets a parser of it's own.
+Global declarations and function headers are parsed in order, so the global scope is built exactly like it would be,
+then the function bodies are parsed on a pool of threads
+Input: Parser, least amount of functions that is worth splitting the program for
+Output: Program node, NULL if the source code can't be split into statements or it has less functions
+*/
+AST* parser_lib_parallel(parser_T* parser, size_t minFunctions) {
+
+  AST* root = NULL;
+  AST* node = NULL;
+  parser_T* chunkParser = NULL;
+  parser_chunk* chunk = NULL;
+  parser_chunk** functions = NULL;
+  lexer_chunk* statements = NULL;
+
+  size_t size = 0;
+  size_t functionsSize = 0;
+  int type = 0;
+
+  if (!(statements = lexer_split_statements(parser->lexer->contents, &size))) { return NULL; }
+
+  for (size_t i = 0; i < size; i++) {
+    functionsSize += statements[i].block;
+  }
+
+  if (functionsSize < minFunctions) {
+    mfree(statements);
+    return NULL;
+  }
+
+  root = init_AST(AST_PROGRAM);
+  functions = mcalloc(functionsSize + 1, sizeof(parser_chunk*));
+  functionsSize = 0;
+
+  parser->chunks = mcalloc(size, sizeof(parser_chunk));
+  parser->chunksSize = size;
+
+  for (size_t i = 0; i < size; i++) {
+
+    chunk = &parser->chunks[i];
+    chunkParser = init_chunk_parser(parser, chunk, &statements[i]);
+    type = parser_check_reserved(chunkParser);
+
+    chunk->start = statements[i].start;
+    chunk->length = statements[i].length;
+
+    // Only the header of a function is parsed now, it adds the function and it's scope to the global scope
+    if (statements[i].block && (type == INT_T || type == STRING_T) && lexer_token_peek(chunkParser->lexer, 2)->type == TOKEN_LPAREN) {
+
+      node = chunk->node = parser_function_header(chunkParser);
+      chunk->table = chunkParser->table;
+      chunk->globals.entrySize = parser->table->entrySize;
+      chunk->body = chunkParser->token->offset;
+      chunk->headerTokens = chunkParser->lexer->tokensSize;
+
+      functions[functionsSize++] = chunk;
     }
     else {
-      printf("[Error in line %zu]: Statement was found outside of a function", parser->lexer->lineIndex); exit(1);
+
+      node = chunk->node = parser_statement(chunkParser);
+
+      if (chunkParser->token->type != TOKEN_EOF) {
+        printf("[Error in line %zu]: Invalid syntax", parser_line(chunkParser)); error_exit();
+      }
     }
 
-  } while (parser->token->type != TOKEN_EOF);
+    parser_add_global(chunkParser, root, node);
+  }
+
+  // The global scope doesn't change anymore, so every function can get a view of the part of it that it can see
+  for (size_t i = 0; i < functionsSize; i++) {
+    functions[i]->globals.entries = parser->table->entries;
+  }
+
+  pool_run(pool_default_threads(), functionsSize, parser_function_job, functions);
 
-  root->functionsSize = funcCounter;
-  root->size = globalCounter;
+  mfree(functions);
+  mfree(statements);
 
   return root;
 }
 
+/*
+parser_function_job parses the body of a function, it runs on a thread of the pool
+Input: Functions, index of the function, index of the thread
+Output: None
+*/
+void parser_function_job(void* context, size_t index, unsigned int worker) {
+
+  parser_chunk* chunk = ((parser_chunk**)context)[index];
+  parser_T* parser = chunk->parser;
+  table_T* globals = chunk->table->prev;
+
+  // While the body is parsed, the function's scope is linked to it's view of the global scope
+  chunk->table->prev = &chunk->globals;
+
+  chunk->node->function_body = parser_block(parser);
+
+  if (parser->token->type != TOKEN_EOF) {
+    printf("[Error in line %zu]: Invalid syntax", parser_line(parser)); error_exit();
+  }
+
+  chunk->table->prev = globals;
+  parser->table = globals;
+}
+
+/*
+parser_add_global adds a top level statement to the program node
+Input: Parser, program node, statement
+Output: None
+*/
+void parser_add_global(parser_T* parser, AST* root, AST* node) {
+
+  // For functions, advance the function list of the program
+  if (node->type == AST_FUNCTION) {
+    vector_push(root->function_list, root->functionsSize, root->functionsCapacity, node);
+  }
+  // For anything global that is not a function, advance the children component of the program
+  else if (node->type == AST_VARIABLE_DEC) {  
+    vector_push(root->children, root->size, root->capacity, node);
+  }
+  else {
+    printf("[Error in line %zu]: Statement was found outside of a function", parser_line(parser)); error_exit();
+  }
+}
+
+/*
+parser_free_chunks frees the parsers of the top level statements, including their tokens
+Input: Main parser
+Output: None
+*/
+void parser_free_chunks(parser_T* parser) {
+
+  for (size_t i = 0; i < parser->chunksSize; i++) {
+
+    lexer_free_tokens(parser->chunks[i].parser->lexer);
+    mfree(parser->chunks[i].parser->lexer);
+    mfree(parser->chunks[i].parser);
+    mfree(parser->chunks[i].contents);
+  }
+
+  mfree(parser->chunks);
+  parser->chunks = NULL;
+  parser->chunksSize = 0;
+}
+
 /*
 parser_function parses a function and it's children which are statements
 Input: Parser
@@ -102,18 +290,33 @@ Output: Function node
 */
 AST* parser_function(parser_T* parser) {
 
+  AST* node = parser_function_header(parser);
+
+  node->function_body = parser_block(parser);    // Start parsing the function block
+
+  parser->table = parser->table->prev;      // When done, go back to the root symbol table
+
+  return node;
+}
+
+/*
+parser_function_header parses the return type, name and arguments of a function, and goes into the function's scope
+Input: Parser
+Output: Function node without a body
+*/
+AST* parser_function_header(parser_T* parser) {
+
   AST* node = init_AST(AST_FUNCTION);      // Initialize function node
-  size_t counter = 0;
 
   switch (parser_check_reserved(parser)) {
 
     case INT_T: node->var_type = DATA_INT; break;
     //case STRING_T: node->var_type = DATA_STRING; break;  // Currently no string return is allowed :(
-    default: printf("[Error in line %zu]: Invalid return value", parser->lexer->lineIndex); 
-      exit(1);
+    default: printf("[Error in line %zu]: Invalid return value", parser_line(parser)); 
+      error_exit();
   }
     
-  parser->token = parser_expect(parser, TOKEN_ID);
+  parser->token = parser_expect(parser, TOKEN_KEYWORD);
     
   if (parser->token->type == TOKEN_ID) {    // Give node the function name if it exists
     node->name = parser->token->value;
@@ -124,7 +327,7 @@ AST* parser_function(parser_T* parser) {
 
   // If function already exists, raise an error since we cannot have two functions with the same name
   if (table_search_entry(parser->table, node->name)) {
-    printf("[Error in line %zu]: Function redecleration", parser->lexer->lineIndex); exit(1);
+    printf("[Error in line %zu]: Function redecleration", parser_line(parser)); error_exit();
   }
 
   table_add_entry(parser->table, node->name, node->var_type);    // Add function to the symbol table
@@ -135,22 +338,17 @@ AST* parser_function(parser_T* parser) {
   // Parse function arguments
   while (parser->token->type != TOKEN_RPAREN) {
 
-    node->function_def_args = mrealloc(node->function_def_args, sizeof(AST*) * ++counter);
-    node->function_def_args[counter - 1] = parser_var_dec(parser);
+    vector_push(node->function_def_args, node->size, node->capacity, parser_var_dec(parser));
 
     if (parser->token->type != TOKEN_RPAREN) {
       parser->token = parser_expect(parser, TOKEN_COMMA);
     }  
   }
 
-  node->size = counter;
+  vector_shrink(node->function_def_args, node->size, node->capacity);
 
   parser->token = parser_expect(parser, TOKEN_RPAREN);
 
-  node->function_body = parser_block(parser);    // Start parsing the function block
-
-  parser->table = parser->table->prev;      // When done, go back to the root symbol table
-
   return node;
 }
 
@@ -162,17 +360,15 @@ Output: Compound node
 AST* parser_block(parser_T* parser) {
 
   AST* node = init_AST(AST_COMPOUND);
-  size_t counter = 0;
 
   parser->token = parser_expect(parser, TOKEN_LBRACE);
   
   // While block isn't done, parse statements
   while (parser->token->type != TOKEN_RBRACE) {
-    node->children = mrealloc(node->children, sizeof(AST*) * ++counter);
-    node->children[counter - 1] = parser_statement(parser);
+    vector_push(node->children, node->size, node->capacity, parser_statement(parser));
   }
 
-  node->size = counter;
+  vector_shrink(node->children, node->size, node->capacity);
 
   parser->token = parser_expect(parser, TOKEN_RBRACE);
 
@@ -199,13 +395,15 @@ AST* parser_statement(parser_T* parser) {
   int type = 0;
 
   // Checking all possible statement options
-  if (parser->token->type == TOKEN_ID) {
+  if (parser->token->type == TOKEN_KEYWORD) {
 
     // For reserved keywords
-    if (node = parser_parse_id_reserved_statement(parser, parser_check_reserved(parser))) {
-      return node;
+    if (!(node = parser_parse_id_reserved_statement(parser, parser->token->keyword))) {
+      printf("[Error in line %zu]: Invalid syntax", parser_line(parser)); error_exit();
     }
-    
+  }
+  else if (parser->token->type == TOKEN_ID) {
+
     // Variable assignment
     if (lexer_token_peek(parser->lexer, 1)->type == TOKEN_EQUALS) {
       node = parser_assignment(parser);
@@ -236,7 +434,7 @@ AST* parser_statement(parser_T* parser) {
     node = parser_asm(parser);
   }
   else {
-    printf("[Error in line %zu]: Invalid syntax", parser->lexer->lineIndex); exit(1);
+    printf("[Error in line %zu]: Invalid syntax", parser_line(parser)); error_exit();
   }
 
   return node;
@@ -341,33 +539,43 @@ Output: Function call node
 */
 AST* parser_func_call(parser_T* parser) {
 
-  AST* node = init_AST(AST_FUNC_CALL);
-  size_t counter = 0;
-
-  node->name = parser->token->value;    // Save function name
-  
-  parser_check_current_scope(parser, node->name, "Function");  // Check if the function was declared in the scope
-
-  parser->token = parser_expect(parser, TOKEN_ID);
-  parser->token = parser_expect(parser, TOKEN_LPAREN);
+  AST* node = parser_call_node(parser);
 
   // Parse the arguments being passed to function
   while (parser->token->type != TOKEN_RPAREN) {
 
-    node->arguments = mrealloc(node->arguments, sizeof(AST*) * ++counter);
-    node->arguments[counter - 1] = parser_expression(parser);
+    vector_push(node->arguments, node->size, node->capacity, parser_expression(parser));
 
     if (parser->token->type != TOKEN_RPAREN) {
       parser->token = parser_expect(parser, TOKEN_COMMA);
     }
   }
 
-  node->size = counter;
+  vector_shrink(node->arguments, node->size, node->capacity);
   parser_expect(parser, TOKEN_RPAREN);
 
   return node;
 }
 
+/*
+parser_call_node makes the node of a function call and skips the function's name and the opening parenthesis, the arguments come after it
+Input: Parser
+Output: Function call node without arguments
+*/
+AST* parser_call_node(parser_T* parser) {
+
+  AST* node = init_AST(AST_FUNC_CALL);
+
+  node->name = parser->token->value;    // Save function name
+  
+  parser_check_current_scope(parser, node->name, "Function");  // Check if the function was declared in the scope
+
+  parser->token = parser_expect(parser, TOKEN_ID);
+  parser->token = parser_expect(parser, TOKEN_LPAREN);
+
+  return node;
+}
+
 /*
 parser_var_dec parses a variable declaration of the form <Type> <ID> '=' <Expression> ';'
 Where when there is no assignment, for ints, it automatically assigns a 0 value
@@ -382,15 +590,15 @@ AST* parser_var_dec(parser_T* parser) {
 
   case INT_T: node->var_type = DATA_INT; break;
   case STRING_T: node->var_type = DATA_STRING; break;
-  default: printf("[Error in line %zu]: Variable declaration missing variable type value", parser->lexer->lineIndex);
-    exit(1);
+  default: printf("[Error in line %zu]: Variable declaration missing variable type value", parser_line(parser));
+    error_exit();
   }
   
-  parser->token = parser_expect(parser, TOKEN_ID);
+  parser->token = parser_expect(parser, TOKEN_KEYWORD);
 
   if (table_search_entry(parser->table, parser->token->value)) {
-    printf("[Error in line %zu]: Variable '%s' contains multiple definitions", parser->lexer->lineIndex, parser->token->value);
-    exit(1);
+    printf("[Error in line %zu]: Variable '%s' contains multiple definitions", parser_line(parser), parser->token->value);
+    error_exit();
   }
 
   node->name = parser->token->value;
@@ -400,85 +608,225 @@ AST* parser_var_dec(parser_T* parser) {
   node->value = parser_assignment(parser);
 
   if (node->var_type == DATA_STRING && node->value->rightChild->type == AST_INT) {
-    printf("[Error in line %zu]: Can't assign integer value to a string", parser->lexer->lineIndex);
-    exit(1);
+    printf("[Error in line %zu]: Can't assign integer value to a string", parser_line(parser));
+    error_exit();
   }
   else if (node->var_type == DATA_INT && node->value->rightChild->type == AST_STRING) {
-    printf("[Error in line %zu]: Can't assign string value to an integer", parser->lexer->lineIndex);
-    exit(1);
+    printf("[Error in line %zu]: Can't assign string value to an integer", parser_line(parser));
+    error_exit();
   }
 
   return node;
 }
 
 /*
-parser_expression parses an expression which can be an addition or substruction of two terms
+parser_expression parses an expression with precedence climbing: operands are pushed to a stack, and every operator waits on
+a stack of it's own until an operator that binds looser than it comes, then it takes it's operands from the top of the stack.
+Parentheses and function calls wait on the operator stack too, so nested expressions and calls don't go deeper into the C stack
 Input: Parser
 Output: AST node
 */
 AST* parser_expression(parser_T* parser) {
 
+  parser_operator* operators = NULL;
+  AST** operands = NULL;
+  const parser_operator* operator = NULL;
+  parser_operator call = { AST_FUNC_CALL, TOKEN_LPAREN, 0 };
   AST* node = NULL;
 
-  // Skip + sign that goes before variables like +5 as it is meaningless
-  if (parser->token->type == TOKEN_ADD) {
-    parser->token = lexer_get_next_token(parser->lexer);
-  }
-    
-  node = parser_term(parser);
+  size_t operatorsSize = 0;
+  size_t operatorsCapacity = 0;
+  size_t operandsSize = 0;
+  size_t operandsCapacity = 0;
+  size_t groups = 0;    // Parentheses and function calls that were opened in the expression and weren't closed yet
+
+  for (;;) {
 
-  while (parser->token->type == TOKEN_ADD || parser->token->type == TOKEN_SUB) {
+    // Unary operators and opening parentheses go before an operand, a + sign before an operand is meaningless so it's skipped
+    while (parser->token->type == TOKEN_LPAREN || parser->token->type == TOKEN_ADD || parserUnaryOperators[parser->token->type].precedence) {
 
-    if (parser->token->type == TOKEN_ADD) {
-      parser->token = lexer_get_next_token(parser->lexer);    // Skip Add/Minus signs
-      node = AST_initChildren(node, parser_term(parser), AST_ADD);
+      if (parser->token->type != TOKEN_ADD) {
+        vector_push(operators, operatorsSize, operatorsCapacity, parser->token->type == TOKEN_LPAREN ? parserParenthesis : parserUnaryOperators[parser->token->type]);
+        operators[operatorsSize - 1].offset = parser->token->offset;
+      }
+
+      groups += parser->token->type == TOKEN_LPAREN;
+      parser->token = lexer_get_next_token(parser->lexer);
     }
-    else if (parser->token->type == TOKEN_SUB) {
-      parser->token = lexer_get_next_token(parser->lexer);    // Skip Add/Minus signs
-      node = AST_initChildren(node, parser_term(parser), AST_SUB);
-    }  
 
-    if (node->rightChild->type == AST_STRING || node->leftChild->type == AST_STRING) {
-      printf("[Error in line %zu]: Cannot use strings in arithmetic operations", parser->lexer->lineIndex);
-      exit(1);
+    // A function call waits on the operator stack while it's arguments are parsed as operands, a call without arguments is an operand right away
+    if (parser->token->type == TOKEN_ID && lexer_token_peek(parser->lexer, 1)->type == TOKEN_LPAREN) {
+
+      call.offset = parser->token->offset;
+      node = call.call = parser_call_node(parser);
+
+      if (parser->token->type != TOKEN_RPAREN) {
+        vector_push(operators, operatorsSize, operatorsCapacity, call);
+        groups++;
+        continue;
+      }
+
+      parser->token = lexer_get_next_token(parser->lexer);
+    }
+    else {
+      node = parser_factor(parser);
     }
+
+    vector_push(operands, operandsSize, operandsCapacity, node);
+
+    // A closing parenthesis that wasn't opened in the expression belongs to whatever the expression is in, like a condition
+    while (parser->token->type == TOKEN_RPAREN && groups) {
+
+      parser_close_group(parser, operators, &operatorsSize, operands, &operandsSize);
+      groups--;
+      parser->token = lexer_get_next_token(parser->lexer);
+    }
+
+    // A comma ends an argument of the innermost call, the next argument is the next operand.
+    // Like closing parentheses, a comma outside of the calls of the expression belongs to whatever the expression is in
+    if (parser->token->type == TOKEN_COMMA && groups) {
+
+      parser_close_group(parser, operators, &operatorsSize, operands, &operandsSize);
+      parser->token = lexer_get_next_token(parser->lexer);
+      continue;
+    }
+
+    // Anything that isn't an operator ends the expression
+    if (!(operator = &parserOperators[parser->token->type])->precedence) {
+      break;
+    }
+
+    // Operators are left associative, so the waiting operators that bind as tight as this one are applied first
+    while (operatorsSize && operators[operatorsSize - 1].precedence >= operator->precedence) {
+      parser_apply_operator(parser, &operators[--operatorsSize], operands, &operandsSize);
+    }
+
+    vector_push(operators, operatorsSize, operatorsCapacity, *operator);
+    operators[operatorsSize - 1].offset = parser->token->offset;
+    parser->token = lexer_get_next_token(parser->lexer);
+  }
+
+  if (groups) {
+    parser_expect(parser, TOKEN_RPAREN);    // Missing a closing parenthesis
   }
 
+  while (operatorsSize) {
+    parser_apply_operator(parser, &operators[--operatorsSize], operands, &operandsSize);
+  }
+
+  node = operands[0];
+
+  mfree(operators);
+  mfree(operands);
+
   return node;
 }
 
 /*
-parser_term parses a term which is a multiplication or division of two factors
-Input: Parser
-Output: AST node
+parser_apply_operator makes the node of an operator with the operands at the top of the operand stack, and puts it instead of them.
+Operators that have no operation of their own are made of other operations: -n is 0 - n, !n is n == 0,
+a && b is (a != 0) & (b != 0) and a || b is (a | b) != 0, so both operands of && and || are always evaluated
+Input: Parser, operator, operand stack, pointer to it's size
+Output: None
 */
-AST* parser_term(parser_T* parser) {
+void parser_apply_operator(parser_T* parser, const parser_operator* operator, AST** operands, size_t* size) {
+
+  AST* node = NULL;
+  AST* right = operands[*size - 1];
+  AST* left = operator->precedence == PARSER_UNARY_PRECEDENCE ? NULL : operands[*size - 2];
 
-  AST* node = parser_factor(parser);
+  // The operator may be applied long after it was read, so the error is at it's own line
+  if (right->type == AST_STRING || (left && left->type == AST_STRING)) {
+    printf("[Error in line %zu]: Cannot use strings in %s operations", lexer_line(parser->lexer, operator->offset),
+      operator->type == AST_ADD || operator->type == AST_SUB ? "arithmetic" : "binary");
+    error_exit();
+  }
 
-  while (parser->token->type == TOKEN_MUL || parser->token->type == TOKEN_DIV) {
+  // Unary operators only have a right operand
+  if (!left) {
+    operands[*size - 1] = operator->token == TOKEN_NOT ? parser_compare_zero(right, TOKEN_DEQUAL) : AST_initChildren(parser_zero(), right, AST_SUB);
+    return;
+  }
 
-    if (parser->token->type == TOKEN_MUL) {  
-      parser->token = lexer_get_next_token(parser->lexer);    // Skip multiplication/division signs
-      node = AST_initChildren(node, parser_factor(parser), AST_MUL);
-    }
-    else if (parser->token->type == TOKEN_DIV) {
-      parser->token = lexer_get_next_token(parser->lexer);    // Skip multiplication/division signs
-      node = AST_initChildren(node, parser_factor(parser), AST_DIV);
-    }
+  switch (operator->token) {
+
+    case TOKEN_LAND: node = AST_initChildren(parser_compare_zero(left, TOKEN_NEQUAL), parser_compare_zero(right, TOKEN_NEQUAL), AST_BAND); break;
+    case TOKEN_LOR: node = parser_compare_zero(AST_initChildren(left, right, AST_BOR), TOKEN_NEQUAL); break;
+
+    default:
+      node = AST_initChildren(left, right, operator->type);
+      node->type_c = operator->type == AST_COMPARE ? operator->token : 0;
+  }
 
-    if (node->rightChild->type == AST_STRING || node->leftChild->type == AST_STRING) {
-      printf("[Error in line %zu]: Cannot use strings in binary operations", parser->lexer->lineIndex);
-      exit(1);
+  operands[--*size - 1] = node;
+}
+
+/*
+parser_close_group applies the operators that wait inside the innermost parenthesis or function call, at a comma or a closing parenthesis.
+The operand they make is an argument of a call, at a closing parenthesis the group is removed from the operator stack and a call becomes an operand
+Input: Parser, operator stack, pointer to it's size, operand stack, pointer to it's size
+Output: None
+*/
+void parser_close_group(parser_T* parser, parser_operator* operators, size_t* operatorsSize, AST** operands, size_t* operandsSize) {
+
+  parser_operator* group = NULL;
+
+  while (operators[*operatorsSize - 1].precedence) {
+    parser_apply_operator(parser, &operators[--*operatorsSize], operands, operandsSize);
+  }
+
+  group = &operators[*operatorsSize - 1];
+
+  // Only the arguments of function calls are separated by commas
+  if (!group->call) {
+
+    if (parser->token->type == TOKEN_COMMA) {
+      parser_expect(parser, TOKEN_RPAREN);
     }
+
+    --*operatorsSize;
+    return;
+  }
+
+  vector_push(group->call->arguments, group->call->size, group->call->capacity, operands[--*operandsSize]);
+
+  if (parser->token->type == TOKEN_RPAREN) {
+
+    // The argument was just taken from the operand stack, so there is room for the call
+    vector_shrink(group->call->arguments, group->call->size, group->call->capacity);
+    operands[(*operandsSize)++] = group->call;
+    --*operatorsSize;
   }
+}
+
+/*
+parser_zero makes a node of the number 0, for operators that are made of other operations
+Input: None
+Output: Int node
+*/
+AST* parser_zero() {
+
+  AST* node = init_AST(AST_INT);
+  node->int_value = "0";
 
   return node;
 }
 
 /*
-parser_factor parses a factor which can be an expression within parenthesis, a number, an identifier or
-a unary operation like -n
+parser_compare_zero compares an expression with 0
+Input: Expression node, comparison operator
+Output: Comparison node
+*/
+AST* parser_compare_zero(AST* node, int type) {
+
+  AST* compare = AST_initChildren(node, parser_zero(), AST_COMPARE);
+  compare->type_c = type;
+
+  return compare;
+}
+
+/*
+parser_factor parses an operand of an expression, which can be a number, an identifier, a function call or a string
 Input: Parser
 Output: AST node
 */
@@ -488,22 +836,13 @@ AST* parser_factor(parser_T* parser) {
 
   switch (parser->token->type) {
 
-    // If '(' was found, parse an expression within the parenthesis
-    case TOKEN_LPAREN:
-      parser->token = lexer_get_next_token(parser->lexer);  // Skip starting parenthesis
-      node = parser_expression(parser);            // Parse expression
-      parser_expect(parser, TOKEN_RPAREN);          // Skip the closing parenthesis
-      break;
-
     // Parse the number or identifier
     case TOKEN_NUMBER: node = parser_int(parser); break;
     case TOKEN_ID: node = parser_id(parser); break;
     case TOKEN_STRING: node = parser_string(parser); break;
-    // Case for unary operators (e.g: -6, -2 etc)
-    case TOKEN_SUB: parser->token = lexer_get_next_token(parser->lexer);  node = AST_initChildren(0, parser_factor(parser), AST_SUB); break;
 
-    default: printf("[Error in line %zu]: Syntax Error! token type: %s was unexpected", parser->lexer->lineIndex, typeToString(parser->token->type));
-      exit(1);
+    default: printf("[Error in line %zu]: Syntax Error! token type: %s was unexpected", parser_line(parser), typeToString(parser->token->type));
+      error_exit();
 
   }
 
@@ -564,39 +903,6 @@ AST* parser_id(parser_T* parser) {
   return node;
 }
 
-/*
-parser_compare_expressions parses two expressions with a comparison operator between them
-Input: Parser
-Output: Comparison node with expression children, note that the comparison type can be no operation
-and then it is just an expression
-*/
-AST* parser_compare_expressions(parser_T* parser) {
-
-  AST* node = init_AST(AST_COMPARE);  // Initialize comparison node
-
-  parser->token = parser_expect(parser, TOKEN_LPAREN);
-
-  node->leftChild = parser_expression(parser);  // Getting first expression
-
-  // Check for comparison operators
-  if (parser_check_comparsion_operators(parser)) {
-    node->type_c = parser->token->type;
-    parser->token = lexer_get_next_token(parser->lexer);
-    node->rightChild = parser_expression(parser);
-  }
-  // If there are no comparison operators, move the left child to the value of the comparison node 
-  // And treat it as a boolean expression
-  else {
-    node->value = node->leftChild;    // If there's one expression we switch it from left child to value field
-    node->leftChild = NULL;
-    node->type_c = TOKEN_NOOP;
-  }
-
-  parser->token = parser_expect(parser, TOKEN_RPAREN);
-
-  return node;
-}
-
 /*
 parser_condition parses an if statement
 Input: Parser
@@ -607,16 +913,19 @@ AST* parser_condition(parser_T* parser) {
   AST* node = init_AST(AST_IF);    // Initialize if node
 
   node->name = parser->token->value;
-  parser->token = parser_expect(parser, TOKEN_ID);  
+  parser->token = parser_expect(parser, TOKEN_KEYWORD);  
 
-  node->condition = parser_compare_expressions(parser);    // Parse the condition
+  // Parse the condition
+  parser->token = parser_expect(parser, TOKEN_LPAREN);
+  node->condition = parser_expression(parser);
+  parser->token = parser_expect(parser, TOKEN_RPAREN);
 
   if (parser->token->type == TOKEN_LBRACE) {
     node->if_body = parser_statement(parser);
   }  
   else {
-    printf("[Error in line %zu]: If statement missing braces", parser->lexer->lineIndex);
-    exit(1);
+    printf("[Error in line %zu]: If statement missing braces", parser_line(parser));
+    error_exit();
   }
     
   // If there's an else statement after the if, parse it as well
@@ -627,8 +936,8 @@ AST* parser_condition(parser_T* parser) {
       node->else_body = parser_statement(parser);
     }  
     else {
-      printf("[Error in line %zu]: Else statement missing braces", parser->lexer->lineIndex);
-      exit(1);
+      printf("[Error in line %zu]: Else statement missing braces", parser_line(parser));
+      error_exit();
     }  
   }
 
@@ -646,14 +955,16 @@ AST* parser_while(parser_T* parser) {
 
   parser->token = lexer_get_next_token(parser->lexer);
 
-  node->condition = parser_compare_expressions(parser);
+  parser->token = parser_expect(parser, TOKEN_LPAREN);
+  node->condition = parser_expression(parser);
+  parser->token = parser_expect(parser, TOKEN_RPAREN);
 
   if (parser->token->type == TOKEN_LBRACE) {
     node->if_body = parser_statement(parser);
   }  
   else {
-    printf("[Error in line %zu]: While statement missing braces", parser->lexer->lineIndex);
-    exit(1);
+    printf("[Error in line %zu]: While statement missing braces", parser_line(parser));
+    error_exit();
   }
   
   return node;
@@ -668,25 +979,12 @@ AST* parser_return(parser_T* parser) {
 
   AST* node = init_AST(AST_RETURN);  // Initialize return node
 
-  parser->token = parser_expect(parser, TOKEN_ID);
+  parser->token = parser_expect(parser, TOKEN_KEYWORD);
   node->value = parser_expression(parser);  // Parse the return expression
 
   return node;
 }
 
-/*
-parser_check_comparsion_operators returns true if the current token is a comparsion
-operator, otherwise it returns false
-
-Input: Parser
-Output: True if current token is a comparsion operator, otherwise false
-*/
-bool parser_check_comparsion_operators(parser_T* parser) {
-
-  return parser->token->type == TOKEN_MORE || parser->token->type == TOKEN_EMORE || parser->token->type == TOKEN_LESS
-    || parser->token->type == TOKEN_ELESS || parser->token->type == TOKEN_DEQUAL || parser->token->type == TOKEN_NEQUAL;
-}
-
 /*
 parser_check_current_scope checks and exists if a variable or a function doesn't exist in the current scope
 Input: Parser, name of identifier to check, type of identifier
@@ -695,48 +993,26 @@ Output: None
 void parser_check_current_scope(parser_T* parser, char* name, char* type) {
 
   if (!table_search_entry(parser->table, name)) {
-    printf("[Error in line %zu]: %s '%s' was not declared in the current scope\n", parser->lexer->lineIndex, type, name);
-    exit(1);
+    printf("[Error in line %zu]: %s '%s' was not declared in the current scope\n", parser_line(parser), type, name);
+    error_exit();
   }
 }
 
 
 /*
-reserved_to_string takes a reserved type and returns it's meaning in a string form
-Input: Type of reserved value
-Input: Value of reserved value
+parser_check_reserved checks if the current token is a reserved keyword
+Input: Parser
+Output: Type of reserved keyword, -1 if it is not reserved
 */
-char* reserved_to_string(int type) {
-
-  switch (type) {
-
-  case OUT_T:    return "print";
-  case IF_T:    return "if";
-  case ELSE_T:  return "else";
-  case WHILE_T:  return "while";
-  case INT_T:    return "int";
-  case STRING_T:  return "string";
-  case RETURN_T:  return "return";
-
-  default:    return NULL;
-
-  }
+int parser_check_reserved(parser_T* parser) {
+  return parser->token->type == TOKEN_KEYWORD ? parser->token->keyword : -1;
 }
 
 /*
-parser_check_reserved checks if an ID token is a reserved keyword
+parser_line finds the line of the current token, for errors
 Input: Parser
-Output: Type of reserved keyword, -1 if it is not reserved
+Output: Line of the current token
 */
-int parser_check_reserved(parser_T* parser) {
-
-  int type = -1;
-
-  for (unsigned int i = 0; i < RESERVED_SIZE && parser->token->type == TOKEN_ID; i++) {
-    if (!strcmp(parser->token->value, parser->reserved[i])) {
-      type = i; break;
-    }
-  }
-  
-  return type;
+size_t parser_line(parser_T* parser) {
+  return lexer_line(parser->lexer, parser->token->offset);
 }
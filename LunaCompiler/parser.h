@@ -1,8 +1,7 @@
 #ifndef PARSER_H
 #define PARSER_H
 #include "lexer.h"
-
-#define RESERVED_SIZE 7
+#include "threadPool.h"
 
 typedef struct PARSER_STRUCT {
 
@@ -10,42 +9,65 @@ typedef struct PARSER_STRUCT {
   token_T* token;
   table_T* table;
 
-  char** reserved;
+  struct PARSER_CHUNK_STRUCT* chunks;    // Top level statements that were parsed on their own, NULL when the file was parsed in one go
+  size_t chunksSize;
 
-  enum KEYWORD_ENUM {
+} parser_T;
 
-    OUT_T,
-    IF_T,
-    ELSE_T,
-    WHILE_T,
-    INT_T,
-    STRING_T,
-    RETURN_T,
+/* A top level statement that is parsed by a parser of it's own, function bodies are parsed in parallel */
+typedef struct PARSER_CHUNK_STRUCT {
 
-  } reserved_T;
+  char* contents;       // Copy of the statement's source code
+  parser_T* parser;
+  AST* node;
 
-} parser_T;
+  table_T* table;       // Scope of the function
+  table_T globals;      // The global scope as the function sees it, only the symbols that were declared before it
+
+  size_t start;         // Place of the statement in the source code
+  size_t length;
+  size_t body;          // Offset of the function's body in the statement
+  size_t headerTokens;  // Amount of tokens that were lexed before the body, the body can be lexed again after them
+
+} parser_chunk;
+
+#define PARSER_UNARY_PRECEDENCE 100    // Unary operators bind tighter than any binary operator
+
+/* An operator of an expression, the type of the node it makes and how tight it binds */
+typedef struct PARSER_OPERATOR_STRUCT {
+
+  int type;
+  int token;                 // The token it's written with, comparisons keep it as the type of the condition
+  unsigned int precedence;   // 0 for parentheses and function calls, they wait on the operator stack until they are closed
+  size_t offset;             // Where it is in the source code, given when it's pushed to the operator stack
+  AST* call;                 // The function call whose arguments are parsed, NULL for anything that isn't a call
+
+} parser_operator;
 
 parser_T* init_parser(lexer_T* lexer);
+parser_T* init_chunk_parser(parser_T* parser, parser_chunk* chunk, lexer_chunk* statement);
 
 token_T* parser_expect(parser_T* parser, int type);
 
 AST* parser_lib(parser_T* parser);
 AST* parser_parse(parser_T* parser);
+AST* parser_lib_parallel(parser_T* parser, size_t minFunctions);
 AST* parser_function(parser_T* parser);
+AST* parser_function_header(parser_T* parser);
 AST* parser_block(parser_T* parser);
 AST* pasrer_asm(parser_T* parser);
 AST* parser_var_dec(parser_T* parser);
 AST* parser_statement(parser_T* parser);
 AST* parser_assignment(parser_T* parser);
 AST* parser_func_call(parser_T* parser);
+AST* parser_call_node(parser_T* parser);
 AST* parser_expression(parser_T* parser);
-AST* parser_term(parser_T* parser);
 AST* parser_factor(parser_T* parser);
 AST* parser_int(parser_T* parser);
 AST* parser_string(parser_T* parser);
 AST* parser_id(parser_T* parser);
-AST* parser_compare_expressions(parser_T* parser);
+AST* parser_zero();
+AST* parser_compare_zero(AST* node, int type);
 AST* parser_condition(parser_T* parser);
 AST* parser_while(parser_T* parser);
 AST* parser_return(parser_T* parser);
@@ -53,15 +75,19 @@ AST* parser_return(parser_T* parser);
 AST* parser_parse_id_reserved_statement(parser_T* parser, int type);
 AST* parser_parse_data_type(parser_T* parser);
 
+void parser_function_job(void* context, size_t index, unsigned int worker);
+void parser_add_global(parser_T* parser, AST* root, AST* node);
+void parser_apply_operator(parser_T* parser, const parser_operator* operator, AST** operands, size_t* size);
+void parser_close_group(parser_T* parser, parser_operator* operators, size_t* operatorsSize, AST** operands, size_t* operandsSize);
+void parser_free_chunks(parser_T* parser);
 void parser_expect_semi(parser_T* parser, AST* node);
 void parser_skip_code(parser_T* parser, AST* node);
 void parser_check_current_scope(parser_T* parser, char* name, char* type);
 
-bool parser_check_comparsion_operators(parser_T* parser);
-
-char* reserved_to_string(int type);
 
 int parser_check_reserved(parser_T* parser);
 
+size_t parser_line(parser_T* parser);
+
 #endif
  
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "runtime64.h"
+
+/*
+runtime64_build adds the tiny Linux runtime that Luna programs need: an entry point and the print functions
+The runtime only uses system calls so the output can be linked without any library
+Input: Program to add the runtime to
+Output: None
+*/
+void runtime64_build(x64_program* program) {
+
+  runtime64_build_entry(program);
+  runtime64_build_print_int(program);
+  runtime64_build_print_string(program);
+}
+
+/*
+runtime64_build_entry builds the process entry point, which calls main and exits with it's return value
+Input: Program
+Output: None
+*/
+void runtime64_build_entry(x64_program* program) {
+
+  x64_define_label(program, x64_symbol(program, RUNTIME_ENTRY, X64_TEXT));
+
+  x64_push(program, X64_CALL, x64_label_operand(x64_symbol(program, "main", X64_TEXT)), x64_none());
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RDI), x64_reg_operand(X64_RAX));
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RAX), x64_imm(LINUX_SYS_EXIT));
+  x64_push(program, X64_SYSCALL, x64_none(), x64_none());
+}
+
+/*
+runtime64_build_print_int builds a function that prints the signed number in RDI
+The digits are written backwards into a buffer on the stack and then written in one system call
+Input: Program
+Output: None
+*/
+void runtime64_build_print_int(x64_program* program) {
+
+  int loop = x64_new_label(program, X64_TEXT);
+  int positive = x64_new_label(program, X64_TEXT);
+  int write = x64_new_label(program, X64_TEXT);
+
+  x64_define_label(program, x64_symbol(program, RUNTIME_PRINT_INT, X64_TEXT));
+
+  x64_push(program, X64_PUSH, x64_reg_operand(X64_RBP), x64_none());
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RBP), x64_reg_operand(X64_RSP));
+  x64_push(program, X64_SUB, x64_reg_operand(X64_RSP), x64_imm(PRINT_BUFFER_SIZE));
+
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RAX), x64_reg_operand(X64_RDI));
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RSI), x64_reg_operand(X64_RBP));    // RSI walks backwards from the end of the buffer
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RCX), x64_imm(10));
+
+  // Work on the absolute value, the sign is added after the digits
+  x64_push(program, X64_CMP, x64_reg_operand(X64_RAX), x64_imm(0));
+  x64_push_jcc(program, X64_COND_GE, positive);
+  x64_push(program, X64_NEG, x64_reg_operand(X64_RAX), x64_none());
+  x64_define_label(program, positive);
+
+  x64_define_label(program, loop);
+  x64_push(program, X64_SUB, x64_reg_operand(X64_RSI), x64_imm(1));
+  x64_push(program, X64_CQO, x64_none(), x64_none());
+  x64_push(program, X64_IDIV, x64_reg_operand(X64_RCX), x64_none());
+  x64_push(program, X64_ADD, x64_reg_operand(X64_RDX), x64_imm('0'));
+  x64_push(program, X64_MOVB, x64_mem(X64_RSI, 0), x64_reg_operand(X64_RDX));
+  x64_push(program, X64_TEST, x64_reg_operand(X64_RAX), x64_reg_operand(X64_RAX));
+  x64_push_jcc(program, X64_COND_NE, loop);
+
+  x64_push(program, X64_CMP, x64_reg_operand(X64_RDI), x64_imm(0));
+  x64_push_jcc(program, X64_COND_GE, write);
+  x64_push(program, X64_SUB, x64_reg_operand(X64_RSI), x64_imm(1));
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RDX), x64_imm('-'));
+  x64_push(program, X64_MOVB, x64_mem(X64_RSI, 0), x64_reg_operand(X64_RDX));
+
+  // write(1, RSI, RBP - RSI)
+  x64_define_label(program, write);
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RDX), x64_reg_operand(X64_RBP));
+  x64_push(program, X64_SUB, x64_reg_operand(X64_RDX), x64_reg_operand(X64_RSI));
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RDI), x64_imm(1));
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RAX), x64_imm(LINUX_SYS_WRITE));
+  x64_push(program, X64_SYSCALL, x64_none(), x64_none());
+
+  x64_push(program, X64_LEAVE, x64_none(), x64_none());
+  x64_push(program, X64_RET, x64_none(), x64_none());
+}
+
+/*
+runtime64_build_print_string builds a function that prints the zero terminated string RDI points to
+Input: Program
+Output: None
+*/
+void runtime64_build_print_string(x64_program* program) {
+
+  int loop = x64_new_label(program, X64_TEXT);
+  int done = x64_new_label(program, X64_TEXT);
+
+  x64_define_label(program, x64_symbol(program, RUNTIME_PRINT_STRING, X64_TEXT));
+
+  // Find the end of the string
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RSI), x64_reg_operand(X64_RDI));
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RCX), x64_reg_operand(X64_RDI));
+
+  x64_define_label(program, loop);
+  x64_push(program, X64_MOVZXB, x64_reg_operand(X64_RAX), x64_mem(X64_RCX, 0));
+  x64_push(program, X64_TEST, x64_reg_operand(X64_RAX), x64_reg_operand(X64_RAX));
+  x64_push_jcc(program, X64_COND_E, done);
+  x64_push(program, X64_ADD, x64_reg_operand(X64_RCX), x64_imm(1));
+  x64_push(program, X64_JMP, x64_label_operand(loop), x64_none());
+
+  // write(1, RSI, RCX - RSI)
+  x64_define_label(program, done);
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RDX), x64_reg_operand(X64_RCX));
+  x64_push(program, X64_SUB, x64_reg_operand(X64_RDX), x64_reg_operand(X64_RSI));
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RDI), x64_imm(1));
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RAX), x64_imm(LINUX_SYS_WRITE));
+  x64_push(program, X64_SYSCALL, x64_none(), x64_none());
+
+  x64_push(program, X64_RET, x64_none(), x64_none());
+}
+
+/*
+runtime64_build_native builds a function that jumps to a native function of the compiler,
+used when the program runs inside the compiler's process
+Input: Program, name of the function, address of the native function
+Output: None
+*/
+void runtime64_build_native(x64_program* program, char* name, void* address) {
+
+  x64_define_label(program, x64_symbol(program, name, X64_TEXT));
+
+  // The arguments are still in place, so the native function gets them as they are and returns straight to the caller
+  x64_push(program, X64_MOV, x64_reg_operand(X64_RAX), x64_imm((long long)(uintptr_t)address));
+  x64_push(program, X64_JMP, x64_reg_operand(X64_RAX), x64_none());
+}
@@ -0,0 +1,19 @@
+#ifndef RUNTIME64_H
+#define RUNTIME64_H
+#include "x64.h"
+
+#define RUNTIME_PRINT_INT "luna_print_int"
+#define RUNTIME_PRINT_STRING "luna_print_string"
+#define RUNTIME_ENTRY "_start"
+
+#define LINUX_SYS_WRITE 1
+#define LINUX_SYS_EXIT 60
+#define PRINT_BUFFER_SIZE 32
+
+void runtime64_build(x64_program* program);
+void runtime64_build_entry(x64_program* program);
+void runtime64_build_print_int(x64_program* program);
+void runtime64_build_print_string(x64_program* program);
+void runtime64_build_native(x64_program* program, char* name, void* address);
+
+#endif
@@ -0,0 +1,186 @@
+# Runtime benchmark: compiles the Luna kernels in the kernels directory and times the programs, to see whether a backend
+# change makes Luna programs faster. Every kernel runs in the bytecode VM, which counts the instructions it ran with -stats,
+# and as a Linux executable (-elf), which is counted by perf when it is installed. The outputs of the two have to match.
+# Run it with the compiler that was built: python runtimeBenchmark.py --compiler ./LunaCompiler
+
+import argparse
+import glob
+import json
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+from benchmark import commit, load_previous
+
+# perf events of the executables, the generic cache events are the closest thing to loads and stores every processor has
+PERF_EVENTS = ["instructions:u", "L1-dcache-loads:u", "L1-dcache-stores:u"]
+
+
+def compile_kernel(compiler, path, backend):
+    """Compiles a kernel on it's own in batch mode, returns the -stats report and what the program printed"""
+
+    process = subprocess.run([compiler, "-j", "1", path, backend, "-stats=json"], stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    lines = [line for line in process.stderr.decode("utf-8", "replace").splitlines() if line.startswith("{")]
+
+    if process.returncode or not lines:
+        raise SystemExit("%s didn't compile:\n%s%s" % (path, process.stdout.decode("utf-8", "replace"), process.stderr.decode("utf-8", "replace")))
+
+    return json.loads(lines[-1]), process.stdout
+
+
+def run_vm(compiler, path, runs):
+    """Runs a kernel in the VM a few times, the time of the run phase doesn't include compiling it"""
+
+    best = None
+
+    for _ in range(runs):
+        report, output = compile_kernel(compiler, path, "-vm")
+        milliseconds = report["phases"]["run"]["wall_ms"]
+        best = milliseconds if best is None else min(best, milliseconds)
+
+    counters = report["counters"]
+
+    return {"ms": best, "instructions": counters["vm_instructions"], "loads": counters["vm_loads"], "stores": counters["vm_stores"],
+            "moves": counters["vm_moves"], "branches": counters["vm_branches"], "calls": counters["vm_calls"]}, output
+
+
+def perf_counts(executable):
+    """Counts the instructions, loads and stores of one run of an executable with perf, None for the ones it couldn't count"""
+
+    counts = [None] * len(PERF_EVENTS)
+
+    if not shutil.which("perf"):
+        return counts
+
+    process = subprocess.run(["perf", "stat", "-x", ",", "-e", ",".join(PERF_EVENTS), executable], stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+
+    for line in process.stderr.decode("utf-8", "replace").splitlines():
+        fields = line.split(",")
+
+        if len(fields) > 2 and fields[2] in PERF_EVENTS and fields[0].isdigit():
+            counts[PERF_EVENTS.index(fields[2])] = int(fields[0])
+
+    return counts
+
+
+def run_native(compiler, path, runs):
+    """Compiles a kernel to an executable and runs it a few times, the spills are the ones the backend made in it's code"""
+
+    report, _ = compile_kernel(compiler, path, "-elf")
+    executable = os.path.splitext(path)[0]
+    best = None
+
+    for _ in range(runs):
+        start = time.perf_counter()
+        output = subprocess.run([executable], stdout=subprocess.PIPE).stdout
+        milliseconds = (time.perf_counter() - start) * 1000
+        best = milliseconds if best is None else min(best, milliseconds)
+
+    instructions, loads, stores = perf_counts(executable)
+
+    return {"ms": best, "instructions": instructions, "loads": loads, "stores": stores, "spills": report["counters"]["spills"]}, output
+
+
+def number(value):
+    return "-" if value is None else "{:,}".format(value)
+
+
+def report(results, previous, threshold):
+    """Prints the VM and the native numbers of every kernel, and how their times changed since the previous run"""
+
+    print("%-12s %9s %15s %13s %13s %9s %15s %15s %15s %7s %9s" % ("Kernel", "VM ms", "VM instructions", "VM loads", "VM stores",
+          "Native ms", "Instructions", "Loads", "Stores", "Spills", "Change"))
+
+    regressions = []
+
+    for name, result in results.items():
+        vm = result["vm"]
+        native = result.get("native") or {"ms": None, "instructions": None, "loads": None, "stores": None, "spills": None}
+        change = ""
+
+        if previous and name in previous["kernels"]:
+            before = previous["kernels"][name]
+            percents = [(result[target]["ms"] - before[target]["ms"]) / before[target]["ms"] * 100
+                        for target in ("vm", "native") if result.get(target) and before.get(target) and before[target]["ms"]]
+
+            if percents:
+                change = "%+.1f%%" % max(percents)
+
+                if max(percents) > threshold:
+                    regressions.append("%s is %.1f%% slower" % (name, max(percents)))
+
+        print("%-12s %9.2f %15s %13s %13s %9s %15s %15s %15s %7s %9s" % (name, vm["ms"], number(vm["instructions"]), number(vm["loads"]),
+              number(vm["stores"]), "-" if native["ms"] is None else "%.2f" % native["ms"], number(native["instructions"]),
+              number(native["loads"]), number(native["stores"]), number(native["spills"]), change))
+
+    if previous:
+        print("\nCompared with %s from %s" % (previous["commit"], previous["date"]))
+
+    for regression in regressions:
+        print("Regression: " + regression)
+
+    return regressions
+
+
+def main():
+
+    here = os.path.dirname(os.path.abspath(__file__))
+
+    arguments = argparse.ArgumentParser(description="Times Luna programs that the compiler made, in the VM and as Linux executables")
+    arguments.add_argument("--compiler", default=os.path.join(here, "LunaCompiler.exe" if os.name == "nt" else "LunaCompiler"))
+    arguments.add_argument("--kernels", default=os.path.join(here, "kernels"))
+    arguments.add_argument("--runs", type=int, default=5)
+    arguments.add_argument("--only", help="only run the kernels that have this in their name")
+    arguments.add_argument("--results", default=os.path.join(here, "runtimeResults.jsonl"))
+    arguments.add_argument("--threshold", type=float, default=10, help="percent of slowdown that counts as a regression")
+    arguments.add_argument("--no-save", action="store_true", help="don't append this run to the results file")
+    options = arguments.parse_args()
+
+    # The executables only run on the system the -elf backend writes them for
+    native = sys.platform.startswith("linux") and platform.machine() in ("x86_64", "AMD64")
+    directory = tempfile.mkdtemp(prefix="lunaKernels")
+    results = {}
+    mismatches = []
+
+    for source in sorted(glob.glob(os.path.join(options.kernels, "*.luna"))):
+
+        name = os.path.splitext(os.path.basename(source))[0]
+        if options.only and options.only not in name:
+            continue
+
+        # The compiler writes it's output next to the source code, so the kernels are compiled from a copy
+        path = os.path.join(directory, os.path.basename(source))
+        shutil.copy(source, path)
+
+        results[name] = {}
+        results[name]["vm"], vmOutput = run_vm(options.compiler, path, options.runs)
+
+        if native:
+            results[name]["native"], nativeOutput = run_native(options.compiler, path, options.runs)
+
+            if nativeOutput != vmOutput:
+                mismatches.append(name)
+
+    previous = load_previous(options.results, "kernels", 1)
+    regressions = report(results, previous, options.threshold)
+
+    for name in mismatches:
+        print("Mismatch: %s printed something else in the VM and as an executable" % name)
+
+    if not options.no_save:
+        record = {"commit": commit(), "date": time.strftime("%Y-%m-%d %H:%M:%S"), "backend": "kernels", "scale": 1, "kernels": results}
+
+        with open(options.results, "a", encoding="utf-8") as file:
+            file.write(json.dumps(record) + "\n")
+
+    shutil.rmtree(directory, ignore_errors=True)
+
+    sys.exit(1 if regressions or mismatches else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,366 @@
+#include "scan.h"
+
+#ifdef SCAN_X86
+#include <immintrin.h>
+#endif
+
+// The scalar scanners work everywhere, scan_init replaces them with faster ones when the processor has them
+scan_functions scanner = { scan_whitespace_scalar, scan_line_scalar, scan_identifier_scalar, scan_newlines_scalar };
+
+/*
+scan_init picks the scanners of the best instruction set the processor has, it is called once before anything is lexed
+Input: None
+Output: None
+*/
+void scan_init() {
+
+  switch (scan_best_isa()) {
+
+#ifdef SCAN_X86
+  case SCAN_AVX2:
+    scanner.whitespace = scan_whitespace_avx2;
+    scanner.line = scan_line_avx2;
+    scanner.identifier = scan_identifier_avx2;
+    scanner.newlines = scan_newlines_avx2;
+    break;
+
+  case SCAN_SSE2:
+    scanner.whitespace = scan_whitespace_sse2;
+    scanner.line = scan_line_sse2;
+    scanner.identifier = scan_identifier_sse2;
+    scanner.newlines = scan_newlines_sse2;
+    break;
+#endif
+
+  default: break;
+  }
+}
+
+/*
+scan_best_isa asks the processor which instruction sets it has
+Input: None
+Output: Best instruction set the scanners can use
+*/
+scan_isa scan_best_isa() {
+
+#if defined(SCAN_X86) && defined(_MSC_VER)
+  int info[4] = { 0 };
+  int leaves = 0;
+
+  __cpuid(info, 0);
+  leaves = info[0];
+
+  __cpuid(info, 1);
+
+  // AVX2 also needs the operating system to save the vector registers (OSXSAVE and AVX, then XCR0)
+  if (leaves >= 7 && (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6) {
+
+    int extended[4] = { 0 };
+    __cpuidex(extended, 7, 0);
+
+    if (extended[1] & (1 << 5)) { return SCAN_AVX2; }
+  }
+
+  if (info[3] & (1 << 26)) { return SCAN_SSE2; }
+
+#elif defined(SCAN_X86)
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2")) { return SCAN_AVX2; }
+  if (__builtin_cpu_supports("sse2")) { return SCAN_SSE2; }
+#endif
+
+  return SCAN_SCALAR;
+}
+
+/*
+scan_whitespace_scalar counts the spaces, tabs and newlines at the start of the text
+Input: Text
+Output: Amount of bytes of whitespace
+*/
+size_t scan_whitespace_scalar(const char* text) {
+
+  size_t size = 0;
+
+  while (text[size] == ' ' || text[size] == '\n' || text[size] == '\t') {
+    size++;
+  }
+
+  return size;
+}
+
+/*
+scan_line_scalar counts the bytes until the end of the line
+Input: Text
+Output: Amount of bytes before the newline or the end of the source code
+*/
+size_t scan_line_scalar(const char* text) {
+
+  size_t size = 0;
+
+  while (text[size] && text[size] != '\n') {
+    size++;
+  }
+
+  return size;
+}
+
+/*
+scan_identifier_scalar counts the English letters, digits and underscores at the start of the text
+Input: Text
+Output: Amount of bytes of the identifier
+*/
+size_t scan_identifier_scalar(const char* text) {
+
+  size_t size = 0;
+
+  while ((text[size] >= 'a' && text[size] <= 'z') || (text[size] >= 'A' && text[size] <= 'Z')
+    || (text[size] >= '0' && text[size] <= '9') || text[size] == '_') {
+    size++;
+  }
+
+  return size;
+}
+
+/*
+scan_newlines_scalar finds the newlines of the text
+Input: Text, amount of bytes, array to store the offsets of the newlines in, NULL to only count them
+Output: Amount of newlines
+*/
+size_t scan_newlines_scalar(const char* text, size_t size, size_t* offsets) {
+  return scan_newlines_tail(text, 0, size, offsets);
+}
+
+/*
+scan_newlines_tail finds the newlines of a part of the text one byte at a time
+Input: Text, offset the part starts at, offset it ends at, array to store the offsets of the newlines in, NULL to only count them
+Output: Amount of newlines
+*/
+size_t scan_newlines_tail(const char* text, size_t start, size_t end, size_t* offsets) {
+
+  size_t count = 0;
+
+  for (size_t i = start; i < end; i++) {
+
+    if (text[i] == '\n') {
+      if (offsets) { offsets[count] = i; }
+      count++;
+    }
+  }
+
+  return count;
+}
+
+#ifdef SCAN_X86
+
+/*
+The vector scanners start from the aligned block the text is in, the bytes of the block that come before the text are
+marked as part of the run, then every block makes a mask with a bit for every byte and the run ends at the first byte that isn't in it.
+A byte x is in the range [low, low + count) if x + (0x80 - low) is smaller than -0x80 + count as a signed byte, since SSE2 only compares signed bytes
+*/
+#define SCAN_RANGE_128(bytes, low, count) _mm_cmpgt_epi8(_mm_set1_epi8((char)(-0x80 + (count))), _mm_add_epi8((bytes), _mm_set1_epi8((char)(0x80 - (low)))))
+#define SCAN_RANGE_256(bytes, low, count) _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(-0x80 + (count))), _mm256_add_epi8((bytes), _mm256_set1_epi8((char)(0x80 - (low)))))
+
+/*
+scan_whitespace_sse2 counts the spaces, tabs and newlines at the start of the text, 16 bytes at a time
+Input: Text
+Output: Amount of bytes of whitespace
+*/
+SCAN_TARGET("sse2") size_t scan_whitespace_sse2(const char* text) {
+
+  const char* block = (const char*)((uintptr_t)text & ~(uintptr_t)15);
+  uint32_t before = (1u << (text - block)) - 1;
+  uint32_t end = 0;
+
+  for (;; block += 16, before = 0) {
+
+    __m128i bytes = _mm_load_si128((const __m128i*)block);
+
+    end = ~((uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')),
+      _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t'))))) | before) & 0xFFFF;
+
+    if (end) {
+      return block + scan_first_bit(end) - text;
+    }
+  }
+}
+
+/*
+scan_newlines_sse2 finds the newlines of the text 16 bytes at a time, the text doesn't have to end with a 0 so the last bytes are checked one by one
+Input: Text, amount of bytes, array to store the offsets of the newlines in, NULL to only count them
+Output: Amount of newlines
+*/
+SCAN_TARGET("sse2") size_t scan_newlines_sse2(const char* text, size_t size, size_t* offsets) {
+
+  size_t count = 0;
+  size_t i = 0;
+  uint32_t mask = 0;
+
+  for (; i + 16 <= size; i += 16) {
+
+    mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(text + i)), _mm_set1_epi8('\n')));
+
+    if (!offsets) {
+      count += scan_popcount(mask);
+      continue;
+    }
+
+    for (; mask; mask &= mask - 1) {
+      offsets[count++] = i + scan_first_bit(mask);
+    }
+  }
+
+  return count + scan_newlines_tail(text, i, size, offsets ? offsets + count : NULL);
+}
+
+/*
+scan_line_sse2 counts the bytes until the end of the line, 16 bytes at a time
+Input: Text
+Output: Amount of bytes before the newline or the end of the source code
+*/
+SCAN_TARGET("sse2") size_t scan_line_sse2(const char* text) {
+
+  const char* block = (const char*)((uintptr_t)text & ~(uintptr_t)15);
+  uint32_t before = (1u << (text - block)) - 1;
+  uint32_t end = 0;
+
+  for (;; block += 16, before = 0) {
+
+    __m128i bytes = _mm_load_si128((const __m128i*)block);
+
+    end = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')),
+      _mm_cmpeq_epi8(bytes, _mm_setzero_si128()))) & ~before;
+
+    if (end) {
+      return block + scan_first_bit(end) - text;
+    }
+  }
+}
+
+/*
+scan_identifier_sse2 counts the English letters, digits and underscores at the start of the text, 16 bytes at a time
+Input: Text
+Output: Amount of bytes of the identifier
+*/
+SCAN_TARGET("sse2") size_t scan_identifier_sse2(const char* text) {
+
+  const char* block = (const char*)((uintptr_t)text & ~(uintptr_t)15);
+  uint32_t before = (1u << (text - block)) - 1;
+  uint32_t end = 0;
+
+  for (;; block += 16, before = 0) {
+
+    __m128i bytes = _mm_load_si128((const __m128i*)block);
+    __m128i letters = SCAN_RANGE_128(_mm_or_si128(bytes, _mm_set1_epi8(0x20)), 'a', 26);    // Lower case of upper case letters
+
+    end = ~((uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letters, SCAN_RANGE_128(bytes, '0', 10)),
+      _mm_cmpeq_epi8(bytes, _mm_set1_epi8('_')))) | before) & 0xFFFF;
+
+    if (end) {
+      return block + scan_first_bit(end) - text;
+    }
+  }
+}
+
+/*
+scan_whitespace_avx2 counts the spaces, tabs and newlines at the start of the text, 32 bytes at a time
+Input: Text
+Output: Amount of bytes of whitespace
+*/
+SCAN_TARGET("avx2") size_t scan_whitespace_avx2(const char* text) {
+
+  const char* block = (const char*)((uintptr_t)text & ~(uintptr_t)31);
+  uint32_t before = (uint32_t)((1ull << (text - block)) - 1);
+  uint32_t end = 0;
+
+  for (;; block += 32, before = 0) {
+
+    __m256i bytes = _mm256_load_si256((const __m256i*)block);
+
+    end = ~((uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')),
+      _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\t'))))) | before);
+
+    if (end) {
+      return block + scan_first_bit(end) - text;
+    }
+  }
+}
+
+/*
+scan_newlines_avx2 finds the newlines of the text 32 bytes at a time, the text doesn't have to end with a 0 so the last bytes are checked one by one
+Input: Text, amount of bytes, array to store the offsets of the newlines in, NULL to only count them
+Output: Amount of newlines
+*/
+SCAN_TARGET("avx2") size_t scan_newlines_avx2(const char* text, size_t size, size_t* offsets) {
+
+  size_t count = 0;
+  size_t i = 0;
+  uint32_t mask = 0;
+
+  for (; i + 32 <= size; i += 32) {
+
+    mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(text + i)), _mm256_set1_epi8('\n')));
+
+    if (!offsets) {
+      count += scan_popcount(mask);
+      continue;
+    }
+
+    for (; mask; mask &= mask - 1) {
+      offsets[count++] = i + scan_first_bit(mask);
+    }
+  }
+
+  return count + scan_newlines_tail(text, i, size, offsets ? offsets + count : NULL);
+}
+
+/*
+scan_line_avx2 counts the bytes until the end of the line, 32 bytes at a time
+Input: Text
+Output: Amount of bytes before the newline or the end of the source code
+*/
+SCAN_TARGET("avx2") size_t scan_line_avx2(const char* text) {
+
+  const char* block = (const char*)((uintptr_t)text & ~(uintptr_t)31);
+  uint32_t before = (uint32_t)((1ull << (text - block)) - 1);
+  uint32_t end = 0;
+
+  for (;; block += 32, before = 0) {
+
+    __m256i bytes = _mm256_load_si256((const __m256i*)block);
+
+    end = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')),
+      _mm256_cmpeq_epi8(bytes, _mm256_setzero_si256()))) & ~before;
+
+    if (end) {
+      return block + scan_first_bit(end) - text;
+    }
+  }
+}
+
+/*
+scan_identifier_avx2 counts the English letters, digits and underscores at the start of the text, 32 bytes at a time
+Input: Text
+Output: Amount of bytes of the identifier
+*/
+SCAN_TARGET("avx2") size_t scan_identifier_avx2(const char* text) {
+
+  const char* block = (const char*)((uintptr_t)text & ~(uintptr_t)31);
+  uint32_t before = (uint32_t)((1ull << (text - block)) - 1);
+  uint32_t end = 0;
+
+  for (;; block += 32, before = 0) {
+
+    __m256i bytes = _mm256_load_si256((const __m256i*)block);
+    __m256i letters = SCAN_RANGE_256(_mm256_or_si256(bytes, _mm256_set1_epi8(0x20)), 'a', 26);
+
+    end = ~((uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letters, SCAN_RANGE_256(bytes, '0', 10)),
+      _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('_')))) | before);
+
+    if (end) {
+      return block + scan_first_bit(end) - text;
+    }
+  }
+}
+
+#endif
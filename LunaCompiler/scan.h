@@ -0,0 +1,91 @@
+#ifndef SCAN_H
+#define SCAN_H
+#include "io.h"
+
+// The vector scanners only exist on x86, anything else uses the scalar scanners
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SCAN_X86
+#endif
+
+// The vector scanners load whole aligned blocks, which can read past the end of the text but never past the page it ends in,
+// so the sanitizers are kept out of them or they report the bytes after the text as an overflow
+#if defined(__GNUC__) || defined(__clang__)
+#define SCAN_TARGET(isa) __attribute__((target(isa), no_sanitize_address, no_sanitize_thread))
+#else
+#define SCAN_TARGET(isa)
+#include <intrin.h>
+#endif
+
+/* Instruction sets the scanners can use, the best one the processor has is picked by scan_init */
+typedef enum SCAN_ISA_ENUM {
+
+  SCAN_SCALAR,
+  SCAN_SSE2,
+  SCAN_AVX2,
+
+} scan_isa;
+
+/*
+Scanners the lexer skips runs of characters with, every scanner returns the amount of bytes in the run.
+They stop at the 0 that ends the source code, and the vector scanners only use aligned loads,
+so they never read from a page the source code isn't in
+*/
+typedef struct SCAN_FUNCTIONS_STRUCT {
+
+  size_t (*whitespace)(const char* text);                       // Spaces, tabs and newlines
+  size_t (*line)(const char* text);                             // Everything until a newline or the end of the source code
+  size_t (*identifier)(const char* text);                       // English letters, digits and underscores
+
+  size_t (*newlines)(const char* text, size_t size, size_t* offsets);   // Offsets of the newlines in size bytes, only counted when offsets is NULL
+
+} scan_functions;
+
+extern scan_functions scanner;
+
+void scan_init();
+
+scan_isa scan_best_isa();
+
+size_t scan_whitespace_scalar(const char* text);
+size_t scan_line_scalar(const char* text);
+size_t scan_identifier_scalar(const char* text);
+size_t scan_newlines_scalar(const char* text, size_t size, size_t* offsets);
+size_t scan_newlines_tail(const char* text, size_t start, size_t end, size_t* offsets);
+
+#ifdef SCAN_X86
+size_t scan_whitespace_sse2(const char* text);
+size_t scan_line_sse2(const char* text);
+size_t scan_identifier_sse2(const char* text);
+size_t scan_newlines_sse2(const char* text, size_t size, size_t* offsets);
+
+size_t scan_whitespace_avx2(const char* text);
+size_t scan_line_avx2(const char* text);
+size_t scan_identifier_avx2(const char* text);
+size_t scan_newlines_avx2(const char* text, size_t size, size_t* offsets);
+#endif
+
+/* Amount of set bits, used to count the newlines of a block */
+static inline unsigned int scan_popcount(uint32_t mask) {
+
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned int)__builtin_popcount(mask);
+#else
+  mask = mask - ((mask >> 1) & 0x55555555u);
+  mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+  return (((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+#endif
+}
+
+/* Index of the lowest set bit, the mask can't be 0 */
+static inline unsigned int scan_first_bit(uint32_t mask) {
+
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned int)__builtin_ctz(mask);
+#else
+  unsigned long index = 0;
+  _BitScanForward(&index, mask);
+  return (unsigned int)index;
+#endif
+}
+
+#endif
@@ -0,0 +1,472 @@
+#include "server.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+/*
+server_run runs a compile server until it gets a QUIT request
+Input: Path of the socket to listen on, compile options for every request
+Output: Exit code
+*/
+int server_run(char* socketPath, compile_options* options) {
+
+#ifndef _WIN32
+
+  server_T server = { 0 };
+  struct sockaddr_un address = { 0 };
+  int client = 0;
+  bool running = true;
+
+  if (options->output != OUTPUT_MASM && options->output != OUTPUT_GAS) {
+    printf("[ERROR]: The compile server only makes Assembly code\n"); return 1;
+  }
+
+  if (strlen(socketPath) >= sizeof(address.sun_path)) {
+    printf("[ERROR]: Socket path is too long\n"); return 1;
+  }
+
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, socketPath);
+
+  server.options = options;
+  server.socket = socket(AF_UNIX, SOCK_STREAM, 0);
+
+  unlink(socketPath);
+
+  if (server.socket < 0 || bind(server.socket, (struct sockaddr*)&address, sizeof(address)) || listen(server.socket, SERVER_BACKLOG)) {
+    printf("[ERROR]: Couldn't listen on %s\n", socketPath); return 1;
+  }
+
+  // A client that leaves before it gets it's response shouldn't stop the server
+  signal(SIGPIPE, SIG_IGN);
+
+  while (running) {
+
+    if ((client = accept(server.socket, NULL, NULL)) < 0) { continue; }
+
+    running = server_handle(&server, client);
+    close(client);
+  }
+
+  close(server.socket);
+  unlink(socketPath);
+  server_free(&server);
+
+  return 0;
+
+#else
+
+  printf("[ERROR]: The compile server needs Unix domain sockets\n");
+  return 1;
+
+#endif
+}
+
+#ifndef _WIN32
+
+/*
+server_handle reads a request from a client and answers it
+Input: Server, client socket
+Output: False if the server should stop
+*/
+bool server_handle(server_T* server, int client) {
+
+  char line[SERVER_LINE_SIZE] = { 0 };
+  char* contents = NULL;
+  char* name = NULL;
+  char* end = NULL;
+  FILE* file = NULL;
+  size_t size = 0;
+
+  document_edit edit = { 0 };
+
+  if (!server_read_line(client, line, sizeof(line))) { return true; }
+
+  if (!strcmp(line, "QUIT")) { return false; }
+
+  if (!strncmp(line, "PATH ", strlen("PATH "))) {
+
+    name = line + strlen("PATH ");
+
+    if (!server_check_request(client, name, 0)) { return true; }
+
+    if (!(file = fopen(name, "r")) || !(contents = read_file(file))) {
+      server_respond(client, "ERROR", NULL, 0, "[ERROR]: File does not exist\n", strlen("[ERROR]: File does not exist\n"));
+      return true;
+    }
+  }
+  else if (!strncmp(line, "SOURCE ", strlen("SOURCE "))) {
+
+    size = strtoull(line + strlen("SOURCE "), &end, 10);
+    name = end + (*end == ' ');
+
+    if (!server_check_request(client, name, size)) { return true; }
+
+    contents = mcalloc(size + 1, sizeof(char));
+
+    if (!server_read_all(client, contents, size)) {
+      mfree(contents);
+      return true;
+    }
+  }
+  else if (!strncmp(line, "EDIT ", strlen("EDIT "))) {
+
+    if (!(contents = server_read_edit(server, client, line, &name, &edit))) { return true; }
+
+    server_compile(server, client, name, contents, &edit);
+    mfree(contents);
+
+    return true;
+  }
+  else {
+    server_respond(client, "ERROR", NULL, 0, "[ERROR]: Unknown request\n", strlen("[ERROR]: Unknown request\n"));
+    return true;
+  }
+
+  server_compile(server, client, name, contents, NULL);
+  mfree(contents);
+
+  return true;
+}
+
+/*
+server_check_request checks the name of the file and the amount of bytes a request sends before anything is read or allocated for it,
+the name has to be of a .luna file since the outputs and the caches are named after it
+Input: Client socket, name of the source file, amount of bytes the request sends
+Output: False if the request was answered with an error
+*/
+bool server_check_request(int client, char* name, size_t size) {
+
+  if (strcmp(get_filename_ext(name), "luna")) {
+    server_respond(client, "ERROR", NULL, 0, "[ERROR]: Unrecognized file extention\n", strlen("[ERROR]: Unrecognized file extention\n"));
+    return false;
+  }
+
+  if (size > SERVER_MAX_SOURCE) {
+    server_respond(client, "ERROR", NULL, 0, "[ERROR]: Source code is too big\n", strlen("[ERROR]: Source code is too big\n"));
+    return false;
+  }
+
+  return true;
+}
+
+/*
+server_read_edit reads the rest of an EDIT request and applies the edit to the last source code of the file
+Input: Server, client socket, request line, pointers to store the name of the file and the edit in
+Output: The edited source code, NULL if the request was already answered or the client left
+*/
+char* server_read_edit(server_T* server, int client, char* line, char** name, document_edit* edit) {
+
+  server_entry* entry = NULL;
+  char* contents = NULL;
+  char* end = line + strlen("EDIT ");
+  size_t length = 0;
+
+  edit->offset = strtoull(end, &end, 10);
+  edit->removed = strtoull(end, &end, 10);
+  edit->size = strtoull(end, &end, 10);
+  *name = end + (*end == ' ');
+
+  if (!server_check_request(client, *name, edit->size)) { return NULL; }
+
+  entry = server_find(server, *name);
+  length = entry->contents ? strlen(entry->contents) : 0;
+
+  if (!entry->contents || edit->offset > length || edit->removed > length - edit->offset) {
+    server_respond(client, "ERROR", NULL, 0, "[ERROR]: Edit is outside of the source code\n", strlen("[ERROR]: Edit is outside of the source code\n"));
+    return NULL;
+  }
+
+  // The edit is at most SERVER_MAX_SOURCE bytes, so this can't overflow
+  if (length - edit->removed > SERVER_MAX_SOURCE - edit->size) {
+    server_respond(client, "ERROR", NULL, 0, "[ERROR]: Source code is too big\n", strlen("[ERROR]: Source code is too big\n"));
+    return NULL;
+  }
+
+  contents = mcalloc(length - edit->removed + edit->size + 1, sizeof(char));
+  memcpy(contents, entry->contents, edit->offset);
+
+  if (!server_read_all(client, contents + edit->offset, edit->size)) {
+    mfree(contents);
+    return NULL;
+  }
+
+  memcpy(contents + edit->offset + edit->size, entry->contents + edit->offset + edit->removed, length - edit->offset - edit->removed);
+  edit->inserted = contents + edit->offset;
+
+  return contents;
+}
+
+/*
+server_compile compiles source code in a child process, so an error in the source code only ends the child.
+The output of files that didn't change since their last compilation is sent right away.
+Edits are applied to the parsed document of the file, so only the function they are in is parsed again
+Input: Server, client socket, name of the source file, source code, the edit that made the source code (NULL for whole files)
+Output: None
+*/
+void server_compile(server_T* server, int client, char* name, char* contents, document_edit* edit) {
+
+  server_entry* entry = server_find(server, name);
+  uint64_t hash = hash_bytes(contents, strlen(contents));
+
+  char* filename = NULL;
+  char* output = NULL;
+  char* diagnostics = NULL;
+  FILE* file = NULL;
+  size_t outputSize = 0;
+  size_t diagnosticsSize = 0;
+
+  int pipes[2] = { 0 };
+  int status = 0;
+  pid_t child = 0;
+
+  // A whole file can be anything, so the document is parsed again on the next edit
+  if (!edit && entry->document) {
+    document_free(entry->document);
+    entry->document = NULL;
+  }
+
+  mfree(entry->contents);
+  entry->contents = mcalloc(strlen(contents) + 1, sizeof(char));
+  strcpy(entry->contents, contents);
+
+  if (entry->output && entry->hash == hash) {
+
+    // The source code compiled before, so it parses without errors
+    if (edit) {
+      server_update_document(entry, contents, edit);
+    }
+
+    server_respond(client, "OK", entry->output, entry->size, NULL, 0);
+    return;
+  }
+
+  if (pipe(pipes)) {
+    server_respond(client, "ERROR", NULL, 0, "[ERROR]: Couldn't start a compilation\n", strlen("[ERROR]: Couldn't start a compilation\n"));
+    return;
+  }
+
+  fflush(stdout);
+
+  // Everything the compiler prints goes to the diagnostics of the response
+  if (!(child = fork())) {
+
+    close(pipes[0]);
+    close(client);
+    close(server->socket);
+    dup2(pipes[1], STDOUT_FILENO);
+
+    edit ? compile_document(name, server_update_document(entry, contents, edit), server->options) : compile_source(name, contents, server->options);
+
+    fflush(stdout);
+    _exit(0);
+  }
+
+  close(pipes[1]);
+  diagnostics = server_read_fd(pipes[0], &diagnosticsSize);
+  close(pipes[0]);
+
+  waitpid(child, &status, 0);
+
+  filename = compile_output_filename(name, server->options->output);
+
+  if (child > 0 && WIFEXITED(status) && !WEXITSTATUS(status) && (file = fopen(filename, "rb"))) {
+
+    output = server_read_fd(fileno(file), &outputSize);
+    fclose(file);
+
+    server_respond(client, "OK", output, outputSize, diagnostics, diagnosticsSize);
+
+    // Keep the output for the next time the file is compiled
+    mfree(entry->output);
+    entry->output = output;
+    entry->size = outputSize;
+    entry->hash = hash;
+
+    // The child already parsed the edit without errors, so the server can keep it's own document up to date
+    if (edit) {
+      server_update_document(entry, contents, edit);
+    }
+  }
+  else {
+    server_respond(client, "ERROR", NULL, 0, diagnostics, diagnosticsSize);
+
+    // The document doesn't match the source code anymore, the next edit parses the whole file
+    if (entry->document) {
+      document_free(entry->document);
+      entry->document = NULL;
+    }
+  }
+
+  mfree(diagnostics);
+  mfree(filename);
+}
+
+/*
+server_find finds the entry of a file, adding an empty one if the file wasn't compiled before
+Input: Server, name of the source file
+Output: Entry of the file
+*/
+server_entry* server_find(server_T* server, char* name) {
+
+  for (size_t i = 0; i < server->size; i++) {
+
+    if (!strcmp(server->entries[i].name, name)) {
+      return &server->entries[i];
+    }
+  }
+
+  vector_reserve(server->entries, server->capacity, server->size + 1);
+
+  memset(&server->entries[server->size], 0, sizeof(server_entry));
+  server->entries[server->size].name = mcalloc(strlen(name) + 1, sizeof(char));
+  strcpy(server->entries[server->size].name, name);
+
+  return &server->entries[server->size++];
+}
+
+/*
+server_update_document applies an edit to the parsed document of a file, the first edit parses all of the file
+Input: Entry of the file, source code after the edit, the edit
+Output: Document of the file
+*/
+document_T* server_update_document(server_entry* entry, char* contents, document_edit* edit) {
+
+  if (entry->document) {
+    document_apply(entry->document, edit);
+  }
+  else {
+    entry->document = init_document(contents, strlen(contents));
+  }
+
+  return entry->document;
+}
+
+/*
+server_respond sends a response to a client
+Input: Client socket, status, Assembly code and it's size, diagnostics and their size
+Output: None
+*/
+void server_respond(int client, const char* status, const char* output, size_t outputSize, const char* diagnostics, size_t diagnosticsSize) {
+
+  char header[SERVER_LINE_SIZE] = { 0 };
+  int length = snprintf(header, sizeof(header), "%s %zu %zu\n", status, outputSize, diagnosticsSize);
+
+  // A failed write means the client left, there is nothing else to do with it
+  if (server_write_all(client, header, (size_t)length) && outputSize) {
+    server_write_all(client, output, outputSize);
+  }
+
+  if (diagnosticsSize) {
+    server_write_all(client, diagnostics, diagnosticsSize);
+  }
+}
+
+/*
+server_read_line reads a line from a socket, without the newline
+Input: Socket, buffer, size of buffer
+Output: False if the line didn't fit or the socket closed before the end of the line
+*/
+bool server_read_line(int fd, char* line, size_t size) {
+
+  for (size_t i = 0; i + 1 < size; i++) {
+
+    if (read(fd, &line[i], 1) != 1) { return false; }
+
+    if (line[i] == '\n') {
+      line[i] = '\0';
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*
+server_read_all reads an exact amount of bytes
+Input: File descriptor, buffer, amount of bytes
+Output: False if the file ended before
+*/
+bool server_read_all(int fd, char* buffer, size_t size) {
+
+  ssize_t length = 0;
+
+  for (size_t done = 0; done < size; done += (size_t)length) {
+
+    if ((length = read(fd, buffer + done, size - done)) <= 0) { return false; }
+  }
+
+  return true;
+}
+
+/*
+server_write_all writes an exact amount of bytes
+Input: File descriptor, bytes, amount of bytes
+Output: False if the write failed
+*/
+bool server_write_all(int fd, const char* buffer, size_t size) {
+
+  ssize_t length = 0;
+
+  for (size_t done = 0; done < size; done += (size_t)length) {
+
+    if ((length = write(fd, buffer + done, size - done)) <= 0) { return false; }
+  }
+
+  return true;
+}
+
+/*
+server_read_fd reads everything from a file descriptor until it ends
+Input: File descriptor, pointer to store the amount of bytes in
+Output: The bytes, with a 0 after them
+*/
+char* server_read_fd(int fd, size_t* size) {
+
+  emitter_T* buffer = init_emitter(NULL);
+  char* bytes = NULL;
+  ssize_t length = 0;
+
+  emitter_reserve(buffer, SERVER_READ_SIZE);
+
+  while ((length = read(fd, buffer->buffer + buffer->size, buffer->capacity - buffer->size - 1)) > 0) {
+
+    buffer->size += (size_t)length;
+    emitter_reserve(buffer, SERVER_READ_SIZE);
+  }
+
+  buffer->buffer[buffer->size] = '\0';
+  *size = buffer->size;
+
+  bytes = buffer->buffer;
+  mfree(buffer);
+
+  return bytes;
+}
+
+#endif
+
+/*
+server_free frees the kept outputs of a server
+Input: Server
+Output: None
+*/
+void server_free(server_T* server) {
+
+  for (size_t i = 0; i < server->size; i++) {
+    mfree(server->entries[i].name);
+    mfree(server->entries[i].output);
+    mfree(server->entries[i].contents);
+
+    if (server->entries[i].document) {
+      document_free(server->entries[i].document);
+    }
+  }
+
+  mfree(server->entries);
+}
@@ -0,0 +1,63 @@
+#ifndef SERVER_H
+#define SERVER_H
+#include "compiler.h"
+
+#define SERVER_BACKLOG 16
+#define SERVER_LINE_SIZE 4096
+#define SERVER_READ_SIZE 65536
+#define SERVER_MAX_SOURCE (64 * 1024 * 1024)    // Biggest source code a request can send or make with an edit, in bytes
+
+/*
+A compile server listens on a Unix domain socket and compiles one request per connection
+Requests:  "PATH <path>\n", or "SOURCE <size> <name>\n" followed by <size> bytes of source code, or "QUIT\n",
+or "EDIT <offset> <removed> <size> <name>\n" followed by <size> bytes that replace <removed> bytes of the last source code of the file
+Responses: "OK <output size> <diagnostics size>\n" or "ERROR <output size> <diagnostics size>\n", followed by the
+Assembly code and then everything the compiler printed
+*/
+
+/* Output of the last successful compilation of a file, returned as is while the file doesn't change */
+typedef struct SERVER_ENTRY_STRUCT {
+
+  char* name;
+  uint64_t hash;      // Hash of the source code
+
+  char* output;
+  size_t size;
+
+  char* contents;           // Last source code of the file, edits are applied to it
+  document_T* document;     // The contents parsed, NULL until an edit compiles
+
+} server_entry;
+
+typedef struct SERVER_STRUCT {
+
+  int socket;
+  compile_options* options;
+
+  server_entry* entries;
+  size_t size;
+  size_t capacity;
+
+} server_T;
+
+int server_run(char* socketPath, compile_options* options);
+
+bool server_handle(server_T* server, int client);
+bool server_check_request(int client, char* name, size_t size);
+bool server_read_line(int fd, char* line, size_t size);
+bool server_read_all(int fd, char* buffer, size_t size);
+bool server_write_all(int fd, const char* buffer, size_t size);
+
+void server_compile(server_T* server, int client, char* name, char* contents, document_edit* edit);
+void server_respond(int client, const char* status, const char* output, size_t outputSize, const char* diagnostics, size_t diagnosticsSize);
+void server_free(server_T* server);
+
+server_entry* server_find(server_T* server, char* name);
+
+document_T* server_update_document(server_entry* entry, char* contents, document_edit* edit);
+
+char* server_read_edit(server_T* server, int client, char* line, char** name, document_edit* edit);
+
+char* server_read_fd(int fd, size_t* size);
+
+#endif
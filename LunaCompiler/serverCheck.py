@@ -0,0 +1,187 @@
+# Server check: starts the compile server, sends it generated programs and edits to them, and compares every answer with
+# the output of compiling the same source code directly. The server always goes through the caches and the incremental
+# parser, so this shows when they make different code than a fresh compilation. Linux and other Unix systems only.
+# Run it with the compiler that was built: python serverCheck.py --compiler ./LunaCompiler
+
+import argparse
+import os
+import shutil
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+
+from benchmark import Program
+
+# Output file of the backends the server compiles for, MASM is the backend without a flag
+EXTENSIONS = {"": ".asm", "-x64": ".s"}
+
+
+def request(path, header, body=b""):
+    """Sends one request to the server, returns the status, the code and the diagnostics of the answer"""
+
+    client = socket.socket(socket.AF_UNIX)
+    client.connect(path)
+    client.sendall(header + b"\n" + body)
+
+    answer = b""
+    while True:
+        chunk = client.recv(65536)
+        if not chunk:
+            break
+        answer += chunk
+
+    client.close()
+
+    line, _, rest = answer.partition(b"\n")
+    status, codeSize, diagnosticsSize = line.split()
+
+    return status.decode(), rest[:int(codeSize)], rest[int(codeSize):int(codeSize) + int(diagnosticsSize)]
+
+
+def compile_direct(compiler, path, source, backend):
+    """Compiles the source code on it's own without any cache, like compiling the file from the command line"""
+
+    with open(path, "wb") as file:
+        file.write(source)
+
+    subprocess.run([compiler, "-j", "1", path] + ([backend] if backend else []), stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+    with open(os.path.splitext(path)[0] + EXTENSIONS[backend], "rb") as file:
+        return file.read()
+
+
+def generate(program):
+    """A small program of the benchmark (the MASM backend can't allocate the registers of the bigger shapes) with a global
+    that every function compares it's first argument with, so the code of a function depends on what the backend knows
+    about the global when the function starts"""
+
+    words = program.words
+    limit = program.name("var", 99)
+    functions = words["int"] + " " + program.name("function", 0)[:-1]
+    lines = []
+
+    for line in program.generate(12, 1, 1, 2, 1).splitlines():
+        lines.append(line)
+
+        if line.startswith(functions):
+            lines.append("  %s (%s > %s) {" % (words["if"], program.name("arg", 0), limit))
+            lines.append("    %s = %s;" % (program.name("arg", 1), program.name("arg", 0)))
+            lines.append("  }")
+
+    return ("%s %s = 1;\n" % (words["int"], limit) + "\n".join(lines) + "\n").encode("utf-8")
+
+
+def edits(program, source):
+    """Edits to the source code of a generated program: a constant of the last function that changes, so the functions
+    before it come from the cache, and a branch that is added to the first function and removed again, which adds labels
+    before the code of every other function"""
+
+    words = program.words
+    header = ("%s %s(" % (words["int"], program.name("function", 0))).encode("utf-8")
+    body = source.index(b"\n", source.index(header)) + 1
+    branch = ("  %s (%s > 1) {\n    %s = 2;\n  }\n" % (words["if"], program.name("arg", 0), program.name("arg", 1))).encode("utf-8")
+    constant = source.rindex(b" < 10)")
+
+    # Every edit is an offset, the amount of bytes it removes and the bytes it inserts
+    return [(constant, len(b" < 10)"), b" < 12)"), (body, 0, branch), (body, len(branch), b""), (constant, len(b" < 12)"), b" < 10)")]
+
+
+def check(compiler, server, directory, language, backend):
+    """Compiles a program and the edits to it with the server and directly, returns the steps where the outputs differ"""
+
+    program = Program(language)
+    source = generate(program)
+    name = os.path.join(directory, "server", "%s%s.luna" % (language, backend))
+    direct = os.path.join(directory, "direct", "%s%s.luna" % (language, backend))
+    mismatches = []
+
+    status, code, diagnostics = request(server, b"SOURCE %d %s" % (len(source), name.encode("utf-8")), source)
+
+    if status != "OK" or code != compile_direct(compiler, direct, source, backend):
+        mismatches.append("%s %s: the whole file %s" % (language, backend or "MASM", diagnostics.decode("utf-8", "replace")))
+
+    for step, (offset, removed, inserted) in enumerate(edits(program, source)):
+
+        source = source[:offset] + inserted + source[offset + removed:]
+        status, code, diagnostics = request(server, b"EDIT %d %d %d %s" % (offset, removed, len(inserted), name.encode("utf-8")), inserted)
+
+        if status != "OK" or code != compile_direct(compiler, direct, source, backend):
+            mismatches.append("%s %s: edit %d %s" % (language, backend or "MASM", step + 1, diagnostics.decode("utf-8", "replace")))
+
+    return mismatches
+
+
+def check_requests(server, directory):
+    """Sends requests the server has to refuse without compiling or allocating anything: a name that isn't a .luna file and
+    sizes that are too big. Every one has to be answered with ERROR, and the server has to keep running after them"""
+
+    name = os.path.join(directory, "server", "requests.luna").encode("utf-8")
+    source = b"int main() {\n  return 0;\n}\n"
+    mismatches = []
+
+    # The server answers before it reads the bytes of a request it refuses, so they aren't sent
+    requests = [(b"SOURCE %d noext" % len(source), b"", "ERROR"), (b"SOURCE 100000000000000 " + name, b"", "ERROR"),
+                (b"SOURCE %d " % len(source) + name, source, "OK"), (b"EDIT 0 0 100000000000000 " + name, b"", "ERROR"),
+                (b"EDIT 0 0 1 noext", b"", "ERROR"), (b"EDIT 0 0 0 " + name, b"", "OK")]
+
+    for header, body, expected in requests:
+        status, _, _ = request(server, header, body)
+
+        if status != expected:
+            mismatches.append("%s: %s" % (header.decode("utf-8", "replace"), status))
+
+    return mismatches
+
+
+def main():
+
+    here = os.path.dirname(os.path.abspath(__file__))
+
+    arguments = argparse.ArgumentParser(description="Checks that the compile server makes the same code as compiling directly")
+    arguments.add_argument("--compiler", default=os.path.join(here, "LunaCompiler"))
+    arguments.add_argument("--backends", nargs="*", default=["", "-x64"], help="backend flags to check, an empty one is MASM")
+    options = arguments.parse_args()
+
+    directory = tempfile.mkdtemp(prefix="lunaServer")
+    path = os.path.join(directory, "luna.sock")
+    mismatches = []
+
+    os.makedirs(os.path.join(directory, "server"))
+    os.makedirs(os.path.join(directory, "direct"))
+
+    # A server compiles for one backend, so every backend gets it's own server
+    for backend in options.backends:
+
+        process = subprocess.Popen([options.compiler, "-server", path] + ([backend] if backend else []), stdout=subprocess.DEVNULL)
+
+        while not os.path.exists(path):
+            if process.poll() is not None:
+                raise SystemExit("The server didn't start")
+            time.sleep(0.01)
+
+        for language in ("english", "hebrew"):
+            mismatches += check(options.compiler, path, directory, language, backend)
+
+        mismatches += check_requests(path, directory)
+
+        # The server doesn't answer QUIT, it removes it's socket and exits
+        client = socket.socket(socket.AF_UNIX)
+        client.connect(path)
+        client.sendall(b"QUIT\n")
+        client.close()
+        process.wait()
+
+    shutil.rmtree(directory, ignore_errors=True)
+
+    for mismatch in mismatches:
+        print("Mismatch: " + mismatch)
+
+    print("%d backends checked, %d mismatches" % (len(options.backends), len(mismatches)))
+
+    sys.exit(1 if mismatches else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+#include "stats.h"
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+stats_T stats = { 0 };
+
+static const char* const phaseNames[STATS_PHASES] = { "None", "Read", "Lex and parse", "IR", "Cache", "Code generation", "Assemble and run", "Free" };
+static const char* const phaseKeys[STATS_PHASES] = { "none", "read", "parse", "ir", "cache", "backend", "run", "free" };
+
+static const char* const counterNames[STATS_COUNTERS] = { "Tokens", "AST nodes", "TAC instructions", "Symbol lookups", "Spills",
+  "Descriptor resets", "Labels", "VM instructions", "VM loads", "VM stores", "VM moves", "VM branches", "VM calls", "Allocations", "Allocated bytes" };
+static const char* const counterKeys[STATS_COUNTERS] = { "tokens", "ast_nodes", "tac", "symbol_lookups", "spills",
+  "descriptor_resets", "labels", "vm_instructions", "vm_loads", "vm_stores", "vm_moves", "vm_branches", "vm_calls", "allocations", "allocated_bytes" };
+
+/*
+stats_enable turns on the counters and the timing of the phases
+Input: Whether the report should be JSON instead of a table
+Output: None
+*/
+void stats_enable(bool json) {
+
+  stats.enabled = true;
+  stats.json = json;
+}
+
+/*
+stats_now reads the clocks and the allocation counters
+Input: Time to store them in
+Output: None
+*/
+void stats_now(stats_time* time) {
+
+#ifdef _WIN32
+
+  LARGE_INTEGER counter = { 0 };
+  LARGE_INTEGER frequency = { 0 };
+  FILETIME creation, exit, kernel, user;
+
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&frequency);
+  GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+
+  time->wall = (double)counter.QuadPart / (double)frequency.QuadPart;
+  time->cpu = ((double)(((uint64_t)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime)
+    + (double)(((uint64_t)user.dwHighDateTime << 32) | user.dwLowDateTime)) / 1e7;
+
+#else
+
+  struct timespec now = { 0 };
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  time->wall = (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+  time->cpu = (double)clock() / CLOCKS_PER_SEC;
+
+#endif
+
+  time->allocations = stats.counters[STATS_ALLOCATIONS];
+  time->bytes = stats.counters[STATS_BYTES];
+}
+
+/*
+stats_switch ends the phase that runs and starts another one, phases are only switched by the thread that compiles
+Input: The next phase, STATS_NONE to stop measuring
+Output: None
+*/
+void stats_switch(stats_phase phase) {
+
+  stats_time now = { 0 };
+  stats_time* time = &stats.phases[stats.phase];
+
+  if (!stats.enabled) { return; }
+
+  stats_now(&now);
+
+  time->wall += now.wall - stats.start.wall;
+  time->cpu += now.cpu - stats.start.cpu;
+  time->allocations += now.allocations - stats.start.allocations;
+  time->bytes += now.bytes - stats.start.bytes;
+
+  stats.phase = phase;
+  stats.start = now;
+}
+
+/*
+stats_report prints the times of the phases and the counters
+Input: File to print to
+Output: None
+*/
+void stats_report(FILE* file) {
+
+  stats_time total = { 0 };
+
+  for (unsigned int i = STATS_NONE + 1; i < STATS_PHASES; i++) {
+    total.wall += stats.phases[i].wall;
+    total.cpu += stats.phases[i].cpu;
+    total.allocations += stats.phases[i].allocations;
+    total.bytes += stats.phases[i].bytes;
+  }
+
+  if (stats.json) {
+
+    fprintf(file, "{\"phases\": {");
+
+    for (unsigned int i = STATS_NONE + 1; i < STATS_PHASES; i++) {
+      fprintf(file, "%s\"%s\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"allocations\": %llu, \"bytes\": %llu}", i > STATS_NONE + 1 ? ", " : "",
+        phaseKeys[i], stats.phases[i].wall * 1000, stats.phases[i].cpu * 1000, (unsigned long long)stats.phases[i].allocations, (unsigned long long)stats.phases[i].bytes);
+    }
+
+    fprintf(file, "}, \"total\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f}, \"counters\": {", total.wall * 1000, total.cpu * 1000);
+
+    for (unsigned int i = 0; i < STATS_COUNTERS; i++) {
+      fprintf(file, "%s\"%s\": %llu", i ? ", " : "", counterKeys[i], (unsigned long long)stats.counters[i]);
+    }
+
+    fprintf(file, "}}\n");
+    return;
+  }
+
+  fprintf(file, "%-20s %12s %12s %12s %14s\n", "Phase", "Wall (ms)", "CPU (ms)", "Allocations", "Bytes");
+
+  for (unsigned int i = STATS_NONE + 1; i < STATS_PHASES; i++) {
+    fprintf(file, "%-20s %12.3f %12.3f %12llu %14llu\n", phaseNames[i], stats.phases[i].wall * 1000, stats.phases[i].cpu * 1000,
+      (unsigned long long)stats.phases[i].allocations, (unsigned long long)stats.phases[i].bytes);
+  }
+
+  fprintf(file, "%-20s %12.3f %12.3f %12llu %14llu\n\n", "Total", total.wall * 1000, total.cpu * 1000, (unsigned long long)total.allocations, (unsigned long long)total.bytes);
+
+  for (unsigned int i = 0; i < STATS_COUNTERS; i++) {
+    fprintf(file, "%-20s %12llu\n", counterNames[i], (unsigned long long)stats.counters[i]);
+  }
+}
@@ -0,0 +1,93 @@
+#ifndef STATS_H
+#define STATS_H
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/* Phases of a compilation, -stats reports the time and the allocations of every phase */
+typedef enum STATS_PHASE_ENUM {
+
+  STATS_NONE,       // Nothing is measured, between compilations
+  STATS_READ,
+  STATS_PARSE,      // Lexing and parsing, the parser lexes the tokens when it needs them
+  STATS_IR,
+  STATS_CACHE,
+  STATS_BACKEND,
+  STATS_RUN,        // Assembling, linking and running the output
+  STATS_FREE,
+
+  STATS_PHASES,
+
+} stats_phase;
+
+/* Things that are counted while -stats is on */
+typedef enum STATS_COUNTER_ENUM {
+
+  STATS_TOKENS,
+  STATS_AST_NODES,
+  STATS_TAC,
+  STATS_LOOKUPS,        // Symbol table searches
+  STATS_SPILLS,
+  STATS_RESETS,         // Register descriptor resets
+  STATS_LABELS,
+
+  STATS_VM_INSTRUCTIONS,    // Instructions the bytecode VM ran
+  STATS_VM_LOADS,           // Loads of globals
+  STATS_VM_STORES,          // Stores to globals
+  STATS_VM_MOVES,           // Copies between registers
+  STATS_VM_BRANCHES,        // Jumps, taken or not
+  STATS_VM_CALLS,
+
+  STATS_ALLOCATIONS,    // Calls to mcalloc and mrealloc
+  STATS_BYTES,          // Bytes they were asked for
+
+  STATS_COUNTERS,
+
+} stats_counter;
+
+typedef struct STATS_PHASE_TIME_STRUCT {
+
+  double wall;      // Seconds
+  double cpu;       // Seconds of all the threads of the process
+  uint64_t allocations;
+  uint64_t bytes;
+
+} stats_time;
+
+typedef struct STATS_STRUCT {
+
+  bool enabled;
+  bool json;
+
+  stats_phase phase;    // The phase that runs now and when it started
+  stats_time start;
+
+  stats_time phases[STATS_PHASES];
+  uint64_t counters[STATS_COUNTERS];
+
+} stats_T;
+
+extern stats_T stats;
+
+/* Adds to a counter, the threads of the pool count too so it's atomic */
+static inline void stats_add(stats_counter counter, uint64_t amount) {
+
+  if (!stats.enabled) { return; }
+
+#if defined(__GNUC__) || defined(__clang__)
+  __atomic_fetch_add(&stats.counters[counter], amount, __ATOMIC_RELAXED);
+#else
+  _InterlockedExchangeAdd64((volatile long long*)&stats.counters[counter], (long long)amount);
+#endif
+}
+
+void stats_enable(bool json);
+void stats_switch(stats_phase phase);
+void stats_now(stats_time* time);
+void stats_report(FILE* file);
+
+#endif
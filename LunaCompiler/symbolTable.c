@@ -12,6 +12,7 @@ entry_T* init_entry(char* name, int type) {
   entry->dtype = type;
 
   entry->addressDesc = mcalloc(1, sizeof(address_T*));
+  entry->capacity = 1;
   //address_push(entry, entry->name, ADDRESS_VAR);
 
   return entry;
@@ -24,10 +25,12 @@ Output: None
 */
 void address_push(entry_T* entry, void* location, int type) {
 
-  entry->addressDesc = mrealloc(entry->addressDesc, sizeof(address_T*) * ++entry->size);
-  entry->addressDesc[entry->size - 1] = mcalloc(1, sizeof(address_T)); 
-  entry->addressDesc[entry->size - 1]->address = location;
-  entry->addressDesc[entry->size - 1]->type = type;
+  address_T* address = mcalloc(1, sizeof(address_T));
+
+  address->address = location;
+  address->type = type;
+
+  vector_push(entry->addressDesc, entry->size, entry->capacity, address);
 }
 
 /*
@@ -41,14 +44,15 @@ void address_reset(entry_T* entry) {
     
   // Go through and free all addresses stored in the descriptor
   for (unsigned int i = 0; i < entry->size; i++) {
-    free(entry->addressDesc[i]);
+    mfree(entry->addressDesc[i]);
     entry->addressDesc[i] = NULL;
   }
       
   // Free descriptor
-  free(entry->addressDesc);
+  mfree(entry->addressDesc);
   entry->addressDesc = NULL;
   entry->size = 0;
+  entry->capacity = 0;
   
 }
 
@@ -70,7 +74,7 @@ void address_remove_registers(entry_T* entry) {
     }
       
     entry->size--;
-    free(entry->addressDesc[i]);
+    mfree(entry->addressDesc[i]);
     entry->addressDesc[i] = NULL;
   }
 }
@@ -93,7 +97,7 @@ void address_remove_register(entry_T* entry, void* reg) {
     }
       
     entry->size--;
-    free(entry->addressDesc[i]);
+    mfree(entry->addressDesc[i]);
     entry->addressDesc[i] = NULL;
     break;
   }
@@ -111,18 +115,41 @@ table_T* init_table(table_T* prev) {
 
   table->entries = mcalloc(1, sizeof(entry_T*));
   table->nestedScopes = mcalloc(1, sizeof(table_T*));
+  table->entriesCapacity = 1;
+  table->nestedCapacity = 1;
 
   return table;
 }
 
+/*
+table_copy_scope copies the entries of a table without it's nested scopes, the copies start with empty address descriptors
+Input: Table to copy
+Output: The copy, it has no parent and no nested scopes
+*/
+table_T* table_copy_scope(table_T* table) {
+
+  table_T* copy = init_table(NULL);
+
+  vector_reserve(copy->entries, copy->entriesCapacity, table->entrySize + 1);
+  copy->entrySize = table->entrySize;
+
+  for (size_t i = 0; i < table->entrySize; i++) {
+
+    copy->entries[i] = init_entry(table->entries[i]->name, table->entries[i]->dtype);
+    copy->entries[i]->value = table->entries[i]->value;
+    copy->entries[i]->offset = table->entries[i]->offset;
+  }
+
+  return copy;
+}
+
 /*
 table_add_entry adds an entry to a table
 Input: Table to add entry to, entry name and type
 */
 void table_add_entry(table_T* table, char* name, int type) {
 
-  table->entries = mrealloc(table->entries, sizeof(entry_T*) * ++table->entrySize);
-  table->entries[table->entrySize - 1] = init_entry(name, type);
+  vector_push(table->entries, table->entrySize, table->entriesCapacity, init_entry(name, type));
 }
 
 /*
@@ -132,8 +159,7 @@ Input: New table
 */
 table_T* table_add_table(table_T* table) {  
 
-  table->nestedScopes = mrealloc(table->nestedScopes, sizeof(table_T*) * ++table->nestedSize);
-  table->nestedScopes[table->nestedSize - 1] = init_table(table);
+  vector_push(table->nestedScopes, table->nestedSize, table->nestedCapacity, init_table(table));
 
   return table->nestedScopes[table->nestedSize - 1];
 }
@@ -145,21 +171,20 @@ Output: Entry that contains the variable, 0 if none of them do
 */
 entry_T* table_search_entry(table_T* table, char* name) {
 
-  entry_T* entry = NULL;
+  stats_add(STATS_LOOKUPS, 1);
 
-  for (unsigned int i = 0; i < table->entrySize && !entry; i++) {
+  // Search the current scope first, then it's parents up to the global scope
+  for (; table; table = table->prev) {
 
-    if (!strcmp(table->entries[i]->name, name)) {
-      entry = table->entries[i];
+    for (unsigned int i = 0; i < table->entrySize; i++) {
+
+      if (!strcmp(table->entries[i]->name, name)) {
+        return table->entries[i];
+      }
     }
   }
-    
-  // If entry was not found, go to the parent table
-  if (!entry && table->prev) {
-    entry = table_search_entry(table->prev, name);
-  }
-  
-  return entry;
+
+  return NULL;
 }
 
 /*
@@ -240,34 +265,76 @@ void table_print_table(table_T* table, int level) {
 }
 
 /*
-table_free_table is a postorder tree traversal that frees all nodes of the symbol table
+table_free_table frees all the scopes of a symbol table tree, scopes that weren't freed yet wait on a stack instead of recursing
 Input: Root of table tree
 Output: None
 */
 void table_free_table(table_T* table) {
 
+  table_T** stack = NULL;
+  size_t size = 0;
+  size_t capacity = 0;
+
   if (!table) { return; }
-    
-  for (unsigned int i = 0; i < table->nestedSize; i++) {
-    table_free_table(table->nestedScopes[i]);
+
+  vector_push(stack, size, capacity, table);
+
+  while (size) {
+
+    table = stack[--size];
+
+    for (size_t i = 0; i < table->nestedSize; i++) {
+      vector_push(stack, size, capacity, table->nestedScopes[i]);
+    }
+
+    for (size_t i = 0; i < table->entrySize; i++) {
+      table_free_entry(table->entries[i]);
+    }
+
+    mfree(table->entries);
+    mfree(table->nestedScopes);
+    mfree(table);
   }
 
-  for (unsigned int i = 0; i < table->entrySize; i++) {
+  mfree(stack);
+}
 
-    for (unsigned int i2 = 0; i2 < table->entries[i]->size; i2++) {
+/*
+table_free_entry frees an entry and it's address descriptor, the name belongs to a token
+Input: Entry
+Output: None
+*/
+void table_free_entry(entry_T* entry) {
 
-      if (table->entries[i]->addressDesc[i2]) {
-        free(table->entries[i]->addressDesc[i2]);
-      }
+  for (unsigned int i = 0; i < entry->size; i++) {
+
+    if (entry->addressDesc[i]) {
+      mfree(entry->addressDesc[i]);
     }
-       
-    free(table->entries[i]->addressDesc);
-    free(table->entries[i]);
   }
 
-  free(table->entries);
-  free(table->nestedScopes);
-  free(table);
+  mfree(entry->addressDesc);
+  mfree(entry);
+}
+
+/*
+table_truncate removes all the nested scopes of a table and all of it's entries but the first ones
+Input: Table, amount of entries to keep
+Output: None
+*/
+void table_truncate(table_T* table, size_t size) {
+
+  for (size_t i = 0; i < table->nestedSize; i++) {
+    table_free_table(table->nestedScopes[i]);
+  }
+
+  for (size_t i = size; i < table->entrySize; i++) {
+    table_free_entry(table->entries[i]);
+  }
+
+  table->nestedSize = 0;
+  table->entrySize = size;
+  table->tableIndex = 0;
 }
 
 /*
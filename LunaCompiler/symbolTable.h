@@ -30,6 +30,9 @@ typedef struct STRUCT_SYMBOL_ENTRY {
 
   address_T** addressDesc;  // Address descriptor: Keeping track of which addresses keep the current value of entry
   size_t size;              // Size of addresses in array
+  size_t capacity;
+
+  long offset;              // Stack frame offset of a local variable for backends that keep locals on the stack, 0 for globals
 
 } entry_T;
 
@@ -41,7 +44,9 @@ typedef struct STRUCT_SYMBOL_TABLE {
   struct STRUCT_SYMBOL_TABLE* prev;
   
   size_t entrySize;
+  size_t entriesCapacity;
   size_t nestedSize;
+  size_t nestedCapacity;
   size_t tableIndex;
 
 } table_T;
@@ -53,6 +58,7 @@ entry_T* table_search_entry(table_T* table, char* name);
 
 table_T* init_table(table_T* prev);
 table_T* table_add_table(table_T* table);
+table_T* table_copy_scope(table_T* table);
 table_T* table_search_table(table_T* table, char* name);
 
 bool table_search_in_specific_table(table_T* table, char* entry);
@@ -65,6 +71,8 @@ void address_remove_register(entry_T* entry, void* reg);
 void table_add_entry(table_T* table, char* name, int type);
 void table_print_table(table_T* table, int level);
 void table_free_table(table_T* table);
+void table_free_entry(entry_T* entry);
+void table_truncate(table_T* table, size_t size);
 void table_add_builtin_functions(table_T* table);
 
 #endif
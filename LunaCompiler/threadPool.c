@@ -0,0 +1,128 @@
+#include "threadPool.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+static unsigned int defaultThreads = 0;    // Set when the user asks for a specific amount of threads, 0 to use every core
+
+#ifdef _WIN32
+static DWORD WINAPI pool_thread_start(LPVOID argument) {
+  pool_worker* worker = argument;
+  pool_work(worker->pool, worker->index);
+  return 0;
+}
+#else
+static void* pool_thread_start(void* argument) {
+  pool_worker* worker = argument;
+  pool_work(worker->pool, worker->index);
+  return NULL;
+}
+#endif
+
+/*
+pool_run runs a task for every item on a few threads and waits for all of them to finish
+The calling thread works too, as worker 0
+Input: Amount of threads, amount of items, task, context to pass to the task
+Output: None
+*/
+void pool_run(unsigned int threads, size_t size, pool_task task, void* context) {
+
+  pool_T pool = { 0 };
+  pool_thread handles[POOL_MAX_THREADS];
+  pool_worker workers[POOL_MAX_THREADS];
+  unsigned int started = 1;
+
+  pool.task = task;
+  pool.context = context;
+  pool.size = size;
+
+  if (threads > POOL_MAX_THREADS) { threads = POOL_MAX_THREADS; }
+  if (threads > size) { threads = (unsigned int)size; }
+
+  for (; started < threads; started++) {
+
+    workers[started].pool = &pool;
+    workers[started].index = started;
+
+#ifdef _WIN32
+    if (!(handles[started] = CreateThread(NULL, 0, pool_thread_start, &workers[started], 0, NULL))) { break; }
+#else
+    if (pthread_create(&handles[started], NULL, pool_thread_start, &workers[started])) { break; }
+#endif
+  }
+
+  pool_work(&pool, 0);
+
+  // If a thread couldn't be made, the threads that did start just take it's items
+  for (unsigned int i = 1; i < started; i++) {
+
+#ifdef _WIN32
+    WaitForSingleObject(handles[i], INFINITE);
+    CloseHandle(handles[i]);
+#else
+    pthread_join(handles[i], NULL);
+#endif
+  }
+}
+
+/*
+pool_work takes items from the pool and runs the task on them until there are none left
+Input: Pool, index of the thread
+Output: None
+*/
+void pool_work(pool_T* pool, unsigned int worker) {
+
+  size_t index = 0;
+
+  while ((index = pool_take(pool)) < pool->size) {
+    pool->task(pool->context, index, worker);
+  }
+}
+
+/*
+pool_take atomically takes the next item of the pool
+Input: Pool
+Output: Index of the item, the size of the pool when there are no items left
+*/
+size_t pool_take(pool_T* pool) {
+
+#ifdef _WIN32
+  return (size_t)InterlockedIncrement64((volatile LONG64*)&pool->next) - 1;
+#else
+  return (size_t)__atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+#endif
+}
+
+/*
+pool_default_threads gets the amount of threads the machine can run at once
+Input: None
+Output: Amount of threads
+*/
+unsigned int pool_default_threads() {
+
+  long threads = 1;
+
+  if (defaultThreads) { return defaultThreads; }
+
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  threads = (long)info.dwNumberOfProcessors;
+#else
+  threads = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+  if (threads < 1) { threads = 1; }
+
+  return threads > POOL_MAX_THREADS ? POOL_MAX_THREADS : (unsigned int)threads;
+}
+
+/*
+pool_set_default_threads sets the amount of threads pools use by default
+Input: Amount of threads, 0 to use every core of the machine
+Output: None
+*/
+void pool_set_default_threads(unsigned int threads) {
+  defaultThreads = threads > POOL_MAX_THREADS ? POOL_MAX_THREADS : threads;
+}
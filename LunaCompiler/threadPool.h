@@ -0,0 +1,45 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include "io.h"
+
+#ifdef _WIN32
+#include <windows.h>
+typedef HANDLE pool_thread;
+#else
+#include <pthread.h>
+typedef pthread_t pool_thread;
+#endif
+
+#define POOL_MAX_THREADS 64
+
+/* A task gets the index of the item it should work on, and the index of the thread that runs it (for per thread state) */
+typedef void (*pool_task)(void* context, size_t index, unsigned int worker);
+
+typedef struct POOL_STRUCT {
+
+  pool_task task;
+  void* context;
+
+  size_t size;          // Amount of items
+  volatile long long next;   // Next item a thread takes, threads that finish early just take more items
+
+} pool_T;
+
+/* What a thread of the pool gets when it starts */
+typedef struct POOL_WORKER_STRUCT {
+
+  pool_T* pool;
+  unsigned int index;
+
+} pool_worker;
+
+void pool_run(unsigned int threads, size_t size, pool_task task, void* context);
+void pool_work(pool_T* pool, unsigned int worker);
+
+void pool_set_default_threads(unsigned int threads);
+
+unsigned int pool_default_threads();
+
+size_t pool_take(pool_T* pool);
+
+#endif
@@ -10,7 +10,7 @@ token_T* init_token(int type, char* value) {
   token_T* token = mcalloc(1, sizeof(token_T));
   token->value = value;
   token->type = type;
+  token->keyword = -1;
 
   return token;
 }
- 
\ No newline at end of file
@@ -2,12 +2,26 @@
 #define TOKEN_H
 #include "io.h"
 
+/* Keywords of the language, both languages spell the same keywords */
+enum KEYWORD_ENUM {
+
+  OUT_T,
+  IF_T,
+  ELSE_T,
+  WHILE_T,
+  INT_T,
+  STRING_T,
+  RETURN_T,
+
+};
+
 typedef struct TOKEN_STRUCT {
 
   char* value;
   enum TOKEN_TYPE_ENUM {
 
     TOKEN_ID,
+    TOKEN_KEYWORD,
     TOKEN_NUMBER,
     TOKEN_EQUALS,
     TOKEN_DEQUAL,
@@ -28,6 +42,13 @@ typedef struct TOKEN_STRUCT {
     TOKEN_SUB,
     TOKEN_LBRACE,
     TOKEN_RBRACE, 
+    TOKEN_SHL,
+    TOKEN_SHR,
+    TOKEN_BAND,
+    TOKEN_BOR,
+    TOKEN_XOR,
+    TOKEN_LAND,
+    TOKEN_LOR,
     TOKEN_ASM,
     TOKEN_FUNC_END,
     TOKEN_NOOP,
@@ -36,6 +57,9 @@ typedef struct TOKEN_STRUCT {
     
   } type;
 
+  size_t offset;  // Offset of the token in the source code, see lexer_position
+  int keyword;    // For keywords, see KEYWORD_ENUM
+
 } token_T;
 
 token_T* init_token(int type, char* value);
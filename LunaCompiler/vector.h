@@ -0,0 +1,49 @@
+#ifndef VECTOR_H
+#define VECTOR_H
+#include "io.h"
+
+/*
+Growable arrays: the array, it's size and it's capacity are fields of whatever owns the array, these macros grow the capacity
+geometrically so adding n elements one at a time copies O(n) elements instead of O(n^2).
+They are macros so the element size comes from the type of the array, and -allocs counts the allocation where the macro is used.
+The arguments are evaluated more than once, so they can't have side effects, and the pushed value can't change the array.
+An array can start with a capacity of 0 even if it already has elements, reserving always reallocates it then
+*/
+#define VECTOR_INITIAL_CAPACITY 4
+
+// Makes room for at least needed elements
+#define vector_reserve(array, capacity, needed) \
+  ((array) = vector_reserve_at((array), &(capacity), (needed), sizeof(*(array)), __FILE__, __LINE__))
+
+// Adds an element at the end
+#define vector_push(array, size, capacity, value) \
+  (vector_reserve(array, capacity, (size) + 1), (array)[(size)++] = (value))
+
+// Gives the memory after the last element back, for arrays that don't grow anymore
+#define vector_shrink(array, size, capacity) \
+  ((array) = vector_shrink_at((array), &(capacity), (size), sizeof(*(array)), __FILE__, __LINE__))
+
+static inline void* vector_reserve_at(void* array, size_t* capacity, size_t needed, size_t element, const char* file, unsigned int line) {
+
+  size_t grown = *capacity ? *capacity * 2 : VECTOR_INITIAL_CAPACITY;
+
+  if (needed <= *capacity) { return array; }
+
+  while (grown < needed) { grown *= 2; }
+
+  *capacity = grown;
+
+  return mrealloc_at(array, grown * element, file, line);
+}
+
+static inline void* vector_shrink_at(void* array, size_t* capacity, size_t size, size_t element, const char* file, unsigned int line) {
+
+  // An empty array keeps it's memory, some lists are never NULL
+  if (!size || size >= *capacity) { return array; }
+
+  *capacity = size;
+
+  return mrealloc_at(array, size * element, file, line);
+}
+
+#endif
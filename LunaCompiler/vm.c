@@ -0,0 +1,202 @@
+#include "vm.h"
+
+#ifdef VM_THREADED
+#define VM_CASE(op) op
+#define VM_DISPATCH() goto *table[ip->op]
+#else
+#define VM_CASE(op) case op
+#define VM_DISPATCH() continue
+#endif
+
+#define VM_NEXT() ip++; VM_DISPATCH()
+#define VM_JUMP(condition) ip = (condition) ? code + ip->c : ip + 1; VM_DISPATCH()
+
+/*
+vm_run runs a bytecode program from it's main function
+Every instruction's code ends by dispatching the next instruction itself, which keeps the branch predictor
+informed about which instructions tend to follow each other.
+With -stats every instruction goes through a counter first, without it the counter costs nothing
+Input: Program
+Output: The value main returned
+*/
+bc_value vm_run(bc_program* program) {
+
+#ifdef VM_THREADED
+  static const void* const dispatch[BC_OP_AMOUNT] = {
+    &&BC_MOV, &&BC_LOADG, &&BC_STOREG, &&BC_ADD, &&BC_SUB, &&BC_MUL, &&BC_DIV, &&BC_SHL, &&BC_SHR, &&BC_AND, &&BC_OR,
+    &&BC_XOR, &&BC_SETE, &&BC_SETNE, &&BC_SETL, &&BC_SETLE, &&BC_SETG, &&BC_SETGE, &&BC_JMP, &&BC_JZ, &&BC_JE,
+    &&BC_JNE, &&BC_JL, &&BC_JLE, &&BC_JG, &&BC_JGE, &&BC_CALL, &&BC_RET, &&BC_PRINT_INT, &&BC_PRINT_STRING
+  };
+
+  // Counting sends every instruction to the counter, which then goes on to the instruction's code
+  const void* count[BC_OP_AMOUNT];
+  const void* const* table = dispatch;
+#endif
+
+  uint64_t* counts = NULL;
+
+  bc_value* stack = mcalloc(VM_STACK_SIZE, sizeof(bc_value));
+  vm_frame* frames = mcalloc(VM_MAX_DEPTH, sizeof(vm_frame));
+  vm_frame* frame = frames;
+
+  bc_instruction* code = program->code;
+  bc_value* globals = program->globals;
+  bc_value* pool = program->pool;
+  bc_function* function = &program->functions[program->main];
+
+  bc_instruction* ip = code + function->start;
+  bc_value* regs = stack;
+  bc_value result = 0;
+
+  memcpy(regs + function->constants, pool + function->pool, function->poolSize * sizeof(bc_value));
+
+  if (stats.enabled) {
+    counts = mcalloc(BC_OP_AMOUNT, sizeof(uint64_t));
+
+#ifdef VM_THREADED
+    for (unsigned int i = 0; i < BC_OP_AMOUNT; i++) {
+      count[i] = &&BC_COUNT;
+    }
+
+    table = count;
+#endif
+  }
+
+#ifdef VM_THREADED
+  VM_DISPATCH();
+
+BC_COUNT:
+  counts[ip->op]++;
+  goto *dispatch[ip->op];
+#else
+  for (;;) {
+
+  if (counts) {
+    counts[ip->op]++;
+  }
+
+  switch (ip->op) {
+#endif
+
+  VM_CASE(BC_MOV):    regs[ip->a] = regs[ip->b]; VM_NEXT();
+  VM_CASE(BC_LOADG):  regs[ip->a] = globals[ip->b]; VM_NEXT();
+  VM_CASE(BC_STOREG): globals[ip->a] = regs[ip->b]; VM_NEXT();
+  VM_CASE(BC_ADD):    regs[ip->a] = regs[ip->b] + regs[ip->c]; VM_NEXT();
+  VM_CASE(BC_SUB):    regs[ip->a] = regs[ip->b] - regs[ip->c]; VM_NEXT();
+  VM_CASE(BC_MUL):    regs[ip->a] = regs[ip->b] * regs[ip->c]; VM_NEXT();
+
+  VM_CASE(BC_DIV):
+
+    if (!regs[ip->c]) {
+      vm_error("Division by zero");
+    }
+
+    regs[ip->a] = regs[ip->b] / regs[ip->c];
+    VM_NEXT();
+
+  // Shifts only use the lowest 6 bits of the amount like the processor does, shifting left is done unsigned so it can't overflow
+  VM_CASE(BC_SHL):   regs[ip->a] = (bc_value)((uint64_t)regs[ip->b] << (regs[ip->c] & 63)); VM_NEXT();
+  VM_CASE(BC_SHR):   regs[ip->a] = regs[ip->b] >> (regs[ip->c] & 63); VM_NEXT();
+  VM_CASE(BC_AND):   regs[ip->a] = regs[ip->b] & regs[ip->c]; VM_NEXT();
+  VM_CASE(BC_OR):    regs[ip->a] = regs[ip->b] | regs[ip->c]; VM_NEXT();
+  VM_CASE(BC_XOR):   regs[ip->a] = regs[ip->b] ^ regs[ip->c]; VM_NEXT();
+  VM_CASE(BC_SETE):  regs[ip->a] = regs[ip->b] == regs[ip->c]; VM_NEXT();
+  VM_CASE(BC_SETNE): regs[ip->a] = regs[ip->b] != regs[ip->c]; VM_NEXT();
+  VM_CASE(BC_SETL):  regs[ip->a] = regs[ip->b] < regs[ip->c]; VM_NEXT();
+  VM_CASE(BC_SETLE): regs[ip->a] = regs[ip->b] <= regs[ip->c]; VM_NEXT();
+  VM_CASE(BC_SETG):  regs[ip->a] = regs[ip->b] > regs[ip->c]; VM_NEXT();
+  VM_CASE(BC_SETGE): regs[ip->a] = regs[ip->b] >= regs[ip->c]; VM_NEXT();
+
+  VM_CASE(BC_JMP): ip = code + ip->a; VM_DISPATCH();
+  VM_CASE(BC_JZ):  ip = regs[ip->a] ? ip + 1 : code + ip->b; VM_DISPATCH();
+  VM_CASE(BC_JE):  VM_JUMP(regs[ip->a] == regs[ip->b]);
+  VM_CASE(BC_JNE): VM_JUMP(regs[ip->a] != regs[ip->b]);
+  VM_CASE(BC_JL):  VM_JUMP(regs[ip->a] < regs[ip->b]);
+  VM_CASE(BC_JLE): VM_JUMP(regs[ip->a] <= regs[ip->b]);
+  VM_CASE(BC_JG):  VM_JUMP(regs[ip->a] > regs[ip->b]);
+  VM_CASE(BC_JGE): VM_JUMP(regs[ip->a] >= regs[ip->b]);
+
+  VM_CASE(BC_CALL):
+
+    // The arguments are already in the call area, which becomes the start of the new frame
+    function = &program->functions[ip->b];
+
+    if (frame == frames + VM_MAX_DEPTH - 1 || regs + ip->c + function->size > stack + VM_STACK_SIZE) {
+      vm_error("Stack overflow");
+    }
+
+    frame->call = ip;
+    frame->regs = regs;
+    frame++;
+
+    regs += ip->c;
+    memcpy(regs + function->constants, pool + function->pool, function->poolSize * sizeof(bc_value));
+
+    ip = code + function->start;
+    VM_DISPATCH();
+
+  VM_CASE(BC_RET):
+
+    result = regs[ip->a];
+
+    if (frame == frames) {
+      goto done;
+    }
+
+    frame--;
+    regs = frame->regs;
+    ip = frame->call;
+
+    regs[ip->a] = result;
+    VM_NEXT();
+
+  VM_CASE(BC_PRINT_INT):    printf("%lld", (long long)regs[ip->a]); VM_NEXT();
+  VM_CASE(BC_PRINT_STRING): fputs(program->strings[regs[ip->a]], stdout); VM_NEXT();
+
+#ifndef VM_THREADED
+  }
+  }
+#endif
+
+done:
+
+  if (counts) {
+    vm_add_counts(counts);
+  }
+
+  mfree(counts);
+  mfree(stack);
+  mfree(frames);
+
+  return result;
+}
+
+/*
+vm_add_counts adds how many times every instruction ran to the counters of -stats
+Input: Amount of runs of every instruction
+Output: None
+*/
+void vm_add_counts(uint64_t* counts) {
+
+  for (unsigned int i = 0; i < BC_OP_AMOUNT; i++) {
+    stats_add(STATS_VM_INSTRUCTIONS, counts[i]);
+  }
+
+  for (unsigned int i = BC_JMP; i <= BC_JGE; i++) {
+    stats_add(STATS_VM_BRANCHES, counts[i]);
+  }
+
+  stats_add(STATS_VM_LOADS, counts[BC_LOADG]);
+  stats_add(STATS_VM_STORES, counts[BC_STOREG]);
+  stats_add(STATS_VM_MOVES, counts[BC_MOV]);
+  stats_add(STATS_VM_CALLS, counts[BC_CALL]);
+}
+
+/*
+vm_error stops a program that can't continue running
+Input: Error message
+Output: None
+*/
+void vm_error(const char* message) {
+  printf("[Error]: %s", message); error_exit();
+}
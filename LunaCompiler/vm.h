@@ -0,0 +1,26 @@
+#ifndef VM_H
+#define VM_H
+#include "bytecode.h"
+
+#define VM_STACK_SIZE (1 << 20)     // Registers of all the frames together
+#define VM_MAX_DEPTH (1 << 16)      // Calls that can be nested
+
+// GCC and Clang can jump straight from one instruction's code to the next one's, other compilers go through a switch
+#if defined(__GNUC__)
+#define VM_THREADED
+#endif
+
+/* A function that is waiting for a call it made to return */
+typedef struct VM_FRAME_STRUCT {
+
+  bc_instruction* call;    // The call instruction, it's destination register gets the result
+  bc_value* regs;
+
+} vm_frame;
+
+bc_value vm_run(bc_program* program);
+
+void vm_error(const char* message);
+void vm_add_counts(uint64_t* counts);
+
+#endif
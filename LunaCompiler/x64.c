@@ -0,0 +1,564 @@
+#include "x64.h"
+
+#define X64_INITIAL_SIZE 64
+
+/*
+init_x64_program initializes an empty x86-64 program
+Input: None
+Output: Program
+*/
+x64_program* init_x64_program() {
+
+  x64_program* program = mcalloc(1, sizeof(x64_program));
+
+  program->capacity = X64_INITIAL_SIZE;
+  program->instructions = mcalloc(program->capacity, sizeof(x64_instruction));
+
+  program->labelsCapacity = X64_INITIAL_SIZE;
+  program->labels = mcalloc(program->labelsCapacity, sizeof(x64_label));
+
+  // The symbol table is kept at most half full so probing stays short
+  program->symbolsCapacity = X64_INITIAL_SIZE;
+  program->symbols = mcalloc(program->symbolsCapacity, sizeof(int));
+  memset(program->symbols, 0xFF, program->symbolsCapacity * sizeof(int));    // Fill with X64_NO_LABEL
+
+  return program;
+}
+
+/*
+Operand constructors
+Input: Register, value, displacement or label depending on the operand
+Output: Operand
+*/
+x64_operand x64_reg_operand(int reg) {
+  x64_operand operand = { OPERAND_REG, reg, 0 };
+  return operand;
+}
+
+x64_operand x64_imm(long long value) {
+  x64_operand operand = { OPERAND_IMM, 0, value };
+  return operand;
+}
+
+x64_operand x64_mem(int reg, long long disp) {
+  x64_operand operand = { OPERAND_MEM, reg, disp };
+  return operand;
+}
+
+x64_operand x64_rip(int label) {
+  x64_operand operand = { OPERAND_RIP, 0, label };
+  return operand;
+}
+
+x64_operand x64_label_operand(int label) {
+  x64_operand operand = { OPERAND_LABEL, 0, label };
+  return operand;
+}
+
+x64_operand x64_none() {
+  x64_operand operand = { OPERAND_NONE, 0, 0 };
+  return operand;
+}
+
+/*
+x64_push appends an instruction to the program
+Input: Program, operation, destination operand, source operand
+Output: Index of the new instruction, so it can be patched later
+*/
+size_t x64_push(x64_program* program, int op, x64_operand dst, x64_operand src) {
+
+  x64_instruction* instruction = NULL;
+
+  vector_reserve(program->instructions, program->capacity, program->size + 1);
+
+  instruction = &program->instructions[program->size];
+  memset(instruction, 0, sizeof(x64_instruction));
+
+  instruction->op = op;
+  instruction->dst = dst;
+  instruction->src = src;
+
+  return program->size++;
+}
+
+/*
+x64_push_jcc appends a conditional jump
+Input: Program, condition, label to jump to
+Output: Index of the new instruction
+*/
+size_t x64_push_jcc(x64_program* program, int cond, int label) {
+
+  size_t index = x64_push(program, X64_JCC, x64_label_operand(label), x64_none());
+  program->instructions[index].cond = cond;
+
+  return index;
+}
+
+/*
+x64_push_setcc appends a SETcc that sets the low byte of a register
+Input: Program, condition, register
+Output: Index of the new instruction
+*/
+size_t x64_push_setcc(x64_program* program, int cond, int reg) {
+
+  size_t index = x64_push(program, X64_SETCC, x64_reg_operand(reg), x64_none());
+  program->instructions[index].cond = cond;
+
+  return index;
+}
+
+/*
+x64_push_raw appends raw Assembly text that was written in the source code
+Input: Program, text
+Output: Index of the new instruction
+*/
+size_t x64_push_raw(x64_program* program, char* text) {
+
+  size_t index = x64_push(program, X64_RAW, x64_none(), x64_none());
+  program->instructions[index].text = text;
+
+  return index;
+}
+
+/*
+x64_new_label creates a new unnamed label
+Input: Program, section the label will be defined in
+Output: Label number
+*/
+int x64_new_label(x64_program* program, int section) {
+
+  vector_reserve(program->labels, program->labelsCapacity, program->labelsSize + 1);
+
+  memset(&program->labels[program->labelsSize], 0, sizeof(x64_label));
+  program->labels[program->labelsSize].section = section;
+
+  return (int)program->labelsSize++;
+}
+
+/*
+x64_hash_name hashes a symbol name for the symbol table
+Input: Name
+Output: Hash
+*/
+static size_t x64_hash_name(char* name) {
+  return (size_t)hash_bytes(name, strlen(name));
+}
+
+/*
+x64_find_symbol searches the label of a named symbol
+Input: Program, symbol name
+Output: Label number, X64_NO_LABEL if the symbol doesn't exist
+*/
+int x64_find_symbol(x64_program* program, char* name) {
+
+  size_t mask = program->symbolsCapacity - 1;
+  size_t i = x64_hash_name(name) & mask;
+
+  // Linear probing until we either find the symbol or an empty slot
+  while (program->symbols[i] != X64_NO_LABEL) {
+
+    if (!strcmp(program->labels[program->symbols[i]].name, name)) {
+      return program->symbols[i];
+    }
+
+    i = (i + 1) & mask;
+  }
+
+  return X64_NO_LABEL;
+}
+
+/*
+x64_symbol returns the label of a named symbol, creating it if it doesn't exist yet
+Input: Program, symbol name, section of the symbol
+Output: Label number
+*/
+int x64_symbol(x64_program* program, char* name, int section) {
+
+  int label = x64_find_symbol(program, name);
+  int* symbols = NULL;
+  size_t capacity = 0;
+  size_t i = 0;
+
+  if (label != X64_NO_LABEL) { return label; }
+
+  label = x64_new_label(program, section);
+  program->labels[label].name = name;
+
+  // Grow and rehash the symbol table when it gets half full
+  if ((program->labelsSize * 2) > program->symbolsCapacity) {
+
+    symbols = program->symbols;
+    capacity = program->symbolsCapacity;
+
+    program->symbolsCapacity *= 2;
+    program->symbols = mcalloc(program->symbolsCapacity, sizeof(int));
+    memset(program->symbols, 0xFF, program->symbolsCapacity * sizeof(int));
+
+    for (size_t i2 = 0; i2 < capacity; i2++) {
+
+      if (symbols[i2] == X64_NO_LABEL) { continue; }
+
+      i = x64_hash_name(program->labels[symbols[i2]].name) & (program->symbolsCapacity - 1);
+
+      while (program->symbols[i] != X64_NO_LABEL) { i = (i + 1) & (program->symbolsCapacity - 1); }
+
+      program->symbols[i] = symbols[i2];
+    }
+
+    mfree(symbols);
+  }
+
+  i = x64_hash_name(name) & (program->symbolsCapacity - 1);
+
+  while (program->symbols[i] != X64_NO_LABEL) { i = (i + 1) & (program->symbolsCapacity - 1); }
+
+  program->symbols[i] = label;
+
+  return label;
+}
+
+/*
+x64_define_label places a label at the current position of the text section
+Input: Program, label
+Output: None
+*/
+void x64_define_label(x64_program* program, int label) {
+
+  program->labels[label].defined = true;
+  x64_push(program, X64_LABEL, x64_label_operand(label), x64_none());
+}
+
+/*
+x64_decode_string turns a string literal from the source code into the bytes it represents (handling \n, \t and \\)
+Input: Literal, pointer to store the size of the decoded string in (including the terminating 0)
+Output: Decoded string
+*/
+char* x64_decode_string(char* literal, size_t* size) {
+
+  size_t length = strlen(literal);
+  char* bytes = mcalloc(1, length + 1);
+  size_t index = 0;
+
+  for (size_t i = 0; i < length; i++) {
+
+    if (literal[i] == '\\' && i + 1 < length) {
+
+      switch (literal[i + 1]) {
+
+        case 'n': bytes[index++] = '\n'; i++; continue;
+        case 't': bytes[index++] = '\t'; i++; continue;
+        case '\\': bytes[index++] = '\\'; i++; continue;
+      }
+    }
+
+    bytes[index++] = literal[i];
+  }
+
+  *size = index + 1;
+
+  return bytes;
+}
+
+/*
+x64_add_string adds a string literal to the read only data section
+Input: Program, literal as written in the source code
+Output: Label of the string
+*/
+int x64_add_string(x64_program* program, char* literal) {
+
+  x64_string* string = NULL;
+
+  vector_reserve(program->strings, program->stringsCapacity, program->stringsSize + 1);
+
+  string = &program->strings[program->stringsSize++];
+  string->label = x64_new_label(program, X64_RODATA);
+  string->bytes = x64_decode_string(literal, &string->size);
+
+  program->labels[string->label].defined = true;
+
+  return string->label;
+}
+
+/*
+x64_add_global adds a global variable to the data section
+Input: Program, variable name, initial value, label whose address is the initial value (X64_NO_LABEL for a number)
+Output: Label of the variable
+*/
+int x64_add_global(x64_program* program, char* name, long long value, int valueLabel) {
+
+  x64_global* global = NULL;
+
+  vector_reserve(program->globals, program->globalsCapacity, program->globalsSize + 1);
+
+  global = &program->globals[program->globalsSize++];
+  global->label = x64_symbol(program, name, X64_DATA);
+  global->value = value;
+  global->valueLabel = valueLabel;
+
+  program->labels[global->label].section = X64_DATA;
+  program->labels[global->label].defined = true;
+
+  return global->label;
+}
+
+/*
+x64_fits_imm32 checks if a value can be encoded as a sign extended 32 bit immediate
+Input: Value
+Output: True if it fits
+*/
+bool x64_fits_imm32(long long value) {
+  return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+/*
+x64_invert_cond returns the opposite of a condition
+Input: Condition
+Output: Inverted condition
+*/
+int x64_invert_cond(int cond) {
+  return cond ^ 1;    // Condition codes come in pairs that differ only by the lowest bit
+}
+
+/*
+x64_gas_register returns the AT&T name of a register
+Input: Register, size of the register in bytes (1 or 8)
+Output: Name
+*/
+static const char* x64_gas_register(int reg, int size) {
+
+  static const char* const names[X64_REG_AMOUNT] = { "%rax", "%rcx", "%rdx", "%rbx", "%rsp", "%rbp", "%rsi", "%rdi",
+    "%r8", "%r9", "%r10", "%r11", "%r12", "%r13", "%r14", "%r15" };
+
+  static const char* const byteNames[X64_REG_AMOUNT] = { "%al", "%cl", "%dl", "%bl", "%spl", "%bpl", "%sil", "%dil",
+    "%r8b", "%r9b", "%r10b", "%r11b", "%r12b", "%r13b", "%r14b", "%r15b" };
+
+  return size == 1 ? byteNames[reg] : names[reg];
+}
+
+/*
+x64_gas_label emits the name of a label
+Input: Program, emitter, label
+Output: None
+*/
+static void x64_gas_label(x64_program* program, emitter_T* emitter, int label) {
+
+  if (program->labels[label].name) {
+    emit_string(emitter, program->labels[label].name);
+  }
+  else {
+    emit_string(emitter, ".L");
+    emit_number(emitter, label);
+  }
+}
+
+/*
+x64_gas_operand emits an operand in AT&T syntax
+Input: Program, emitter, operand, size of the operand in bytes
+Output: None
+*/
+static void x64_gas_operand(x64_program* program, emitter_T* emitter, x64_operand operand, int size) {
+
+  switch (operand.type) {
+
+    case OPERAND_REG: emit_string(emitter, x64_gas_register(operand.reg, size)); break;
+    case OPERAND_IMM: emit_char(emitter, '$'); emit_number(emitter, operand.value); break;
+    case OPERAND_LABEL: x64_gas_label(program, emitter, (int)operand.value); break;
+
+    case OPERAND_MEM:
+
+      if (operand.value) {
+        emit_number(emitter, operand.value);
+      }
+
+      emit_char(emitter, '(');
+      emit_string(emitter, x64_gas_register(operand.reg, 8));
+      emit_char(emitter, ')');
+      break;
+
+    case OPERAND_RIP:
+      x64_gas_label(program, emitter, (int)operand.value);
+      emit_string(emitter, "(%rip)");
+      break;
+
+    case OPERAND_NONE: break;
+  }
+}
+
+/*
+x64_gas_instruction emits a single instruction in AT&T syntax
+Input: Program, emitter, instruction
+Output: None
+*/
+static void x64_gas_instruction(x64_program* program, emitter_T* emitter, x64_instruction* instruction) {
+
+  static const char* const conditions[16] = { NULL, NULL, NULL, NULL, "e", "ne", NULL, NULL, NULL, NULL, NULL, NULL, "l", "ge", "le", "g" };
+
+  const char* mnemonic = NULL;
+  int srcSize = 8;
+  int dstSize = 8;
+
+  switch (instruction->op) {
+
+    case X64_NOP: return;
+
+    case X64_LABEL:
+      x64_gas_label(program, emitter, (int)instruction->dst.value);
+      emit_line(emitter, ":");
+      return;
+
+    case X64_RAW:
+      emit_line(emitter, instruction->text);
+      return;
+
+    case X64_JCC:
+      emit_string(emitter, "  j");
+      emit_string(emitter, conditions[instruction->cond]);
+      emit_char(emitter, ' ');
+      x64_gas_label(program, emitter, (int)instruction->dst.value);
+      emit_char(emitter, '\n');
+      return;
+
+    case X64_SETCC:
+      emit_string(emitter, "  set");
+      emit_string(emitter, conditions[instruction->cond]);
+      emit_char(emitter, ' ');
+      x64_gas_operand(program, emitter, instruction->dst, 1);
+      emit_char(emitter, '\n');
+      return;
+
+    case X64_IMUL3:
+      emit_string(emitter, "  imulq $");
+      emit_number(emitter, instruction->imm);
+      emit_string(emitter, ", ");
+      x64_gas_operand(program, emitter, instruction->src, 8);
+      emit_string(emitter, ", ");
+      x64_gas_operand(program, emitter, instruction->dst, 8);
+      emit_char(emitter, '\n');
+      return;
+
+    case X64_JMP:
+    case X64_CALL:
+      emit_string(emitter, instruction->op == X64_JMP ? "  jmp " : "  call ");
+
+      if (instruction->dst.type == OPERAND_REG) {
+        emit_char(emitter, '*');
+      }
+
+      x64_gas_operand(program, emitter, instruction->dst, 8);
+      emit_char(emitter, '\n');
+      return;
+
+    case X64_MOV: mnemonic = instruction->src.type == OPERAND_IMM && !x64_fits_imm32(instruction->src.value) ? "movabsq" : "movq"; break;
+    case X64_MOVB: mnemonic = "movb"; srcSize = 1; dstSize = 1; break;
+    case X64_MOVZXB: mnemonic = "movzbq"; srcSize = 1; break;
+    case X64_LEA: mnemonic = "leaq"; break;
+    case X64_ADD: mnemonic = "addq"; break;
+    case X64_SUB: mnemonic = "subq"; break;
+    case X64_IMUL: mnemonic = "imulq"; break;
+    case X64_CQO: mnemonic = "cqto"; break;
+    case X64_IDIV: mnemonic = "idivq"; break;
+    case X64_NEG: mnemonic = "negq"; break;
+    case X64_AND: mnemonic = "andq"; break;
+    case X64_OR: mnemonic = "orq"; break;
+    case X64_XOR: mnemonic = "xorq"; break;
+    case X64_SHL: mnemonic = "shlq"; srcSize = 1; break;    // The amount is in CL
+    case X64_SAR: mnemonic = "sarq"; srcSize = 1; break;
+    case X64_CMP: mnemonic = "cmpq"; break;
+    case X64_TEST: mnemonic = "testq"; break;
+    case X64_RET: mnemonic = "ret"; break;
+    case X64_PUSH: mnemonic = "pushq"; break;
+    case X64_POP: mnemonic = "popq"; break;
+    case X64_LEAVE: mnemonic = "leave"; break;
+    case X64_SYSCALL: mnemonic = "syscall"; break;
+  }
+
+  emit_string(emitter, "  ");
+  emit_string(emitter, mnemonic);
+
+  // AT&T syntax puts the source operand before the destination
+  if (instruction->src.type != OPERAND_NONE) {
+    emit_char(emitter, ' ');
+    x64_gas_operand(program, emitter, instruction->src, srcSize);
+    emit_char(emitter, ',');
+  }
+
+  if (instruction->dst.type != OPERAND_NONE) {
+    emit_char(emitter, ' ');
+    x64_gas_operand(program, emitter, instruction->dst, dstSize);
+  }
+
+  emit_char(emitter, '\n');
+}
+
+/*
+x64_write_gas writes the program as GNU assembler source code
+Input: Program, emitter to write to
+Output: None
+*/
+void x64_write_gas(x64_program* program, emitter_T* emitter) {
+
+  x64_global* global = NULL;
+  x64_string* string = NULL;
+
+  emit_line(emitter, "  .text");
+  emit_line(emitter, "  .globl _start");
+
+  for (size_t i = 0; i < program->size; i++) {
+    x64_gas_instruction(program, emitter, &program->instructions[i]);
+  }
+
+  emit_line(emitter, "  .data");
+  emit_line(emitter, "  .balign 8");
+
+  for (size_t i = 0; i < program->globalsSize; i++) {
+
+    global = &program->globals[i];
+
+    x64_gas_label(program, emitter, global->label);
+    emit_string(emitter, ":\n  .quad ");
+
+    global->valueLabel != X64_NO_LABEL ? x64_gas_label(program, emitter, global->valueLabel) : emit_number(emitter, global->value);
+    emit_char(emitter, '\n');
+  }
+
+  emit_line(emitter, "  .section .rodata");
+
+  // Strings are written as plain bytes so we never have to escape anything
+  for (size_t i = 0; i < program->stringsSize; i++) {
+
+    string = &program->strings[i];
+
+    x64_gas_label(program, emitter, string->label);
+    emit_string(emitter, ":\n  .byte ");
+
+    for (size_t i2 = 0; i2 < string->size; i2++) {
+
+      if (i2) {
+        emit_char(emitter, ',');
+      }
+
+      emit_number(emitter, (unsigned char)string->bytes[i2]);
+    }
+
+    emit_char(emitter, '\n');
+  }
+}
+
+/*
+x64_free_program frees a program and everything it owns
+Input: Program
+Output: None
+*/
+void x64_free_program(x64_program* program) {
+
+  for (size_t i = 0; i < program->stringsSize; i++) {
+    mfree(program->strings[i].bytes);
+  }
+
+  mfree(program->instructions);
+  mfree(program->labels);
+  mfree(program->symbols);
+  mfree(program->strings);
+  mfree(program->globals);
+  mfree(program);
+}
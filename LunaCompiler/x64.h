@@ -0,0 +1,199 @@
+#ifndef X64_H
+#define X64_H
+#include "emitter.h"
+#include <stdint.h>
+
+#define X64_NO_LABEL -1
+
+/* Registers are numbered by their hardware encoding so the encoder can use them as is */
+typedef enum X64_REG_ENUM {
+
+  X64_RAX,
+  X64_RCX,
+  X64_RDX,
+  X64_RBX,
+  X64_RSP,
+  X64_RBP,
+  X64_RSI,
+  X64_RDI,
+  X64_R8,
+  X64_R9,
+  X64_R10,
+  X64_R11,
+  X64_R12,
+  X64_R13,
+  X64_R14,
+  X64_R15,
+  X64_REG_AMOUNT
+
+} x64_reg;
+
+/* Conditions are numbered by their condition code so Jcc and SETcc can be encoded directly */
+typedef enum X64_COND_ENUM {
+
+  X64_COND_E = 0x4,
+  X64_COND_NE = 0x5,
+  X64_COND_L = 0xC,
+  X64_COND_GE = 0xD,
+  X64_COND_LE = 0xE,
+  X64_COND_G = 0xF,
+
+} x64_cond;
+
+typedef enum X64_OP_ENUM {
+
+  X64_NOP,        // Placeholder, produces no code (used for prologue slots that are filled in later)
+  X64_LABEL,      // Defines the label in dst
+  X64_RAW,        // Raw Assembly text from the source code, only valid for textual output
+  X64_MOV,
+  X64_MOVB,       // Store the low byte of a register in memory
+  X64_MOVZXB,     // Load a byte from memory and zero extend it
+  X64_LEA,
+  X64_ADD,
+  X64_SUB,
+  X64_IMUL,
+  X64_IMUL3,      // dst = src * imm
+  X64_CQO,
+  X64_IDIV,
+  X64_NEG,
+  X64_AND,
+  X64_OR,
+  X64_XOR,
+  X64_SHL,        // Shift dst by an immediate or by CL
+  X64_SAR,
+  X64_CMP,
+  X64_TEST,
+  X64_JMP,
+  X64_JCC,
+  X64_SETCC,      // Set the low byte of dst to 1 if the condition is true, otherwise to 0
+  X64_CALL,
+  X64_RET,
+  X64_PUSH,
+  X64_POP,
+  X64_LEAVE,
+  X64_SYSCALL,
+
+} x64_op;
+
+typedef enum X64_SECTION_ENUM {
+
+  X64_TEXT,
+  X64_DATA,
+  X64_RODATA,
+  X64_SECTION_AMOUNT
+
+} x64_section;
+
+typedef struct X64_OPERAND_STRUCT {
+
+  enum X64_OPERAND_ENUM {
+
+    OPERAND_NONE,
+    OPERAND_REG,      // Register
+    OPERAND_IMM,      // Immediate value
+    OPERAND_MEM,      // Memory at [reg + value]
+    OPERAND_RIP,      // Memory at a label, addressed relative to the instruction pointer
+    OPERAND_LABEL,    // A label as a jump or call target
+
+  } type;
+
+  int reg;
+  long long value;    // Immediate, displacement or label number, depending on the type
+
+} x64_operand;
+
+typedef struct X64_INSTRUCTION_STRUCT {
+
+  int op;
+  int cond;          // Condition for Jcc and SETcc
+
+  x64_operand dst;
+  x64_operand src;
+  long long imm;     // Third operand of IMUL3
+
+  char* text;        // Raw Assembly text
+
+} x64_instruction;
+
+typedef struct X64_LABEL_STRUCT {
+
+  char* name;        // Symbol name, NULL for labels made by the compiler
+  int section;
+  size_t offset;     // Offset in it's section, filled in by the encoder
+  bool defined;
+
+} x64_label;
+
+/* A string literal stored in the read only data section */
+typedef struct X64_STRING_STRUCT {
+
+  int label;
+  char* bytes;
+  size_t size;      // Including the terminating 0
+
+} x64_string;
+
+/* A global variable stored in the data section, holding either a number or the address of a label */
+typedef struct X64_GLOBAL_STRUCT {
+
+  int label;
+  long long value;
+  int valueLabel;
+
+} x64_global;
+
+typedef struct X64_PROGRAM_STRUCT {
+
+  x64_instruction* instructions;
+  size_t size;
+  size_t capacity;
+
+  x64_label* labels;
+  size_t labelsSize;
+  size_t labelsCapacity;
+
+  // Open addressing hash table from symbol names to label numbers
+  int* symbols;
+  size_t symbolsCapacity;
+
+  x64_string* strings;
+  size_t stringsSize;
+  size_t stringsCapacity;
+
+  x64_global* globals;
+  size_t globalsSize;
+  size_t globalsCapacity;
+
+} x64_program;
+
+x64_program* init_x64_program();
+
+x64_operand x64_reg_operand(int reg);
+x64_operand x64_imm(long long value);
+x64_operand x64_mem(int reg, long long disp);
+x64_operand x64_rip(int label);
+x64_operand x64_label_operand(int label);
+x64_operand x64_none();
+
+size_t x64_push(x64_program* program, int op, x64_operand dst, x64_operand src);
+size_t x64_push_jcc(x64_program* program, int cond, int label);
+size_t x64_push_setcc(x64_program* program, int cond, int reg);
+size_t x64_push_raw(x64_program* program, char* text);
+
+int x64_new_label(x64_program* program, int section);
+int x64_symbol(x64_program* program, char* name, int section);
+int x64_find_symbol(x64_program* program, char* name);
+int x64_add_string(x64_program* program, char* literal);
+int x64_add_global(x64_program* program, char* name, long long value, int valueLabel);
+
+void x64_define_label(x64_program* program, int label);
+void x64_write_gas(x64_program* program, emitter_T* emitter);
+void x64_free_program(x64_program* program);
+
+bool x64_fits_imm32(long long value);
+
+int x64_invert_cond(int cond);
+
+char* x64_decode_string(char* literal, size_t* size);
+
+#endif
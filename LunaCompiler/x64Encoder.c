@@ -0,0 +1,432 @@
+#include "x64Encoder.h"
+
+/*
+x64_encode encodes a program into machine code and data, references between sections are left as relocations
+Input: Program
+Output: Object
+*/
+x64_object* x64_encode(x64_program* program) {
+
+  x64_object* object = mcalloc(1, sizeof(x64_object));
+
+  object->program = program;
+
+  for (unsigned int i = 0; i < X64_SECTION_AMOUNT; i++) {
+    object->sections[i] = init_emitter(NULL);
+  }
+
+  for (size_t i = 0; i < program->size; i++) {
+    x64_encode_instruction(object, &program->instructions[i]);
+  }
+
+  x64_encode_data(object);
+  x64_resolve_text(object);
+
+  return object;
+}
+
+/*
+x64_encode_instruction encodes a single instruction at the end of the text section
+Input: Object, instruction
+Output: None
+*/
+void x64_encode_instruction(x64_object* object, x64_instruction* instruction) {
+
+  emitter_T* text = object->sections[X64_TEXT];
+  x64_operand dst = instruction->dst;
+  x64_operand src = instruction->src;
+  char opcode[2] = { 0 };
+
+  switch (instruction->op) {
+
+    case X64_NOP: break;
+
+    case X64_LABEL:
+      object->program->labels[dst.value].offset = text->size;
+      break;
+
+    case X64_RAW:
+      printf("[Error]: Inline Assembly can only be used when generating Assembly code"); error_exit();
+
+    case X64_MOV:
+
+      // A constant that doesn't fit in 32 bits can only be moved to a register
+      if (src.type == OPERAND_IMM && !x64_fits_imm32(src.value)) {
+        emit_char(text, (char)(REX | REX_W | (dst.reg >= X64_R8 ? REX_B : 0)));
+        emit_char(text, (char)(0xB8 + (dst.reg & 7)));
+        x64_encode_imm(object, src.value, 8);
+      }
+      else if (src.type == OPERAND_IMM) {
+        x64_encode_rm(object, REX_W, "\xC7", 1, 0, dst, 4);
+        x64_encode_imm(object, src.value, 4);
+      }
+      else if (src.type == OPERAND_REG) {
+        x64_encode_rm(object, REX_W, "\x89", 1, src.reg, dst, 0);
+      }
+      else {
+        x64_encode_rm(object, REX_W, "\x8B", 1, dst.reg, src, 0);
+      }
+      break;
+
+    // The REX prefix makes the low byte of RSI and RDI accessible instead of DH and BH
+    case X64_MOVB:   x64_encode_rm(object, REX, "\x88", 1, src.reg, dst, 0); break;
+    case X64_MOVZXB: x64_encode_rm(object, REX_W, "\x0F\xB6", 2, dst.reg, src, 0); break;
+    case X64_LEA:    x64_encode_rm(object, REX_W, "\x8D", 1, dst.reg, src, 0); break;
+
+    case X64_ADD: x64_encode_arith(object, 0x01, 0, instruction); break;
+    case X64_SUB: x64_encode_arith(object, 0x29, 5, instruction); break;
+    case X64_AND: x64_encode_arith(object, 0x21, 4, instruction); break;
+    case X64_OR:  x64_encode_arith(object, 0x09, 1, instruction); break;
+    case X64_XOR: x64_encode_arith(object, 0x31, 6, instruction); break;
+    case X64_CMP: x64_encode_arith(object, 0x39, 7, instruction); break;
+
+    // Shifts by a constant have an immediate byte, the other form always shifts by CL
+    case X64_SHL:
+    case X64_SAR:
+
+      if (src.type == OPERAND_IMM) {
+        x64_encode_rm(object, REX_W, "\xC1", 1, instruction->op == X64_SHL ? 4 : 7, dst, 1);
+        x64_encode_imm(object, src.value, 1);
+      }
+      else {
+        x64_encode_rm(object, REX_W, "\xD3", 1, instruction->op == X64_SHL ? 4 : 7, dst, 0);
+      }
+      break;
+
+    case X64_IMUL: x64_encode_rm(object, REX_W, "\x0F\xAF", 2, dst.reg, src, 0); break;
+
+    case X64_IMUL3:
+
+      if (instruction->imm >= INT8_MIN && instruction->imm <= INT8_MAX) {
+        x64_encode_rm(object, REX_W, "\x6B", 1, dst.reg, src, 1);
+        x64_encode_imm(object, instruction->imm, 1);
+      }
+      else {
+        x64_encode_rm(object, REX_W, "\x69", 1, dst.reg, src, 4);
+        x64_encode_imm(object, instruction->imm, 4);
+      }
+      break;
+
+    case X64_CQO:  emit_bytes(text, "\x48\x99", 2); break;
+    case X64_IDIV: x64_encode_rm(object, REX_W, "\xF7", 1, 7, dst, 0); break;
+    case X64_NEG:  x64_encode_rm(object, REX_W, "\xF7", 1, 3, dst, 0); break;
+    case X64_TEST: x64_encode_rm(object, REX_W, "\x85", 1, src.reg, dst, 0); break;
+
+    case X64_JMP:
+    case X64_CALL:
+
+      if (dst.type == OPERAND_LABEL) {
+        emit_char(text, instruction->op == X64_JMP ? (char)0xE9 : (char)0xE8);
+        x64_encode_rel32(object, (int)dst.value);
+      }
+      else {
+        x64_encode_rm(object, 0, "\xFF", 1, instruction->op == X64_JMP ? 4 : 2, dst, 0);
+      }
+      break;
+
+    case X64_JCC:
+      opcode[0] = 0x0F;
+      opcode[1] = (char)(0x80 + instruction->cond);
+      emit_bytes(text, opcode, 2);
+      x64_encode_rel32(object, (int)dst.value);
+      break;
+
+    case X64_SETCC:
+      opcode[0] = 0x0F;
+      opcode[1] = (char)(0x90 + instruction->cond);
+      x64_encode_rm(object, REX, opcode, 2, 0, dst, 0);
+      break;
+
+    case X64_PUSH:
+
+      if (dst.type == OPERAND_REG) {
+
+        if (dst.reg >= X64_R8) {
+          emit_char(text, (char)(REX | REX_B));
+        }
+
+        emit_char(text, (char)(0x50 + (dst.reg & 7)));
+      }
+      else if (dst.type == OPERAND_IMM) {
+        emit_char(text, 0x68);
+        x64_encode_imm(object, dst.value, 4);
+      }
+      else {
+        x64_encode_rm(object, 0, "\xFF", 1, 6, dst, 0);
+      }
+      break;
+
+    case X64_POP:
+
+      if (dst.reg >= X64_R8) {
+        emit_char(text, (char)(REX | REX_B));
+      }
+
+      emit_char(text, (char)(0x58 + (dst.reg & 7)));
+      break;
+
+    case X64_RET:     emit_char(text, (char)0xC3); break;
+    case X64_LEAVE:   emit_char(text, (char)0xC9); break;
+    case X64_SYSCALL: emit_bytes(text, "\x0F\x05", 2); break;
+  }
+}
+
+/*
+x64_encode_rm encodes an instruction with a ModRM byte: the prefix, the opcode, the ModRM byte and the displacement
+Input: Object, REX bits the instruction needs (REX alone forces an empty prefix), opcode bytes, amount of opcode bytes,
+register or opcode extension for the reg field, register or memory operand for the rm field, size of the immediate that follows
+Output: None
+*/
+void x64_encode_rm(x64_object* object, int rex, const char* opcode, size_t opcodeSize, int reg, x64_operand rm, int immSize) {
+
+  emitter_T* text = object->sections[X64_TEXT];
+  int mod = MODRM_REG;
+  int base = rm.reg;
+
+  if (reg >= X64_R8) { rex |= REX_R; }
+
+  if (rm.type != OPERAND_RIP && base >= X64_R8) { rex |= REX_B; }
+
+  if (rex) {
+    emit_char(text, (char)(rex | REX));
+  }
+
+  emit_bytes(text, opcode, opcodeSize);
+
+  if (rm.type == OPERAND_REG) {
+    emit_char(text, (char)((MODRM_REG << 6) | ((reg & 7) << 3) | (base & 7)));
+    return;
+  }
+
+  // RIP relative addressing, the displacement is counted from the end of the instruction
+  if (rm.type == OPERAND_RIP) {
+    emit_char(text, (char)((MODRM_DISP0 << 6) | ((reg & 7) << 3) | 5));
+    x64_add_reloc(object, X64_RELOC_PC32, X64_TEXT, text->size, (int)rm.value, -4 - immSize);
+    x64_encode_imm(object, 0, 4);
+    return;
+  }
+
+  // RBP and R13 can't be used without a displacement, it's encoding means RIP relative instead
+  if (!rm.value && (base & 7) != X64_RBP) {
+    mod = MODRM_DISP0;
+  }
+  else {
+    mod = rm.value >= INT8_MIN && rm.value <= INT8_MAX ? MODRM_DISP8 : MODRM_DISP32;
+  }
+
+  emit_char(text, (char)((mod << 6) | ((reg & 7) << 3) | (base & 7)));
+
+  // RSP and R12 as a base always need a SIB byte
+  if ((base & 7) == X64_RSP) {
+    emit_char(text, 0x24);
+  }
+
+  if (mod != MODRM_DISP0) {
+    x64_encode_imm(object, rm.value, mod == MODRM_DISP8 ? 1 : 4);
+  }
+}
+
+/*
+x64_encode_arith encodes the arithmetic instructions that share the same encoding forms (ADD, SUB, AND, OR, XOR, CMP)
+Input: Object, opcode of the "r/m, reg" form, opcode extension of the immediate form, instruction
+Output: None
+*/
+void x64_encode_arith(x64_object* object, char opcode, int ext, x64_instruction* instruction) {
+
+  char load = (char)(opcode + 2);    // The "reg, r/m" form always comes two opcodes later
+
+  if (instruction->src.type == OPERAND_IMM) {
+
+    // Small constants have a shorter sign extended form
+    if (instruction->src.value >= INT8_MIN && instruction->src.value <= INT8_MAX) {
+      x64_encode_rm(object, REX_W, "\x83", 1, ext, instruction->dst, 1);
+      x64_encode_imm(object, instruction->src.value, 1);
+    }
+    else {
+      x64_encode_rm(object, REX_W, "\x81", 1, ext, instruction->dst, 4);
+      x64_encode_imm(object, instruction->src.value, 4);
+    }
+  }
+  else if (instruction->src.type == OPERAND_REG) {
+    x64_encode_rm(object, REX_W, &opcode, 1, instruction->src.reg, instruction->dst, 0);
+  }
+  else {
+    x64_encode_rm(object, REX_W, &load, 1, instruction->dst.reg, instruction->src, 0);
+  }
+}
+
+/*
+x64_encode_imm appends a little endian immediate value to the text section
+Input: Object, value, size of the immediate in bytes
+Output: None
+*/
+void x64_encode_imm(x64_object* object, long long value, int size) {
+
+  char bytes[8] = { 0 };
+
+  for (int i = 0; i < size; i++) {
+    bytes[i] = (char)((unsigned long long)value >> (i * 8));
+  }
+
+  emit_bytes(object->sections[X64_TEXT], bytes, size);
+}
+
+/*
+x64_encode_rel32 appends the 32 bit displacement of a jump or a call to a label
+Input: Object, label
+Output: None
+*/
+void x64_encode_rel32(x64_object* object, int label) {
+
+  x64_add_reloc(object, X64_RELOC_PC32, X64_TEXT, object->sections[X64_TEXT]->size, label, -4);
+  x64_encode_imm(object, 0, 4);
+}
+
+/*
+x64_encode_data lays out the global variables and the string literals
+Input: Object
+Output: None
+*/
+void x64_encode_data(x64_object* object) {
+
+  x64_program* program = object->program;
+  emitter_T* data = object->sections[X64_DATA];
+  emitter_T* rodata = object->sections[X64_RODATA];
+  char value[8] = { 0 };
+
+  for (size_t i = 0; i < program->globalsSize; i++) {
+
+    program->labels[program->globals[i].label].offset = data->size;
+
+    // Variables that hold the address of a string get it once the string's address is known
+    if (program->globals[i].valueLabel != X64_NO_LABEL) {
+      x64_add_reloc(object, X64_RELOC_ABS64, X64_DATA, data->size, program->globals[i].valueLabel, 0);
+      x64_write64(value, 0);
+    }
+    else {
+      x64_write64(value, program->globals[i].value);
+    }
+
+    emit_bytes(data, value, sizeof(value));
+  }
+
+  for (size_t i = 0; i < program->stringsSize; i++) {
+
+    program->labels[program->strings[i].label].offset = rodata->size;
+    emit_bytes(rodata, program->strings[i].bytes, program->strings[i].size);
+  }
+}
+
+/*
+x64_add_reloc records a reference to a label that has to be filled in later
+Input: Object, relocation type, section and offset of the field, label, addend
+Output: None
+*/
+void x64_add_reloc(x64_object* object, int type, int section, size_t offset, int label, long long addend) {
+
+  x64_reloc* reloc = NULL;
+
+  vector_reserve(object->relocs, object->relocsCapacity, object->relocsSize + 1);
+
+  reloc = &object->relocs[object->relocsSize++];
+  reloc->type = type;
+  reloc->section = section;
+  reloc->offset = offset;
+  reloc->label = label;
+  reloc->addend = addend;
+}
+
+/*
+x64_resolve_text fills in the jumps and calls inside the text section, which don't depend on where the code is loaded
+Only the references to other sections are left as relocations
+Input: Object
+Output: None
+*/
+void x64_resolve_text(x64_object* object) {
+
+  x64_label* label = NULL;
+  x64_reloc* reloc = NULL;
+  size_t size = 0;
+
+  for (size_t i = 0; i < object->relocsSize; i++) {
+
+    reloc = &object->relocs[i];
+    label = &object->program->labels[reloc->label];
+
+    if (!label->defined) {
+      printf("[Error]: '%s' is used but never defined", label->name ? label->name : "label"); error_exit();
+    }
+
+    if (reloc->section == X64_TEXT && label->section == X64_TEXT) {
+      x64_write32(object->sections[X64_TEXT]->buffer + reloc->offset, (uint32_t)(label->offset + reloc->addend - reloc->offset));
+    }
+    else {
+      object->relocs[size++] = *reloc;
+    }
+  }
+
+  object->relocsSize = size;
+}
+
+/*
+x64_link fills in the references between sections once the address of every section is known
+Input: Object, address of every section
+Output: None
+*/
+void x64_link(x64_object* object, uint64_t addresses[X64_SECTION_AMOUNT]) {
+
+  x64_reloc* reloc = NULL;
+  x64_label* label = NULL;
+  char* field = NULL;
+  uint64_t target = 0;
+
+  for (size_t i = 0; i < object->relocsSize; i++) {
+
+    reloc = &object->relocs[i];
+    label = &object->program->labels[reloc->label];
+    field = object->sections[reloc->section]->buffer + reloc->offset;
+    target = addresses[label->section] + label->offset + reloc->addend;
+
+    if (reloc->type == X64_RELOC_PC32) {
+      x64_write32(field, (uint32_t)(target - (addresses[reloc->section] + reloc->offset)));
+    }
+    else {
+      x64_write64(field, target);
+    }
+  }
+}
+
+/*
+x64_write32 and x64_write64 store a little endian value in a field
+Input: Pointer to the field, value
+Output: None
+*/
+void x64_write32(char* field, uint32_t value) {
+
+  for (int i = 0; i < 4; i++) {
+    field[i] = (char)(value >> (i * 8));
+  }
+}
+
+void x64_write64(char* field, uint64_t value) {
+
+  for (int i = 0; i < 8; i++) {
+    field[i] = (char)(value >> (i * 8));
+  }
+}
+
+/*
+x64_free_object frees an object, but not the program it was encoded from
+Input: Object
+Output: None
+*/
+void x64_free_object(x64_object* object) {
+
+  for (unsigned int i = 0; i < X64_SECTION_AMOUNT; i++) {
+    mfree(object->sections[i]->buffer);
+    mfree(object->sections[i]);
+  }
+
+  mfree(object->relocs);
+  mfree(object);
+}
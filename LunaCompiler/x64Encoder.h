@@ -0,0 +1,65 @@
+#ifndef X64ENCODER_H
+#define X64ENCODER_H
+#include "x64.h"
+
+#define REX_W 0x08
+#define REX_R 0x04
+#define REX_X 0x02
+#define REX_B 0x01
+#define REX 0x40
+
+#define MODRM_DISP0 0x0
+#define MODRM_DISP8 0x1
+#define MODRM_DISP32 0x2
+#define MODRM_REG 0x3
+
+#define X64_TEXT_ALIGNMENT 16
+
+typedef enum X64_RELOC_ENUM {
+
+  X64_RELOC_PC32,     // 32 bit displacement relative to the end of the field (plus the addend)
+  X64_RELOC_ABS64,    // 64 bit absolute address
+
+} x64_reloc_type;
+
+/* A reference from a section to a label that is only resolved once the final addresses are known */
+typedef struct X64_RELOC_STRUCT {
+
+  int type;
+  int section;        // Section the reference is in
+  size_t offset;      // Offset of the field in that section
+  int label;          // Label being referenced
+  long long addend;
+
+} x64_reloc;
+
+/* Machine code and data of a program, ready to be placed in memory or in a file */
+typedef struct X64_OBJECT_STRUCT {
+
+  x64_program* program;
+
+  emitter_T* sections[X64_SECTION_AMOUNT];
+
+  x64_reloc* relocs;
+  size_t relocsSize;
+  size_t relocsCapacity;
+
+} x64_object;
+
+x64_object* x64_encode(x64_program* program);
+
+void x64_encode_instruction(x64_object* object, x64_instruction* instruction);
+void x64_encode_rm(x64_object* object, int rex, const char* opcode, size_t opcodeSize, int reg, x64_operand rm, int immSize);
+void x64_encode_arith(x64_object* object, char opcode, int ext, x64_instruction* instruction);
+void x64_encode_imm(x64_object* object, long long value, int size);
+void x64_encode_rel32(x64_object* object, int label);
+void x64_encode_data(x64_object* object);
+void x64_add_reloc(x64_object* object, int type, int section, size_t offset, int label, long long addend);
+void x64_resolve_text(x64_object* object);
+void x64_link(x64_object* object, uint64_t addresses[X64_SECTION_AMOUNT]);
+void x64_free_object(x64_object* object);
+
+void x64_write32(char* field, uint32_t value);
+void x64_write64(char* field, uint64_t value);
+
+#endif